@@ -0,0 +1,167 @@
+from __future__ import annotations
+
+import asyncio
+import math
+from dataclasses import dataclass
+from typing import Sequence
+
+from .report import report
+
+# Data service of StreamDeco, must match lib/ESP32 BLE Keyboard/BleKeyboard.h
+#
+# Frames are written without response on the RX characteristic, the same
+# bytes written on serial. StreamDeco reassembles them with its frame parser,
+# so a write can carry several frames and a frame can be split across writes.
+
+DATA_SERVICE_UUID = "90bc52b6-eabf-4f2a-a557-bba3abf28c6b"
+DATA_RX_UUID = "90bc52b7-eabf-4f2a-a557-bba3abf28c6b"
+DEVICE_NAME = "StreamDeco"
+
+ATT_HEADER_SIZE = 3  # opcode and attribute handle of a write command
+DEFAULT_MTU = 23
+PREFERRED_MTU = 64   # CONFIG_BT_NIMBLE_ATT_PREFERRED_MTU of the HID profile
+SERIAL_BAUD = 115200
+
+
+def coalesce(frames: Sequence[bytes], mtu: int = PREFERRED_MTU) -> list[bytes]:
+    """
+    Packs frames into as few writes as possible.
+    Whole frames are kept in one write when they fit, a frame larger than a
+    write is split, the parser on StreamDeco joins the pieces.
+    Args:
+        frames (Sequence[bytes]): Encoded frames, in sending order.
+        mtu (int): ATT MTU negotiated with StreamDeco.
+    Returns:
+        list[bytes]: Payloads of the writes, at most mtu - 3 bytes each.
+    """
+    size = mtu - ATT_HEADER_SIZE
+    if size <= 0:
+        raise ValueError(f"Invalid MTU {mtu}")
+
+    writes: list[bytes] = []
+    pending = b""
+    for frame in frames:
+        if pending and len(pending) + len(frame) > size:
+            writes.append(pending)
+            pending = b""
+        pending += frame
+        while len(pending) > size:
+            writes.append(pending[:size])
+            pending = pending[size:]
+    if pending:
+        writes.append(pending)
+    return writes
+
+
+@dataclass
+class SerialLink:
+    """
+    USB serial model, 8N1 so each byte takes 10 bits.
+    """
+    baud: int = SERIAL_BAUD
+
+    def latency(self, frames: Sequence[bytes]) -> float:
+        """
+        Seconds from the first byte sent to the last byte received.
+        """
+        return sum(len(frame) for frame in frames) * 10 / self.baud
+
+
+@dataclass
+class BleLink:
+    """
+    BLE model, writes wait for the next connection event and each event
+    carries up to packets_per_event writes.
+    """
+    interval_ms: float = 15.0
+    mtu: int = PREFERRED_MTU
+    packets_per_event: int = 4
+
+    def writes(self, frames: Sequence[bytes]) -> list[bytes]:
+        return coalesce(frames, self.mtu)
+
+    def latency(self, frames: Sequence[bytes]) -> float:
+        """
+        Average seconds from the frames being ready to the last write received,
+        half an interval is waited on average before the first event.
+        """
+        events = math.ceil(len(self.writes(frames)) / self.packets_per_event)
+        if events == 0:
+            return 0.0
+        return (0.5 + events - 1) * self.interval_ms / 1000
+
+
+class BleSender:
+    """
+    Writes frames to the StreamDeco data service, the USB cable is not needed.
+    Requires the bleak package (pip install bleak) and StreamDeco paired as keyboard.
+    """
+
+    def __init__(self, device_name: str = DEVICE_NAME) -> None:
+        self._device_name = device_name
+        self._loop = asyncio.new_event_loop()
+        self._client = None
+
+    @property
+    def mtu(self) -> int:
+        return self._client.mtu_size if self._client is not None else DEFAULT_MTU
+
+    def open(self) -> bool:
+        """
+        Connects to StreamDeco.
+        Returns:
+            bool: True if the data service was found.
+        """
+        try:
+            from bleak import BleakClient, BleakScanner
+        except ImportError:
+            report("BleSender", "ERROR", "bleak package not installed")
+            return False
+
+        async def connect():
+            device = await BleakScanner.find_device_by_name(self._device_name)
+            if device is None:
+                return None
+            client = BleakClient(device)
+            await client.connect()
+            if client.services.get_characteristic(DATA_RX_UUID) is None:
+                await client.disconnect()
+                return None
+            return client
+
+        try:
+            self._client = self._loop.run_until_complete(connect())
+        except Exception as e:
+            report("BleSender", "ERROR", f"Failed to connect: {e}")
+            self._client = None
+        if self._client is None:
+            report("BleSender", "WARNING", f"{self._device_name} data service not found")
+            return False
+        report("BleSender", "INFO", f"Connected to {self._device_name}, MTU {self.mtu}")
+        return True
+
+    def close(self) -> None:
+        if self._client is not None:
+            self._loop.run_until_complete(self._client.disconnect())
+            self._client = None
+
+    def send(self, frames: Sequence[bytes]) -> bool:
+        """
+        Writes frames coalesced to the negotiated MTU.
+        Returns:
+            bool: False if StreamDeco is not connected or a write failed.
+        """
+        if self._client is None:
+            return False
+
+        async def write(payloads):
+            for payload in payloads:
+                await self._client.write_gatt_char(DATA_RX_UUID, payload, response=False)
+
+        try:
+            self._loop.run_until_complete(write(coalesce(frames, self.mtu)))
+            return True
+        except Exception as e:
+            report("BleSender", "ERROR", f"Failed to send data: {e}")
+            self.close()
+            return False
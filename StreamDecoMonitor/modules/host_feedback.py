@@ -0,0 +1,103 @@
+from __future__ import annotations
+
+from .report import report
+
+# Feedback output report written to StreamDeco over Bluetooth HID, must match
+# the report map of lib/ESP32 BLE Keyboard/BleKeyboard.cpp and feedback::state_e
+# on include/streamDeco_objects.hpp
+#
+# | report id | state | mask |
+# |   0x03    |   1   |  1   |
+#
+# Only the bits set on mask are applied, the others keep their state.
+
+FEEDBACK_ID = 0x03
+DEVICE_NAME = "StreamDeco"
+
+MIC_MUTED = 0x01
+MEDIA_PLAYING = 0x02
+WINDOW_PINNED = 0x04
+
+
+def encode_feedback(state: int, mask: int) -> bytes:
+    """
+    Encodes a feedback output report.
+    Args:
+        state (int): State bits, MIC_MUTED, MEDIA_PLAYING and WINDOW_PINNED.
+        mask (int): Bits of state known by the computer.
+    Returns:
+        bytes: The report, starting with the report id.
+    """
+    if not 0 <= state <= 0xFF or not 0 <= mask <= 0xFF:
+        raise ValueError("State and mask are one byte")
+    return bytes((FEEDBACK_ID, state & mask, mask))
+
+
+class HostFeedback:
+    """
+    Writes the computer state to the StreamDeco paired as a Bluetooth keyboard.
+    Requires the hidapi package (pip install hidapi), StreamDeco ignores the
+    report until it is the active host.
+    """
+
+    def __init__(self, device_name: str = DEVICE_NAME) -> None:
+        self._device_name = device_name
+        self._device = None
+        self._state = 0
+        self._mask = 0
+
+    def open(self) -> bool:
+        """
+        Opens the first HID interface of StreamDeco with the feedback report.
+        Returns:
+            bool: True if StreamDeco was found.
+        """
+        try:
+            import hid
+        except ImportError:
+            report("HostFeedback", "ERROR", "hidapi package not installed")
+            return False
+        for info in hid.enumerate():
+            if self._device_name not in (info.get("product_string") or ""):
+                continue
+            try:
+                device = hid.device()
+                device.open_path(info["path"])
+            except OSError:
+                continue
+            self._device = device
+            report("HostFeedback", "INFO", f"Feedback report on {info['path']!r}")
+            return True
+        report("HostFeedback", "WARNING", f"{self._device_name} HID device not found")
+        return False
+
+    def close(self) -> None:
+        if self._device is not None:
+            self._device.close()
+            self._device = None
+
+    def set(self, bit: int, on: bool) -> bool:
+        """
+        Sends one state bit if it changed, e.g. set(MIC_MUTED, True).
+        Returns:
+            bool: False if the report could not be written.
+        """
+        state = self._state | bit if on else self._state & ~bit
+        if self._mask & bit and state == self._state:
+            return True
+        self._state = state
+        self._mask |= bit
+        return self.write(self._state, bit)
+
+    def write(self, state: int, mask: int) -> bool:
+        """
+        Writes a feedback report.
+        """
+        if self._device is None:
+            return False
+        try:
+            return self._device.write(encode_feedback(state, mask)) > 0
+        except OSError as e:
+            report("HostFeedback", "ERROR", f"Feedback report not written: {e}")
+            self.close()
+            return False
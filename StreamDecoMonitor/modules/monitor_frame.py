@@ -0,0 +1,133 @@
+from __future__ import annotations
+
+import binascii
+import struct
+from typing import Sequence
+
+# Binary frame sent to StreamDeco, must match lib/streamDeco/include/streamDeco_frame.hpp
+#
+# | sync | version | type | length | payload ... | crc16 |
+# | 0xA5 |    1    |  1   |   1    |   length    |   2   |
+#
+# All fields are little-endian, crc16 (CCITT, poly 0x1021, init 0xFFFF)
+# covers version, type, length and payload.
+
+SYNC_BYTE = 0xA5
+PROTOCOL_VERSION = 1
+METRICS_TYPE = 0x01
+SHORTCUTS_TYPE = 0x02
+REQUEST_TYPE = 0x03
+TRACE_REQUEST = 0x01  # StreamDeco prints the tap to keystroke trace on serial log
+TOP_REQUEST = 0x02    # StreamDeco prints the task profiler table, argument is the interval in seconds
+MEMORY_REQUEST = 0x03 # StreamDeco prints the memory telemetry history on serial log
+EXECUTOR_REQUEST = 0x04  # StreamDeco prints the queue depth and execution time of each handler
+MAX_PAYLOAD_SIZE = 64
+TEXT_TERMINATOR = "/"
+
+# cpu load/temp/freq, gpu load/temp/freq, ram used/total, disk used/total,
+# sec, min, hour, weekday, day, month, year
+METRICS_PAYLOAD = struct.Struct("<6h4i6BH")
+METRICS_FIELDS = 17
+HEADER = struct.Struct("<4B")
+CRC = struct.Struct("<H")
+
+
+def crc16(data: bytes, crc: int = 0xFFFF) -> int:
+    """
+    Computes the CRC-16/CCITT-FALSE of data.
+    Args:
+        data (bytes): The bytes to check.
+        crc (int): Initial value, used to chain calls.
+    Returns:
+        int: The 16 bits CRC.
+    """
+    # binascii runs the same CCITT polynomial in C, a Python loop per byte
+    # made the binary frame slower to decode than the text one
+    return binascii.crc_hqx(data, crc)
+
+
+def encode_frame(frame_type: int, payload: bytes) -> bytes:
+    """
+    Encodes a payload into a binary frame.
+    Args:
+        frame_type (int): Frame type.
+        payload (bytes): Up to MAX_PAYLOAD_SIZE bytes.
+    Returns:
+        bytes: The binary frame ready to be written on serial.
+    """
+    if len(payload) > MAX_PAYLOAD_SIZE:
+        raise ValueError(f"Payload too long, {len(payload)} bytes")
+    header = HEADER.pack(SYNC_BYTE, PROTOCOL_VERSION, frame_type, len(payload))
+    return header + payload + CRC.pack(crc16(header[1:] + payload))
+
+
+def encode_request(request: int, *arguments: int) -> bytes:
+    """
+    Encodes a request frame, answered by StreamDeco on its serial log.
+    Args:
+        request (int): Request byte, e.g. TRACE_REQUEST.
+        arguments (int): Argument bytes of the request, e.g. the TOP_REQUEST interval.
+    Returns:
+        bytes: The binary frame ready to be written on serial.
+    """
+    return encode_frame(REQUEST_TYPE, bytes((request, *arguments)))
+
+
+def encode_binary(fields: Sequence[int]) -> bytes:
+    """
+    Encodes the 17 metrics fields into a binary frame.
+    Args:
+        fields (Sequence[int]): Metrics fields in the same order of the text frame.
+    Returns:
+        bytes: The binary frame ready to be written on serial.
+    """
+    if len(fields) != METRICS_FIELDS:
+        raise ValueError(f"Expected {METRICS_FIELDS} fields, got {len(fields)}")
+    return encode_frame(METRICS_TYPE, METRICS_PAYLOAD.pack(*(int(field) for field in fields)))
+
+
+def decode_binary(frame: bytes) -> tuple[int, ...]:
+    """
+    Decodes a binary frame back into the metrics fields.
+    Args:
+        frame (bytes): A complete binary frame.
+    Returns:
+        tuple[int, ...]: The 17 metrics fields.
+    Raises:
+        ValueError: If sync, version, type, length or CRC are invalid.
+    """
+    if len(frame) < HEADER.size + CRC.size:
+        raise ValueError("Frame too short")
+    sync, version, frame_type, length = HEADER.unpack_from(frame)
+    if sync != SYNC_BYTE or version != PROTOCOL_VERSION:
+        raise ValueError("Invalid sync byte or protocol version")
+    if len(frame) != HEADER.size + length + CRC.size:
+        raise ValueError("Invalid frame length")
+    (crc,) = CRC.unpack_from(frame, HEADER.size + length)
+    if crc != crc16(frame[1:HEADER.size + length]):
+        raise ValueError("Invalid CRC")
+    if frame_type != METRICS_TYPE or length < METRICS_PAYLOAD.size:
+        raise ValueError("Unsupported frame type")
+    return METRICS_PAYLOAD.unpack_from(frame, HEADER.size)
+
+
+def encode_text(fields: Sequence[int]) -> str:
+    """
+    Encodes the metrics fields into the legacy text frame.
+    Args:
+        fields (Sequence[int]): Metrics fields.
+    Returns:
+        str: Comma separated fields followed by the text terminator.
+    """
+    return ", ".join(str(int(field)) for field in fields) + TEXT_TERMINATOR
+
+
+def decode_text(frame: str) -> tuple[int, ...]:
+    """
+    Decodes a legacy text frame back into the metrics fields.
+    Args:
+        frame (str): Text frame, terminator optional.
+    Returns:
+        tuple[int, ...]: The metrics fields.
+    """
+    return tuple(int(field) for field in frame.rstrip(TEXT_TERMINATOR).split(","))
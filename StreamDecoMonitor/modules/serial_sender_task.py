@@ -12,13 +12,13 @@ class SerialSenderTask:
     Handles sending data to a serial device in a separate thread.
     """
 
-    def __init__(self, boardCOM: str, queue_serial_sender: Queue[str] | None = None, 
+    def __init__(self, boardCOM: str, queue_serial_sender: Queue[str | bytes] | None = None, 
                  run_task: bool = False, update_interval_seconds: float = 1.0) -> None:
         """
         Initializes the SerialSenderTask with the specified COM port and queue for sending data.
         Args:
             boardCOM (str): The COM port of the serial device.
-            queue_serial_sender (Queue[str]): The queue for sending data to the serial device.
+            queue_serial_sender (Queue[str | bytes]): The queue for sending data to the serial device.
             run_detach (bool): Whether to run the thread as a detached thread.
         This constructor sets up the StreamMonitor for the specified COM port and initializes
         the threading components for running the serial sending task in the background.
@@ -40,11 +40,11 @@ class SerialSenderTask:
         """
         self._port = port
     
-    def set_queue(self, queue_serial_sender: Queue[str]) -> None:
+    def set_queue(self, queue_serial_sender: Queue[str | bytes]) -> None:
         """
         Sets the queue for sending data to the serial device.
         Args:
-            queue_serial_sender (Queue[str]): The queue to set for sending data to the serial device.
+            queue_serial_sender (Queue[str | bytes]): The queue to set for sending data to the serial device.
         """
         self._queue_serial_sender = queue_serial_sender
     
@@ -97,11 +97,11 @@ class SerialSenderTask:
         if self._thread is not None and self._thread.is_alive():
             self._thread.join(timeout=1.5)
 
-    def _transmit(self, data: str) -> None:
+    def _transmit(self, data: str | bytes) -> None:
         """
-        Sends a string of data to the external device via the specified COM port.
+        Sends a string or a binary frame to the external device via the specified COM port.
         Args:
-            data (str): The string of data to send to the external device.
+            data (str | bytes): The data to send to the external device.
         Note:
             If the COM port is not found (i.e., self._port is an empty string), it logs an error message
             using the report function and does not attempt to send data.
@@ -113,19 +113,21 @@ class SerialSenderTask:
             return
         try:
             connection = Serial(self._port, 115200, timeout=1)
-            connection.write(data.encode())
+            payload = data if isinstance(data, bytes) else data.encode()
+            connection.write(payload)
             connection.close()
-            report("SerialSenderTask", "INFO", f"Successfully sent data to {self._port}: {data}")
+            printable = data.hex(" ") if isinstance(data, bytes) else data
+            report("SerialSenderTask", "INFO", f"Successfully sent data to {self._port}: {printable}")
         except Exception as e:
             report("SerialSenderTask", "ERROR", f"Failed to send data: {e}")
 
-    def send(self, data: str) -> None:
+    def send(self, data: str | bytes) -> None:
         """
         Public method to send data to the serial device.
         This method can be called from other parts of the application to send data without needing to
         directly interact with the threading or queue management.
         Args:
-            data (str): The string of data to send to the external device.
+            data (str | bytes): The data to send to the external device.
         """
         self._transmit(data)
 
@@ -0,0 +1,149 @@
+from __future__ import annotations
+
+import struct
+from typing import Iterable, Mapping, Sequence
+
+from modules.monitor_frame import MAX_PAYLOAD_SIZE, SHORTCUTS_TYPE, crc16, encode_frame
+
+# Shortcut table image sent to StreamDeco, must match lib/streamDeco/include/streamDeco_keymap.hpp
+#
+# | magic | version | events | generation | crc16 | size | offsets ... | steps ... |
+# |   2   |    1    |   1    |     4      |   2   |  2   | events + 1  |           |
+#
+# crc16 covers size, offsets and steps, generation is stamped by StreamDeco.
+# Steps: chord (0x01, 8 bytes HID keyboard report), media (0x02, 2 bytes),
+# delay (0x03, 2 bytes milliseconds) and text (0x04, 1 byte length, ASCII).
+
+MAGIC = 0x4B53
+TABLE_VERSION = 1
+MAX_IMAGE_SIZE = 1024
+MAX_SEQUENCE_SIZE = 256
+MAX_TEXT_SIZE = 255
+
+CHORD_STEP = 0x01
+MEDIA_STEP = 0x02
+DELAY_STEP = 0x03
+TEXT_STEP = 0x04
+
+BEGIN_COMMAND = 0x01
+DATA_COMMAND = 0x02
+COMMIT_COMMAND = 0x03
+
+HEADER = struct.Struct("<HBBIHH")
+CHUNK_SIZE = MAX_PAYLOAD_SIZE - 3
+
+
+def chord(modifiers: int, *keys: int) -> bytes:
+    """
+    Encodes a chord step, keys pressed together then released.
+    Args:
+        modifiers (int): HID modifiers bitmask, bit 0 left ctrl to bit 7 right gui.
+        keys (int): Up to 6 HID keyboard usages.
+    Returns:
+        bytes: The step.
+    """
+    if len(keys) > 6:
+        raise ValueError("A chord has up to 6 keys")
+    return bytes((CHORD_STEP, modifiers, 0, *keys, *(0,) * (6 - len(keys))))
+
+
+def media(low: int, high: int = 0) -> bytes:
+    """
+    Encodes a media keys step, same bits of BleKeyboard MediaKeyReport.
+    """
+    return bytes((MEDIA_STEP, low, high))
+
+
+def delay(ms: int) -> bytes:
+    """
+    Encodes a delay step in milliseconds.
+    """
+    return struct.pack("<BH", DELAY_STEP, ms)
+
+
+def text(string: str) -> bytes:
+    """
+    Encodes text typed by StreamDeco, long strings are split into several steps.
+    Args:
+        string (str): ASCII text.
+    Returns:
+        bytes: The steps.
+    """
+    data = string.encode("ascii")
+    steps = b""
+    for start in range(0, len(data), MAX_TEXT_SIZE):
+        chunk = data[start:start + MAX_TEXT_SIZE]
+        steps += bytes((TEXT_STEP, len(chunk))) + chunk
+    return steps
+
+
+def build(events: int, sequences: Mapping[int, Iterable[bytes]]) -> bytes:
+    """
+    Builds a shortcut table image.
+    Args:
+        events (int): Number of events of the firmware, event_count on streamDeco_objects.hpp.
+        sequences (Mapping[int, Iterable[bytes]]): Steps of each event, missing events have no shortcut.
+    Returns:
+        bytes: The image.
+    """
+    offsets = [0]
+    steps = b""
+    for event in range(events):
+        sequence = b"".join(sequences.get(event, ()))
+        if len(sequence) > MAX_SEQUENCE_SIZE:
+            raise ValueError(f"Sequence of event {event} too long, {len(sequence)} bytes")
+        steps += sequence
+        offsets.append(len(steps))
+    body = struct.pack(f"<{len(offsets)}H", *offsets) + steps
+    size = HEADER.size + len(body)
+    if size > MAX_IMAGE_SIZE:
+        raise ValueError(f"Image too long, {size} bytes")
+    crc = crc16(struct.pack("<H", size) + body)
+    return HEADER.pack(MAGIC, TABLE_VERSION, events, 0, crc, size) + body
+
+
+def encode_frames(image: bytes) -> list[bytes]:
+    """
+    Splits an image into the shortcuts frames that replace the table on StreamDeco.
+    Args:
+        image (bytes): Image built by build().
+    Returns:
+        list[bytes]: Begin, data and commit frames, to be sent in order.
+    """
+    frames = [encode_frame(SHORTCUTS_TYPE, struct.pack("<BH", BEGIN_COMMAND, len(image)))]
+    for offset in range(0, len(image), CHUNK_SIZE):
+        chunk = image[offset:offset + CHUNK_SIZE]
+        frames.append(encode_frame(SHORTCUTS_TYPE, struct.pack("<BH", DATA_COMMAND, offset) + chunk))
+    frames.append(encode_frame(SHORTCUTS_TYPE, bytes((COMMIT_COMMAND,))))
+    return frames
+
+
+def decode(image: bytes, events: int) -> list[Sequence[bytes]]:
+    """
+    Decodes an image back into the steps of each event.
+    Raises:
+        ValueError: If magic, version, events, size or CRC are invalid.
+    """
+    magic, version, image_events, _, crc, size = HEADER.unpack_from(image)
+    if magic != MAGIC or version != TABLE_VERSION or image_events != events:
+        raise ValueError("Invalid magic, version or events")
+    if size != len(image) or crc != crc16(image[HEADER.size - 2:size]):
+        raise ValueError("Invalid size or CRC")
+    offsets = struct.unpack_from(f"<{events + 1}H", image, HEADER.size)
+    first_step = HEADER.size + 2 * (events + 1)
+    sizes = {CHORD_STEP: 9, MEDIA_STEP: 3, DELAY_STEP: 3}
+    sequences = []
+    for event in range(events):
+        sequence = image[first_step + offsets[event]:first_step + offsets[event + 1]]
+        steps = []
+        while sequence:
+            if sequence[0] == TEXT_STEP and len(sequence) > 1:
+                step_size = 2 + sequence[1]
+            else:
+                step_size = sizes.get(sequence[0])
+            if step_size is None or step_size > len(sequence):
+                raise ValueError(f"Invalid step on event {event}")
+            steps.append(sequence[:step_size])
+            sequence = sequence[step_size:]
+        sequences.append(steps)
+    return sequences
@@ -7,6 +7,7 @@ from typing import Any
 import psutil
 
 from .libre_hardware_monitor import LibreHardwareMonitor
+from .monitor_frame import encode_binary, encode_text
 from .report import report, get_debug_level
 
 
@@ -18,7 +19,8 @@ class SystemMetricsProvider:
     into a string format suitable for sending to an external device via a serial connection.
     Attributes:
     - queue_metrics (Queue[dict[str, float]]): A queue for placing the latest system metrics as a dictionary.
-    - queue_serial_sender (Queue[str]): A queue for placing the decoded metrics string to be sent to the serial device.
+    - queue_serial_sender (Queue[str | bytes]): A queue for placing the decoded metrics frame to be sent to the serial device.
+    - binary_frame (bool): Whether the metrics are sent as a binary frame or as the legacy text frame.
     - update_interval_seconds (float): The interval in seconds at which to read and update the system metrics.
     - _stop_event (threading.Event): An event to signal the thread to stop running.
     - _thread (threading.Thread): The thread that runs the metrics reading loop.
@@ -30,8 +32,8 @@ class SystemMetricsProvider:
         Attributes to store the latest date and time information.
     """
 
-    def __init__(self, queue_metrics: Queue[dict[str, Any]], queue_serial_sender: Queue[str], 
-                 update_interval_seconds: float = 1.0) -> None:
+    def __init__(self, queue_metrics: Queue[dict[str, Any]], queue_serial_sender: Queue[str | bytes], 
+                 update_interval_seconds: float = 1.0, binary_frame: bool = True) -> None:
         """
         Initializes the SystemMetricsProvider with the specified queues for metrics and serial sender.
         It detects the platform and initializes the LibreHardwareMonitor for reading hardware metrics.
@@ -40,9 +42,11 @@ class SystemMetricsProvider:
         Args:
             queue_metrics (Queue[dict[str, float]]): A queue for placing the latest system
                 metrics as a dictionary.
-            queue_serial_sender (Queue[str]): A queue for placing the decoded metrics string to be sent
+            queue_serial_sender (Queue[str | bytes]): A queue for placing the decoded metrics frame to be sent
                 to the serial device.
             update_interval_seconds (float): The interval in seconds at which to read and update the system metrics.
+            binary_frame (bool): Send metrics as a binary frame, set False to keep the legacy text frame
+                for StreamDeco firmwares without binary frame support.
         This constructor sets up the necessary attributes and initializes the hardware monitoring components.
         """
         self._platform = platform.system().lower()
@@ -55,6 +59,7 @@ class SystemMetricsProvider:
         self.queue_serial_sender = queue_serial_sender # A queue for placing the decoded metrics string to be sent to the serial device.
         self.queue_metrics = queue_metrics # A queue for placing the latest system metrics as a dictionary.
         self.update_interval_seconds = update_interval_seconds
+        self.binary_frame = binary_frame
         self._stop_event = threading.Event() # An event to signal the thread to stop running.
         self._thread = threading.Thread(target=self._run, daemon=True) # The thread that runs the metrics reading loop.
         self.cpu_load, self.cpu_temp, self.cpu_freq = 0.0, 0.0, 0.0
@@ -336,13 +341,13 @@ class SystemMetricsProvider:
                 report("SystemMetricsProvider", "ERROR", "Failed to enqueue metrics payload after dropping oldest one, queue is still full.")
                 pass
 
-    def _queue_serial_payload(self, payload: str) -> None:
+    def _queue_serial_payload(self, payload: str | bytes) -> None:
         """
         Attempts to enqueue the decoded metrics payload into the queue_serial_sender.
         If the queue is full, it will drop the oldest payload to make room for the new one.
         If it fails to enqueue after dropping the oldest payload, it logs an error message.
         Args:
-            payload (str): The decoded metrics string to be enqueued for sending to the serial device.
+            payload (str | bytes): The decoded metrics frame to be enqueued for sending to the serial device.
         This method tries to place the decoded metrics payload into the queue_serial_sender using put_nowait.
         If the queue is full, it catches the Full exception and attempts to remove the oldest payload
         from the queue using get_nowait. If the queue is unexpectedly empty at this point, it logs an
@@ -406,12 +411,13 @@ class SystemMetricsProvider:
             "disk_used": self.disk_used, "disk_total": self.disk_total,
         }
 
-    def decode(self) -> str:
+    def decode(self) -> str | bytes:
         """
-        Decodes the current system metrics into a string format suitable for sending to an external device.
-        The format of the decoded string is a comma-separated list of the metrics values followed by a slash ("/").
+        Decodes the current system metrics into a frame suitable for sending to an external device.
+        If binary_frame is set, the frame is a length-prefixed binary frame with CRC (see monitor_frame module),
+        otherwise it is a comma-separated list of the metrics values followed by a slash ("/").
         Returns:
-            str: The decoded metrics string.
+            str | bytes: The decoded metrics frame.
         """
         fields = [
             int(self.cpu_load), int(self.cpu_temp), int(self.cpu_freq),
@@ -421,4 +427,6 @@ class SystemMetricsProvider:
             int(self.date_sec), int(self.date_min), int(self.date_hour),
             int(self.date_week), int(self.date_day), int(self.date_month), int(self.date_year),
         ]
-        return ", ".join(str(field) for field in fields) + "/"
+        if self.binary_frame:
+            return encode_binary(fields)
+        return encode_text(fields)
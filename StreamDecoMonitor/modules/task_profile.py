@@ -0,0 +1,171 @@
+from __future__ import annotations
+
+import argparse
+import re
+import time
+from dataclasses import dataclass, field
+from typing import Iterable
+
+from .monitor_frame import TOP_REQUEST, encode_request
+from .report import report
+
+# Task profiler table printed by StreamDeco on its serial log, must match
+# print_top() of src/streamDeco_init.cpp. Only firmware built with
+# RTOS_PROFILER=1 answers TOP_REQUEST, one table per interval:
+#
+#   Top window 1000 ticks, 9 tasks, hook 85 cycles, overhead 0.035 %
+#   Top core 0 load 20.0 %, switches 50, unregistered 1.0 %
+#   Top task 3.0 %, core 1, runs 5, stack 1800, Task worker
+#
+# CPU of a task is the percentage of one core, ticks are 1 ms.
+
+_WINDOW = re.compile(r"Top window (\d+) ticks, (\d+) tasks, hook (\d+) cycles, overhead ([\d.]+) %")
+_CORE = re.compile(r"Top core (\d+) load ([\d.]+) %, switches (\d+), unregistered ([\d.]+) %")
+_TASK = re.compile(r"Top task ([\d.]+) %, core ([\d-]), runs (\d+), stack (\d+), (.+?)\s*$")
+_COLOR = re.compile(r"\x1b\[[\d;]*m")  # log colors of ESP_LOGx
+
+
+@dataclass
+class CoreLoad:
+    core: int
+    load: float
+    switches: int
+    unregistered: float
+
+
+@dataclass
+class TaskLoad:
+    name: str
+    cpu: float
+    core: int | None
+    runs: int
+    stack_free: int
+
+
+@dataclass
+class TopSample:
+    ticks: int
+    task_count: int
+    hook_cycles: int
+    overhead: float
+    cores: list[CoreLoad] = field(default_factory=list)
+    tasks: list[TaskLoad] = field(default_factory=list)
+
+    @property
+    def complete(self) -> bool:
+        return len(self.tasks) == self.task_count
+
+
+class TopParser:
+    """
+    Rebuilds the tables from serial log lines, other lines are skipped.
+    """
+
+    def __init__(self) -> None:
+        self._sample: TopSample | None = None
+
+    def feed(self, line: str) -> TopSample | None:
+        """
+        Parses one log line.
+        Args:
+            line (str): Line read from the serial log.
+        Returns:
+            TopSample | None: The table, once its last task line is read.
+        """
+        line = _COLOR.sub("", line)
+        if match := _WINDOW.search(line):
+            self._sample = TopSample(int(match[1]), int(match[2]), int(match[3]), float(match[4]))
+        elif self._sample is None:
+            return None
+        elif match := _CORE.search(line):
+            self._sample.cores.append(CoreLoad(int(match[1]), float(match[2]), int(match[3]), float(match[4])))
+        elif match := _TASK.search(line):
+            core = None if match[2] == "-" else int(match[2])
+            self._sample.tasks.append(TaskLoad(match[5], float(match[1]), core, int(match[3]), int(match[4])))
+        else:
+            return None
+
+        if not self._sample.complete:
+            return None
+        sample, self._sample = self._sample, None
+        return sample
+
+
+def parse(lines: Iterable[str]) -> list[TopSample]:
+    """
+    Parses every table of a serial log.
+    """
+    parser = TopParser()
+    return [sample for line in lines if (sample := parser.feed(line)) is not None]
+
+
+def read(port: str, interval: int = 1, duration: float = 30.0) -> list[TopSample]:
+    """
+    Requests the table every interval seconds and collects it for duration seconds.
+    StreamDecoMonitor must be closed, the serial port is not shared.
+    Args:
+        port (str): COM port of StreamDeco.
+        interval (int): Seconds between tables, 1 to 255.
+        duration (float): Seconds to collect.
+    Returns:
+        list[TopSample]: Tables received.
+    """
+    from serial import Serial
+
+    if not 0 < interval < 256:
+        raise ValueError(f"Invalid interval {interval}")
+
+    parser = TopParser()
+    samples: list[TopSample] = []
+    with Serial(port, 115200, timeout=0.5) as serial:
+        serial.write(encode_request(TOP_REQUEST, interval))
+        end = time.monotonic() + duration
+        while time.monotonic() < end:
+            sample = parser.feed(serial.readline().decode("utf-8", errors="replace"))
+            if sample is not None:
+                samples.append(sample)
+        serial.write(encode_request(TOP_REQUEST, 0))
+
+    if not samples:
+        report("TaskProfile", "WARNING", "No table received, is StreamDeco built with RTOS_PROFILER=1?")
+    return samples
+
+
+def plot(samples: list[TopSample], interval: int = 1) -> None:
+    """
+    Plots the CPU of each task and the load of each core over time.
+    Requires the matplotlib package (pip install matplotlib).
+    """
+    try:
+        import matplotlib.pyplot as plt
+    except ImportError:
+        report("TaskProfile", "ERROR", "matplotlib package not installed")
+        return
+
+    seconds = [index * interval for index in range(len(samples))]
+    names = sorted({task.name for sample in samples for task in sample.tasks})
+    figure, (tasks_axis, cores_axis) = plt.subplots(2, 1, sharex=True)
+    for name in names:
+        cpu = [next((task.cpu for task in sample.tasks if task.name == name), 0.0) for sample in samples]
+        tasks_axis.plot(seconds, cpu, label=name)
+    tasks_axis.set_ylabel("CPU of one core (%)")
+    tasks_axis.legend(fontsize="small", ncol=2)
+    cores = sorted({core.core for sample in samples for core in sample.cores})
+    for core in cores:
+        load = [next((load.load for load in sample.cores if load.core == core), 0.0) for sample in samples]
+        cores_axis.plot(seconds, load, label=f"core {core}")
+    cores_axis.plot(seconds, [sample.overhead for sample in samples], label="profiler overhead")
+    cores_axis.set_ylabel("Load (%)")
+    cores_axis.set_xlabel("Time (s)")
+    cores_axis.legend(fontsize="small")
+    figure.suptitle("StreamDeco tasks")
+    plt.show()
+
+
+if __name__ == "__main__":
+    arguments = argparse.ArgumentParser(description="Plot the task profiler table of StreamDeco")
+    arguments.add_argument("port", help="COM port of StreamDeco")
+    arguments.add_argument("--interval", type=int, default=1, help="seconds between tables")
+    arguments.add_argument("--duration", type=float, default=30.0, help="seconds to collect")
+    options = arguments.parse_args()
+    plot(read(options.port, options.interval, options.duration), options.interval)
@@ -18,6 +18,7 @@ Run:
 """
 
 
+from __future__ import annotations
 from queue import Queue
 
 from modules.report import *
@@ -55,7 +56,7 @@ if __name__ == "__main__":
     # queue_metrics will carry the latest system metrics data for the GUI to display
     # queue_serial_sender will carry system metrics through the serial connection
     queue_metrics: Queue[dict[str, float]] = Queue(maxsize=6)
-    queue_serial_sender: Queue[str] = Queue(maxsize=6)
+    queue_serial_sender: Queue[str | bytes] = Queue(maxsize=6)
 
     # Feed queus with system metrics
     metrics = SystemMetricsProvider(queue_metrics, queue_serial_sender)
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+from pathlib import Path
+import sys
+
+sys.path.append(str(Path(__file__).resolve().parents[1]))
+
+import modules.ble_transport as bt
+import modules.monitor_frame as mf
+import modules.report as report
+
+FIELDS = (37, 54, 3600, 12, 48, 1750, 9120, 32680, 412, 931, 15, 42, 21, 3, 16, 10, 2026)
+
+if __name__ == "__main__":
+    report.set_debug_level("DEBUG")
+
+    snapshot = [mf.encode_binary(FIELDS)]
+    assert len(bt.coalesce(snapshot, bt.PREFERRED_MTU)) == 1, "Metrics snapshot must fit one write"
+    assert len(bt.coalesce(snapshot, bt.DEFAULT_MTU)) == 3, "Snapshot split on default MTU"
+
+    frames = [mf.encode_binary(FIELDS), mf.encode_frame(mf.SHORTCUTS_TYPE, bytes(60)), mf.encode_binary(FIELDS)]
+    for mtu in (bt.DEFAULT_MTU, bt.PREFERRED_MTU, 247):
+        writes = bt.coalesce(frames, mtu)
+        assert all(len(write) <= mtu - bt.ATT_HEADER_SIZE for write in writes), "Write larger than MTU"
+        assert b"".join(writes) == b"".join(frames), "Frames not reassembled"
+    assert mf.decode_binary(b"".join(bt.coalesce(snapshot, bt.DEFAULT_MTU))) == FIELDS, "Snapshot decode failed"
+
+    try:
+        bt.coalesce(snapshot, bt.ATT_HEADER_SIZE)
+        raise AssertionError("MTU without payload was accepted")
+    except ValueError:
+        pass
+
+    serial = bt.SerialLink()
+    report.report("BLE Test", "INFO", f"Serial {serial.baud} baud: {serial.latency(snapshot) * 1e3:.2f} ms/snapshot")
+    for interval_ms in (7.5, 15.0, 30.0):
+        for mtu in (bt.DEFAULT_MTU, bt.PREFERRED_MTU):
+            link = bt.BleLink(interval_ms=interval_ms, mtu=mtu, packets_per_event=1)
+            report.report("BLE Test", "INFO",
+                          f"BLE interval {interval_ms} ms, MTU {mtu}: {len(link.writes(snapshot))} writes, "
+                          f"{link.latency(snapshot) * 1e3:.2f} ms/snapshot")
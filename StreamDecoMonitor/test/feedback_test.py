@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+from pathlib import Path
+import sys
+
+sys.path.append(str(Path(__file__).resolve().parents[1]))
+
+import modules.host_feedback as hf
+import modules.report as report
+
+if __name__ == "__main__":
+    report.set_debug_level("DEBUG")
+
+    assert hf.encode_feedback(hf.MIC_MUTED, hf.MIC_MUTED) == bytes((0x03, 0x01, 0x01)), "Mic report failed"
+    assert hf.encode_feedback(0xFF, hf.MEDIA_PLAYING) == bytes((0x03, 0x02, 0x02)), "Bits out of mask were sent"
+    try:
+        hf.encode_feedback(0x100, 0)
+        raise AssertionError("State out of range was accepted")
+    except ValueError:
+        pass
+
+    feedback = hf.HostFeedback()
+    assert not feedback.set(hf.WINDOW_PINNED, True), "Write without device must fail"
+
+    report.report("Feedback Test", "INFO", f"Report: {hf.encode_feedback(0x05, 0x07).hex(' ')}")
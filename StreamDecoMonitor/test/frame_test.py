@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+from pathlib import Path
+import sys
+import timeit
+
+sys.path.append(str(Path(__file__).resolve().parents[1]))
+
+import modules.monitor_frame as mf
+import modules.report as report
+
+FIELDS = (37, 54, 3600, 12, 48, 1750, 9120, 32680, 412, 931, 15, 42, 21, 3, 16, 10, 2026)
+
+if __name__ == "__main__":
+    report.set_debug_level("DEBUG")
+
+    binary = mf.encode_binary(FIELDS)
+    text = mf.encode_text(FIELDS)
+    assert mf.decode_binary(binary) == FIELDS, "Binary frame round trip failed"
+    assert mf.decode_text(text) == FIELDS, "Text frame round trip failed"
+    assert mf.crc16(b"123456789") == 0x29B1, "CRC-16/CCITT-FALSE check value failed"
+
+    assert mf.encode_request(mf.TRACE_REQUEST)[:5] == bytes((0xA5, 0x01, 0x03, 0x01, 0x01)), "Trace request failed"
+    assert mf.encode_request(mf.MEMORY_REQUEST)[:5] == bytes((0xA5, 0x01, 0x03, 0x01, 0x03)), "Memory request failed"
+    assert mf.encode_request(mf.EXECUTOR_REQUEST)[:5] == bytes((0xA5, 0x01, 0x03, 0x01, 0x04)), "Executor request failed"
+
+    corrupted = bytearray(binary)
+    corrupted[6] ^= 0x01
+    try:
+        mf.decode_binary(bytes(corrupted))
+        raise AssertionError("Corrupted frame was accepted")
+    except ValueError:
+        pass
+
+    runs = 100000
+    binary_time = timeit.timeit(lambda: mf.decode_binary(binary), number=runs)
+    text_time = timeit.timeit(lambda: mf.decode_text(text), number=runs)
+    report.report("Frame Test", "INFO", f"Binary frame: {len(binary)} bytes, {binary.hex(' ')}")
+    report.report("Frame Test", "INFO", f"Text frame: {len(text)} bytes, {text}")
+    report.report("Frame Test", "INFO", f"Binary decode: {binary_time / runs * 1e6:.2f} us/frame")
+    report.report("Frame Test", "INFO", f"Text decode: {text_time / runs * 1e6:.2f} us/frame")
+    assert binary_time < text_time, "Binary decode is slower than text"
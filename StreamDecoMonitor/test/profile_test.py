@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+from pathlib import Path
+import sys
+
+sys.path.append(str(Path(__file__).resolve().parents[1]))
+
+import modules.monitor_frame as mf
+import modules.task_profile as tp
+import modules.report as report
+
+LOG = """I (61234) Stream Deco: Top window 2000 ticks, 3 tasks, hook 85 cycles, overhead 0.035 %
+I (61234) Stream Deco: Top core 0 load 21.5 %, switches 412, unregistered 1.2 %
+I (61235) Stream Deco: Top core 1 load 38.0 %, switches 97, unregistered 0.0 %
+I (61235) Stream Deco: Monitor latency last 812 us
+\x1b[0;32mI (61236) Stream Deco: Top task 34.2 %, core 1, runs 96, stack 1392, Port task LVGL\x1b[0m
+I (61236) Stream Deco: Top task 0.4 %, core 0, runs 8, stack 1800, Task worker
+I (61237) Stream Deco: Top task 0.0 %, core -, runs 0, stack 2900, Task update cache
+I (63234) Stream Deco: Top window 2000 ticks, 1 tasks, hook 86 cycles, overhead 0.036 %
+"""
+
+if __name__ == "__main__":
+    report.set_debug_level("DEBUG")
+
+    assert mf.encode_request(mf.TOP_REQUEST, 2)[:6] == bytes((0xA5, 0x01, 0x03, 0x02, 0x02, 0x02)), "Top request failed"
+
+    samples = tp.parse(LOG.splitlines())
+    assert len(samples) == 1, "Partial table was returned"
+    sample = samples[0]
+    assert (sample.ticks, sample.hook_cycles, sample.overhead) == (2000, 85, 0.035), "Window line failed"
+    assert [core.load for core in sample.cores] == [21.5, 38.0], "Core lines failed"
+    assert sample.tasks[0].name == "Port task LVGL", "Log colors were kept"
+    assert sample.tasks[1] == tp.TaskLoad("Task worker", 0.4, 0, 8, 1800), "Task line failed"
+    assert sample.tasks[2].core is None, "Task never run has no core"
+
+    for task in sample.tasks:
+        report.report("Profile Test", "INFO", f"{task.name}: {task.cpu:.1f} % core {task.core}, runs {task.runs}")
+    report.report("Profile Test", "INFO", f"Profiler overhead {sample.overhead:.3f} %, {sample.hook_cycles} cycles/tick")
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+from pathlib import Path
+import sys
+
+sys.path.append(str(Path(__file__).resolve().parents[1]))
+
+import modules.monitor_frame as mf
+import modules.report as report
+import modules.shortcut_table as st
+
+EVENTS = 10
+SEQUENCES = {
+    1: [st.chord(0x05, 0x28)],                      # ctrl + alt + return
+    4: [st.chord(0x01, 0x06), st.delay(50), st.chord(0x01, 0x19)],  # ctrl + c, ctrl + v
+    7: [st.media(0x00, 0x02)],                      # calculator
+    8: [st.chord(0x08, 0x15), st.delay(300), st.text("notepad"), st.chord(0x00, 0x28)],  # gui + r, run notepad
+}
+
+if __name__ == "__main__":
+    report.set_debug_level("DEBUG")
+
+    image = st.build(EVENTS, SEQUENCES)
+    decoded = st.decode(image, EVENTS)
+    for event in range(EVENTS):
+        assert decoded[event] == SEQUENCES.get(event, []), f"Event {event} round trip failed"
+
+    long_text = st.text("x" * 300)
+    assert long_text[1] == st.MAX_TEXT_SIZE and len(long_text) == 2 + 255 + 2 + 45, "Text split failed"
+
+    corrupted = bytearray(image)
+    corrupted[-1] ^= 0x01
+    try:
+        st.decode(bytes(corrupted), EVENTS)
+        raise AssertionError("Corrupted image was accepted")
+    except ValueError:
+        pass
+
+    frames = st.encode_frames(image)
+    received = b""
+    for frame in frames[1:-1]:
+        payload = frame[mf.HEADER.size:-mf.CRC.size]
+        assert payload[0] == st.DATA_COMMAND, "Data frame expected"
+        assert int.from_bytes(payload[1:3], "little") == len(received), "Chunk out of order"
+        received += payload[3:]
+    assert received == image, "Chunks do not rebuild the image"
+
+    report.report("Shortcut Test", "INFO", f"Image: {len(image)} bytes, {len(frames)} frames")
+    report.report("Shortcut Test", "INFO", f"Image: {image.hex(' ')}")
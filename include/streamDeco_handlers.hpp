@@ -28,38 +28,78 @@ namespace streamDeco
 {
 
   /**
-   * @brief   Handle the buttons streamDecoTasks, made buttons configurations and manager buttons events
+   * @brief   Handle button_message, manager buttons events
     * @details The events can generate a keyboard code to send to computer through BLE Bluetooth
-   *          or change StreamDeco configurations
+   *          or change StreamDeco configurations, reports are sent by BleKeyboard sender task
    */
-  void handleButtons(taskArg_t arg);
+  void handleButton(const executor::message_t &message);
 
   /**
-   * @brief   Handle the ui reset streamDecoTasks
-   * @details Each 10 seconds a timer will pass a event to this streamDecoTasks
-    *          to hide additional screens and return to Main screen
+   * @brief   Handle sent_message, HID reports of the last button are notified
+   * @details Record the shortcut latency and resume a macro that waited for the previous one
    */
-  void handleIdle(taskArg_t arg);
+  void handleSent(const executor::message_t &message);
 
   /**
-   * @brief   Handle the monitor streamDecoTasks
+   * @brief   Handle feedback_message, show the computer state on toggle buttons
+   */
+  void handleFeedback(const executor::message_t &message);
+
+  /**
+   * @brief   Handle idle_message
+   * @details Timers pass a event to hide additional screens and return to Main screen
+    *          or to reduce the backlight
+   */
+  void handleIdle(const executor::message_t &message);
+
+  /**
+   * @brief   Handle memory_message, sample memory telemetry
+   */
+  void handleMemory(const executor::message_t &message);
+
+  /**
+   * @brief   Handle frame_message
    * @details Update computer metrics on Monitor screen
    */
-  void handleMonitor(taskArg_t arg);
+  void handleFrame(const executor::message_t &message);
 
   /**
-   * @brief   Handle the clock streamDecoTasks
-   * @details Update clock on Monitor screen
+   * @brief   Handle tick_message
+   * @details Update clock on Monitor screen and ESP32 RTC from time messages
    */
-  void handleClock(taskArg_t arg);
+  void handleClock(const executor::message_t &message);
 
-  /* Handle the clock sync streamDecoTasks,
-   * synchronize clock time with streamDeco monitor application */
-  void handleClockSync(taskArg_t task_arg);
+  /**
+   * @brief   Handle ingest_message
+   * @details Reassemble StreamDecoMonitor frames received on Serial or BLE
+   *          and publish them through frameRouter
+   */
+  void handleIngest(const executor::message_t &message);
 
-  /* Handle the update cache streamDecoTasks,
+  /**
+   * @brief   Register the Serial and BLE data receivers of handleIngest
+   * @note    Call before bleKeyboard.begin(), the data service is created there
+   */
+  void initIngest();
+
+  /**
+   * @brief   Bytes received on BLE and dropped because ingest was behind
+   */
+  uint32_t ingestDropped();
+
+  /**
+   * @brief   Shortcuts and request frames refused from a BLE host other than the active one
+   */
+  uint32_t ingestRefused();
+
+  /* Handle save_message,
    * update and save the settings cache with flash */
-  void handleUpdateCache(taskArg_t task_arg);
+  void handleUpdateCache(const executor::message_t &message);
+
+  /**
+   * @brief   Handle dump_message, print the requested table on serial log
+   */
+  void handleDump(const executor::message_t &message);
 
 } // namespace streamDeco
 
@@ -22,6 +22,8 @@
 #ifndef _STREAMDECO_INIT_HPP_
 #define _STREAMDECO_INIT_HPP_
 
+#include "rtos_profiler.hpp"
+
 namespace streamDeco
 {
 
@@ -39,5 +41,33 @@ namespace streamDeco
    * @details to print on serial StreamDecoMonitor tasks memory usage
    */
   void print_task_memory_usage();
+
+  /**
+   * @brief   Print StreamDecoMonitor frames latency
+   * @details Time from first byte arrival on Serial interface to monitor widgets update
+   */
+  void print_frame_latency();
+
+  /**
+   * @brief   Print keyboard shortcuts latency
+   * @details Time from button event to the last HID report notified,
+   *          BLE connection parameters and report latency histogram
+   */
+  void print_shortcut_latency();
+
+  /**
+   * @brief   Print tap to keystroke trace
+   * @details p50/p99 of each stage from touch interrupt to HID notify
+   *          and the stage times of the last taps
+   */
+  void print_trace();
+
+#if RTOS_PROFILER
+  /**
+   * @brief   Print task profiler table
+   * @details Load of each core, CPU and runs of each task since the previous table
+   */
+  void print_top();
+#endif
 }
 #endif
\ No newline at end of file
@@ -29,111 +29,24 @@
 #include "marcelino.hpp"
 
 #include "streamDeco_settings.hpp"
+#include "streamDeco_screens.hpp"
 #include "streamDeco_buttons.hpp"
+#include "streamDeco_executor.hpp"
 #include "streamDeco_monitor.hpp"
+#include "streamDeco_frame.hpp"
+#include "streamDeco_keymap.hpp"
+#include "streamDeco_memory.hpp"
+#include "streamDeco_trace.hpp"
 
 namespace streamDeco
 {
 
-  constexpr long streamDecoTask_buttons_stackSize = 3_kB;
-  constexpr long streamDecoTask_uiReset_stackSize = 1_kB;
-  constexpr long streamDecoTask_monitor_stackSize = 2_kB;
-  constexpr long streamDecoTask_clock_stackSize = 3_kB;
-  constexpr long streamDecoTask_clockSync_stackSize = 4_kB;
-  constexpr long streamDecoTask_updateCache_stackSize = 3_kB;
+  /* one worker runs every handler, flash writes of save_message need the most stack */
+  constexpr long streamDecoTask_worker_stackSize = 5_kB;
 
-  /**
-   * @enum     event_e
-    * @brief    Event enumeration
-    * @details  Events registered on StreamDeco buttons
-   **/
-  enum event_e
-  {
-
-    nothing_event,
-
-    /* --- MAIN CANVAS EVENTS --- */
-    terminal_event,
-    files_event,
-    web_event,
-    search_event,
-    applications_canvas_event,
-    applications_canvas_fix_event,
-
-    multimedia_prev_event,
-    multimedia_play_event,
-    multimedia_next_event,
-    multimedia_mic_event,
-    multimedia_canvas_event,
-    multimedia_canvas_fix_event,
-
-    left_workspace_event,
-    right_workspace_event,
-    pin_window_event,
-    lock_computer_event,
-    ruler_event,
-    desktop_mode_event,
-    configurations_canvas_event,
-    configurations_canvas_fix_event,
-
-    /* --- APPLICATIONS CANVAS EVENTS --- */
-
-    applications_canvas_app1_event,
-    applications_canvas_app2_event,
-    applications_canvas_app3_event,
-
-    applications_canvas_app4_event,
-    applications_canvas_app5_event,
-    applications_canvas_app6_event,
-
-    applications_canvas_app7_event,
-    applications_canvas_app8_event,
-    applications_canvas_app9_event,
-
-    /* --- MULTIMEDIA CANVAS EVENTS --- */
-
-    multimedia_canvas_mult1_event,
-    multimedia_canvas_mult2_event,
-    multimedia_canvas_mult3_event,
-
-    multimedia_canvas_mult4_event,
-    multimedia_canvas_mult5_event,
-    multimedia_canvas_mult6_event,
-
-    multimedia_canvas_mult7_event,
-    multimedia_canvas_mult8_event,
-    multimedia_canvas_mult9_event,
-
-    /* --- CONFIGURATIONS CANVAS EVENTS --- */
-
-    configuration_canvas_volmut_event,
-    configuration_canvas_voldown_event,
-    configuration_canvas_volup_event,
-
-    configuration_canvas_colorbackground_event,
-    configuration_canvas_colorbutton_event,
-    configuration_canvas_rotate_screen_event, // experimental
-
-    configuration_canvas_sysmonitor_event,
-    configuration_canvas_sysconfig_event,
-    configuration_canvas_logout_event,
-    configuration_canvas_reboot_event,
-    configuration_canvas_shutdown_event,
-
-    slider_backlight_bright_value_change_event,
-
-    /* --- CANVAS EVENT --- */
-
-    hidden_canvas_event,
-
-    /* --- Reduce backlight bright event --- */
-
-    rest_backlight_event,
-
-    /* --- Update the settings cache --- */
-    update_settings_cache_with_reset_event,
-
-  };
+  constexpr uint32_t metrics_queue_size = 4;
+  constexpr uint32_t time_queue_size = 1;
+  constexpr uint32_t frameRouter_max_subscribers = 4;
 
   namespace settings
   {
@@ -164,628 +77,352 @@ namespace streamDeco
   namespace streamDecoTasks
   {
     /**
-     * @var      buttons
-     * @brief    Task buttons
-     * @details  Task to manager buttons configurations and events
+     * @var      worker
+     * @brief    Task worker
+     * @details  Task to drain the messages of events::loop, buttons, frames,
+     *           clock, idle timers, settings cache and serial log dumps
      **/
-    extern rtos::TaskStatic<streamDecoTask_buttons_stackSize> buttons;
+    extern rtos::TaskStatic<streamDecoTask_worker_stackSize> worker;
+  } // namespace streamDecoTasks
 
+  /**
+   * @namespace  events
+   * @brief      Event loop of streamDecoTasks worker
+   * @details    Callbacks, frameRouter subscribers and timers post typed messages,
+   *             the worker dispatches them by priority and times each handler
+   * @note       post and timer functions can be called by any task, not by an ISR
+   **/
+  namespace events
+  {
     /**
-     * @var      uiReset
-     * @brief    Task uiReset
-      * @details  Task to hide inactive streamDecoCanvas elements
-     **/
-    extern rtos::TaskStatic<streamDecoTask_uiReset_stackSize> idle;
+     * @brief    Post a message and wake the worker
+     * @param    tap  Trace id of the touch, read by the handler from message.tap
+     * @return   false if the queue is full or the message has no handler yet
+     */
+    bool post(executor::message_e type, uint32_t value = 0, uint32_t tap = 0);
 
     /**
-     * @var      monitor
-     * @brief    Task monitor
-     * @details  Task to show computer metrics on monitor streamDecoCanvas
-     **/
-    extern rtos::TaskStatic<streamDecoTask_monitor_stackSize> monitor;
+     * @brief    Post a message after delay, again every period if not zero
+     */
+    executor::timer_id_t schedule(executor::message_e type, uint32_t value, microseconds delay,
+                                  microseconds period = 0us);
 
     /**
-     * @var      clock
-     * @brief    Task clock
-     * @details  Task to update clock
-     **/
-    extern rtos::TaskStatic<streamDecoTask_clock_stackSize> clock;
+     * @brief    Delay a timer again from now
+     */
+    void restart(executor::timer_id_t timer);
 
     /**
-     * @var      clockSync
-     * @brief    Task clockSync
-     * @details  Task to synchronize clock with StreamDeco monitor application
-     **/
-    extern rtos::TaskStatic<streamDecoTask_clockSync_stackSize> clockSync;
+     * @brief    Change the period of a timer and restart it, zero stops it
+     */
+    void period(executor::timer_id_t timer, microseconds period);
 
     /**
-     * @var      updateCache
-     * @brief    Task updateCache
-     * @details  Task to update and save the settings cache with flash
-     **/
-    extern rtos::TaskStatic<streamDecoTask_updateCache_stackSize> updateCache;
-  } // namespace streamDecoTasks
+     * @brief    Route links, storage and dump handlers and attach the worker
+     * @note     Call before the first frame is expected, frames feed sync_clock
+     */
+    void init();
+
+    /**
+     * @brief    Route the handlers that change widgets and start the idle timers
+     * @note     Call after widgets are created
+     */
+    void start();
+
+    /**
+     * @brief    Print queue depth and execution time of each handler, counters are cleared
+     * @note     Called by the worker on executor_dump
+     */
+    void print();
+
+  } // namespace events
 
   /**
-   * @namespace  timer_ui
-   * @brief      Timers
+   * @namespace  timers_idle
+   * @brief      Timers of the worker
    **/
   namespace timers_idle
   {
     /**
-     * @var      uiReset
-     * @brief    uiReset timer
+     * @var      canvas_idle
+     * @brief    Canvas idle timer
       * @details  Timer to generate an event to hide additional streamDecoCanvas
       * @details  and return to Main screen on inactivity
       * @note     The timer value can be changed in file streamDeco_objects.cpp
      **/
-    extern rtos::TimerStatic canvas_idle;
+    extern executor::timer_id_t canvas_idle;
+    extern const microseconds canvas_idle_period;
 
     /**
-     * @var      backlight
+     * @var      backlight_idle
      * @brief    Backlight timer
       * @details  Timer to reduce screen backlight on inactivity
       * @note     The timer value can be changed in file streamDeco_objects.cpp
      */
-    extern rtos::TimerStatic backlight_idle;
-  } // namespace timers_idle
-
-  /**
-   * @namespace  streamDecoCanvas
-   * @brief      Canvas to hold additional buttons
-   * @details  applications streamDecoCanvas 9 applications buttons
-   * @details  multimedia streamDecoCanvas 9 multimedia buttons
-   * @details  configurations streamDecoCanvas 9 configurations buttons and bright streamDecoBrightSlider
-   * @details  monitor streamDecoCanvas with computer metrics and clock
-   */
-  namespace streamDecoCanvas
-  {
-    /**
-     * @var     applications
-     * @brief   Applications Canvas
-      * @details Canvas to hold additional app shortcuts
-     **/
-    extern lvgl::Canvas applications;
+    extern executor::timer_id_t backlight_idle;
+    extern const microseconds backlight_idle_period;
 
     /**
-     * @var     multimedia
-     * @brief   Multimedia Canvas
-     * @details Canvas to hold multimedia apps shortcuts
-     **/
-    extern lvgl::Canvas multimedia;
-
-    /**
-    * @var     configurations
-     * @brief   Configurations Canvas
-     * @details Canvas to hold configurations shortcuts
-     **/
-    extern lvgl::Canvas configurations;
-
-    /**
-     * @var     monitor
-     * @brief   Monitor Canvas
-     * @details Canvas to monitor computer stats
-     **/
-    extern lvgl::Canvas monitor;
-
-    /**
-     * @var     style_landscape
-     * @brief   Style Canvas in landscape
-     * @details Style for streamDecoCanvas in landscape */
-    extern lvgl::Style style_landscape;
-
-    /**
-     * @var     style_portrait
-     * @brief   Style Canvas in portrait
-     * @details Style for streamDecoCanvas in portrait */
-    extern lvgl::Style style_portrait;
-
-    void init(lvgl::screen::rotation_t rotation);
-    void portrait();
-    void landscape();
-  } // namespace streamDecoCanvas
+     * @var      memory_sample
+     * @brief    Memory telemetry timer
+      * @details  Timer to sample internal RAM, PSRAM and LVGL pool usage
+      * @note     The timer value can be changed in file streamDeco_objects.cpp
+     */
+    extern executor::timer_id_t memory_sample;
+    extern const microseconds memory_sample_period;
+  } // namespace timers_idle
 
+#if RTOS_PROFILER
   /**
-   * @namespace  streamDecoButtons
-   * @brief      Buttons of StreamDeco
+   * @namespace  timers_profiler
+   * @brief      Timers of task profiler
    **/
-  namespace streamDecoButtons
+  namespace timers_profiler
   {
-
-    /**
-      * @brief   Callback registered on buttons
-      * @details Send notifications with event code to the task buttons handler
-     * @param   lvglEvent  Event received by the callback
-      * @note    This callback is registered on buttons and streamDecoBrightSlider objects
-     * @note    Each streamDecoButtons and streamDecoBrightSlider send a different event
-     **/
-    void buttons_callback(lvgl::event::event_t lvglEvent);
-
-    /* --- MAIN BUTTONS --- */
-
-    /**
-     * @var      terminal
-     * @brief    terminal streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open terminal on computer
-     **/
-    extern MainButton terminal;
-
-    /**
-     * @var      files
-     * @brief    files streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open file explorer on computer
-     **/
-    extern MainButton files;
-
-    /**
-     * @var      web
-     * @brief    web streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open web browser on computer
-     **/
-    extern MainButton web;
-
-    /**
-     * @var      search
-     * @brief    search streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open search mechanism on computer
-     **/
-    extern MainButton search;
-
-    /**
-     * @var      applications_canvas
-     * @brief    applications_canvas streamDecoButtons
-     * @details  This streamDecoButtons open, close or pin Applications streamDecoCanvas
-     **/
-    extern MainButton applications_canvas;
-
-    /**
-     * @var      multimedia_prev
-     * @brief    Multimedia prev streamDecoButtons
-     * @details  This streamDecoButtons pass to previous media on music player computer
-     **/
-    extern MainButton multimedia_prev;
-
-    /**
-     * @var      multimedia_play
-     * @brief    Multimedia play streamDecoButtons
-     * @details  This streamDecoButtons play/pause media on music player computer
-     **/
-    extern MainButton multimedia_play;
-
-    /**
-     * @var      multimedia_next
-     * @brief    Multimedia next streamDecoButtons
-     * @details  This streamDecoButtons pass to next media on music player computer
-     **/
-    extern MainButton multimedia_next;
-
-    /**
-     * @var      multimedia_mic
-     * @brief    Multimedia mic streamDecoButtons
-     * @details  This streamDecoButtons is supposed to mute/unmute microphone computer
-     **/
-    extern MainButton multimedia_mic;
-
-    /**
-     * @var      multimedia_canvas
-     * @brief    multimedia_canvas streamDecoButtons
-     * @details  This streamDecoButtons open, close or pin Multimedia streamDecoCanvas
-     **/
-    extern MainButton multimedia_canvas;
-
-    /**
-     * @var      left_workspace
-     * @brief    Left workspace mic streamDecoButtons
-     * @details  This streamDecoButtons is supposed to change to left workspace on computer
-     **/
-    extern MainButton left_workspace;
-
-    /**
-     * @var      right_workspace
-     * @brief    Right workspace mic streamDecoButtons
-     * @details  This streamDecoButtons is supposed to change to right workspace on computer
-     **/
-    extern MainButton right_workspace;
-
-    /**
-     * @var      pin
-     * @brief    Pin streamDecoButtons
-     * @details  This streamDecoButtons is supposed to pin/unpin window computer
-     **/
-    extern MainButton pin;
-
-    /**
-     * @var      ruler
-     * @brief    Lock streamDecoButtons
-     * @details  This streamDecoButtons is supposed to show ruler on screem
-     **/
-    extern MainButton ruler;
-
-    /**
-     * @var      configurations_canvas
-     * @brief    configurations_canvas streamDecoButtons
-     * @details  This streamDecoButtons open, close or pin Configurations streamDecoCanvas
-     **/
-    extern MainButton configurations_canvas;
-
-    /* --- APPLICATIONS BUTTONS --- */
-
-    /**
-     * @var      app1
-     * @brief    Application 1 streamDecoButtons
-     * @details  This streamDecoButtons open app 1 on computer
-     **/
-    extern CanvasButton app1;
-
-    /**
-     * @var      app2
-     * @brief    Application 2 streamDecoButtons
-     * @details  This streamDecoButtons open app 2 on computer
-     **/
-    extern CanvasButton app2;
-
-    /**
-     * @var      app3
-     * @brief    Application 3 streamDecoButtons
-     * @details  This streamDecoButtons open app 3 on computer
-     **/
-    extern CanvasButton app3;
-
-    /**
-     * @var      app4
-     * @brief    Application 4 streamDecoButtons
-     * @details  This streamDecoButtons open app 4 on computer
-     **/
-    extern CanvasButton app4;
-
-    /**
-     * @var      app5
-     * @brief    Application 5 streamDecoButtons
-     * @details  This streamDecoButtons open app 5 on computer
-     **/
-    extern CanvasButton app5;
-
-    /**
-     * @var      app6
-     * @brief    Application 6 streamDecoButtons
-     * @details  This streamDecoButtons open app 6 on computer
-     **/
-    extern CanvasButton app6;
-
-    /**
-     * @var      app7
-     * @brief    Application 7 streamDecoButtons
-     * @details  This streamDecoButtons open app 7 on computer
-     **/
-    extern CanvasButton app7;
-
-    /**
-     * @var      app8
-     * @brief    Application 8 streamDecoButtons
-     * @details  This streamDecoButtons open app 8 on computer
-     **/
-    extern CanvasButton app8;
-
-    /**
-     * @var      app9
-     * @brief    Application 9 streamDecoButtons
-     * @details  This streamDecoButtons open app 9 on computer
-     **/
-    extern CanvasButton app9;
-
-    /* --- MULTIMEDIA BUTTONS --- */
-
-    /**
-     * @var      mult1
-     * @brief    Multimedia 1 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 1 on computer
-     **/
-    extern CanvasButton mult1;
-
     /**
-     * @var      mult2
-     * @brief    Multimedia 2 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 2 on computer
+     * @var      top
+     * @brief    Top timer
+      * @details  Timer to print the task profiler table, period set by StreamDecoMonitor top_request
      **/
-    extern CanvasButton mult2;
+    extern executor::timer_id_t top;
+  } // namespace timers_profiler
+#endif
 
-    /**
-     * @var      mult3
-     * @brief    Multimedia 3 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 3 on computer
-     **/
-    extern CanvasButton mult3;
-
-    /**
-     * @var      mult4
-     * @brief    Multimedia 4 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 4 on computer
-     **/
-    extern CanvasButton mult4;
+  /**
+   * @var    bleKeyboard
+   * @brief  Reference to blekeyboard object
+   * @brief  Interface to send keyboard codes to Bluetooth
+   */
+  extern BleKeyboard bleKeyboard;
 
-    /**
-     * @var      mult5
-     * @brief    Multimedia 5 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 5 on computer
-     **/
-    extern CanvasButton mult5;
+  /**
+   * @var    mutex_serial
+   * @brief  Reference to serial interface mutex
+   * @note   Used to avoid Monitor and Clock streamDecoTasks uses Serial interface in same time
+   */
+  extern rtos::MutexRecursiveStatic mutex_serial;
 
+  /**
+   * @namespace  frameRouter
+   * @brief      Demultiplex StreamDecoMonitor frames
+   * @details    Each frame is parsed once by the ingest handler of streamDecoTasks worker and published
+   *             to the subscribers of every topic it carries
+   * @note       Subscribe during init, before events::init
+   */
+  namespace frameRouter
+  {
     /**
-     * @var      mult6
-     * @brief    Multimedia 6 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 6 on computer
-     **/
-    extern CanvasButton mult6;
+     * @enum     topic_e
+     * @brief    Typed messages carried by a frame
+     */
+    enum topic_e
+    {
+      metrics_topic, /* computer metrics, every frame */
+      time_topic,    /* computer clock, frames with date */
+      shortcuts_topic, /* shortcut table transfer */
+      request_topic,   /* requests of StreamDecoMonitor */
+      topic_count,
+    };
+
+    /**
+     * @typedef  subscriber_t
+     * @brief    Subscriber callback, run on streamDecoTasks worker context
+     * @note     Must not block, post to a queue or an event
+     */
+    typedef void (*subscriber_t)(const frame::slot_t &slot);
 
     /**
-     * @var      mult7
-     * @brief    Multimedia 7 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 7 on computer
-     **/
-    extern CanvasButton mult7;
+     * @brief    Subscribe to a topic
+     * @return   false if the topic has no free subscriber slot
+     */
+    bool subscribe(topic_e topic, subscriber_t subscriber);
 
     /**
-     * @var      mult8
-     * @brief    Multimedia 8 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 8 on computer
-     **/
-    extern CanvasButton mult8;
+     * @brief    Publish a frame to the subscribers of its topics
+     */
+    void publish(const frame::slot_t &slot);
 
     /**
-     * @var      mult9
-     * @brief    Multimedia 9 streamDecoButtons
-     * @details  This streamDecoButtons execute multimedia action 9 on computer
-     **/
-    extern CanvasButton mult9;
+     * @brief    Subscribe metrics_queue and time_queue to their topics
+     */
+    void init();
 
-    /* --- CONFIGURATIONS BUTTONS --- */
+  } // namespace frameRouter
 
-    /**
-     * @var      volmult
-     * @brief    Volume mute streamDecoButtons
-     * @details  This streamDecoButtons mute/unmute audio output on computer
-     **/
-    extern ConfigButton volmut;
+  /**
+   * @var    metrics_queue
+   * @brief  Reference to computer metrics queue, drained on frame_message
+   */
+  extern rtos::QueueStatic<frame::slot_t, metrics_queue_size> metrics_queue;
 
-    /**
-     * @var      voldown
-     * @brief    Volume down streamDecoButtons
-     * @details  This streamDecoButtons lower volume of audio output on computer
-     **/
-    extern ConfigButton voldown;
+  /**
+   * @var    time_queue
+   * @brief  Reference to computer clock queue, drained on tick_message
+   * @note   Only the last time message matters, older is dropped
+   */
+  extern rtos::QueueStatic<frame::slot_t, time_queue_size> time_queue;
 
-    /**
-     * @var      volup
-     * @brief    Volume up streamDecoButtons
-     * @details  This streamDecoButtons riser volume of audio output on computer
-     **/
-    extern ConfigButton volup;
+  /**
+   * @var    monitor_latency
+   * @brief  Reference to latency counters from frame arrival to monitor widgets update
+   */
+  extern frame::Latency monitor_latency;
 
-    /**
-     * @var      color_background
-     * @brief    Color backgound streamDecoButtons
-     * @details  Change background color of StreamDeco
-     **/
-    extern ConfigButton color_background;
+  /**
+   * @var    transport_latency
+   * @brief  Reference to monitor latency counters of each link, serial and BLE
+   */
+  extern frame::Latency transport_latency[frame::transport_count];
 
-    /**
-     * @var      color_button
-     * @brief    Color streamDecoButtons streamDecoButtons
-     * @details  Change streamDecoButtons color of StreamDeco
-     **/
-    extern ConfigButton color_button;
+  /**
+   * @var    monitor_lock_takes
+   * @brief  Reference to LVGL mutex takes nested in the last monitor frame batch
+   * @note   Without batch each one would be a separate mutex acquisition
+   */
+  extern uint32_t monitor_lock_takes;
 
-    /**
-     * @brief in work
-     */
-    extern ConfigButton rotation;
+  /**
+   * @var    monitor_lock_acquisitions
+   * @brief  Reference to LVGL mutex acquisitions around the last monitor frame batch
+   * @note   Counted across the batch scope, LVGL task acquisitions in between are included
+   */
+  extern uint32_t monitor_lock_acquisitions;
 
-    /**
-     * @var      sysmonitor
-     * @brief    System Monitor streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open system monitor on computer
-     **/
-    extern ConfigButton sysmonitor;
+  /**
+   * @var    shortcut_latency
+   * @brief  Reference to latency counters from button event to last HID report sent
+   */
+  extern frame::Latency shortcut_latency;
 
-    /**
-     * @var      sysconfig
-     * @brief    System Configurations streamDecoButtons
-     * @details  This streamDecoButtons is supposed to open configurations panel on computer
-     **/
-    extern ConfigButton sysconfig;
+  /**
+   * @var    tracer
+   * @brief  Reference to tap to keystroke trace, stages recorded from touch to HID notify
+   */
+  extern trace::Tracer tracer;
 
-    /**
-     * @var      reboot
-     * @brief    Reboot streamDecoButtons
-     * @details  This streamDecoButtons is supposed to restart StreamDeco
-     **/
-    extern ConfigButton reboot;
+  /**
+   * @brief    Process buttons event
+   * @param    button_event  Event generated by streamDecoButtons
+   * @param    tap           Trace id of the touch, kept if the event is deferred
+   * @param    settings      Reference to StreamDeco settings
+   * @details  Called on button_message to send shortcuts to computer via BLE Bluetooth interface
+    * @note     Each streamDecoButtons sends an event code registered during streamDecoButtons configuration
+   *
+   */
+  void process_event(uint32_t button_event, uint32_t tap = 0);
 
-    /**
-     * @brief  Create the main canva buttons
-     * @param  settings  Settings configuration
-     */
-    void createMain(settings::settings_t settings);
+  /**
+   * @enum     dump_e
+   * @brief    Serial log dumps, value of executor::dump_message
+   */
+  enum dump_e : uint32_t
+  {
+    trace_dump,    /* tap to keystroke trace, StreamDecoMonitor trace_request */
+    top_dump,      /* task profiler table, top_request or timers_profiler::top */
+    memory_dump,   /* memory telemetry history, memory_request */
+    executor_dump, /* queue depth and handler times, executor_request */
+  };
 
-    /**
-     * @brief  Create the applications canva buttons
-     * @param  parent    Object parent of the new slider
-     * @param  settings  Settings configuration
-     */
-    void createApplication(lvgl::Object &parent, settings::settings_t settings);
+  /**
+   * @namespace  feedback
+   * @brief      State of toggle buttons written by the computer on the HID feedback report
+   * @details    Report is two bytes, state bits and the mask of bits the computer knows
+   */
+  namespace feedback
+  {
+    enum state_e : uint8_t
+    {
+      mic_muted = 0x01,
+      media_playing = 0x02,
+      window_pinned = 0x04,
+    };
 
     /**
-     * @brief  Create the multimedia canva buttons
-     * @param  parent    Object parent of the new slider
-     * @param  settings  Settings configuration
+     * @brief    Receive feedback reports from bleKeyboard
      */
-    void createMultimedia(lvgl::Object &parent, settings::settings_t settings);
+    void init();
 
     /**
-     * @brief  Create the configuration canva buttons
-     * @param  parent    Object parent of the new slider
-     * @param  settings  Settings configuration
+     * @brief    Show the last state received on toggle buttons
+     * @note     Called by streamDecoTasks worker on feedback_message
      */
-    void createConfiguration(lvgl::Object &parent, settings::settings_t settings);
+    void process();
 
-    /**
-     * @brief  Change color of Buttons
-     * @param  color  New button color
-     * @note   Called in color_button event
-     **/
-    void color(lvgl::palette::palette_t color);
-
-    /**
-     * @brief  Sort buttons in portrait order
-     **/
-    void portrait();
-
-    /**
-     * @brief  Sort buttons in landscape order
-     **/
-    void landscape();
-
-  } // namespace streamDecoButtons
+  } // namespace feedback
 
   /**
-   * @namespace  streamDecoBrightSlider
-   * @brief      Bright control Slider
-   * @details    Organize streamDecoBrightSlider bight backlight
-   **/
-  namespace streamDecoBrightSlider
+   * @namespace  telemetry
+   * @brief      Memory telemetry of internal RAM, PSRAM and LVGL pool
+   * @details    Sampled by streamDecoTasks worker on timers_idle::memory_sample,
+   *             a warning is logged when the fragmentation of a pool crosses the threshold
+   */
+  namespace telemetry
   {
     /**
-     * @var    slider
-     * @brief  Backlight bright control streamDecoBrightSlider
-     **/
-    extern lvgl::Slider slider;
-
-    /**
-     * @var    styler
-     * @brief  Backlight bright control streamDecoBrightSlider style
-     **/
-    extern lvgl::Style slider_style;
-
-    /**
-     * @var    icon
-     * @brief  Backlight bright control icon
-     **/
-    extern lvgl::Image icon;
-
-    /**
-     * @var    icon
-     * @brief  Backlight bright control icon style
-     **/
-    extern lvgl::Style icon_style;
-
-    /**
-     * @brief  Init backlight streamDecoBrightSlider
-     * @param  parent    Object parent of the new slider
-     * @param  callback  The new event function
-     * @param  icon      Pointer to an lvgl::lv_img_dsc_t to be streamDecoBrightSlider icon
-     * @param  settings  Settings configuration
+     * @var     memory
+     * @brief   History of memory samples, owned by streamDecoTasks worker
      **/
-    void init(lvgl::Object &parent, settings::settings_t &settings);
+    extern memory::Telemetry memory;
 
     /**
-     * @brief  Put slider in landscape format
+     * @brief    Schedule timers_idle::memory_sample, the first sample is taken after one period
      */
-    void landscape();
+    void init();
 
     /**
-     * @brief  Put slider in portrait format
+     * @brief    Sample all pools
+     * @note     Called by streamDecoTasks worker on memory_message
      */
-    void portrait();
+    void sample();
 
     /**
-     * @brief  Return slider bright value
-     * @note   Same as slider.get_value
+     * @brief    Print the last sample, leak growth and fragmentation history
+     * @note     Called by streamDecoTasks worker on memory_dump
      */
-    int read();
+    void print();
 
-    /**
-     * @brief  Change color of slider
-     * @param  color  New slider color
-     * @note   Called in color_button event
-     **/
-    void color(lvgl::palette::palette_t color);
-
-  } // namespace streamDecoBrightSlider
+  } // namespace telemetry
 
   /**
-   * @namespace  streamDecoMonitor
-   * @brief      Monitor computer metrics
-   * @details    Organize monitor metrics
-   **/
-  namespace streamDecoMonitor
+   * @namespace  shortcuts
+   * @brief      Shortcut table used by process_event
+   * @details    Loaded from flash on init, replaced at runtime by StreamDecoMonitor
+   *             through shortcuts frames and saved on save_message
+   */
+  namespace shortcuts
   {
     /**
-     * @var      cpu
-     * @brief    Metric CPU
-     * @details  Show CPU load, temperature and frequency metrics in complete metric
-     **/
-    extern metric::Complete cpu;
-
-    /**
-     * @var      gpu
-     * @brief    Metric GPU
-     * @details  Show GPU load, temperature and frequency metrics in complete metric
+     * @var     flash
+     * @brief   Two flash files, each new table is saved over the oldest one
+     * @note    A write interrupted by reset leaves the other file valid
      **/
-    extern metric::Complete gpu;
+    extern marcelino::File<keymap::image_t> flash[2];
 
     /**
-     * @var      system
-     * @brief    Metric system
-     * @details  Show RAM and Disk usage metrics in basic metric
-     **/
-    extern metric::Basic system;
+     * @brief    Load the newest valid table from flash or the built in one
+     * @details  Subscribe to shortcuts_topic, call before events::init
+     */
+    void init();
 
     /**
-     * @var      clock
-     * @brief    Clock metric
-     * @details  Show clock with time and data
-     **/
-    extern metric::Clock clock;
+     * @brief    Save the active table on flash if it was replaced
+     * @note     Called by streamDecoTasks worker on save_message
+     */
+    void save();
 
     /**
-     * @brief  Init system monitor applet
-     * @param  parent  Object parent of the new slider
-     * @param  color   Monitor applet color
+     * @brief    Replay the button event of a macro that waited for the previous one
+     * @note     Called by streamDecoTasks worker on sent_message
      */
-    void init(lvgl::Object &parent, lvgl::palette::palette_t color);
+    void resume();
 
     /**
-     * @brief  Change color of Monitor
-     * @param  color  New monitor color
-     * @note   Called in color_button event
-     **/
-    void color(lvgl::palette::palette_t color);
-
-  } // namespace streamDecoMonitor
-
-  /**
-   * @var    bleKeyboard
-   * @brief  Reference to blekeyboard object
-   * @brief  Interface to send keyboard codes to Bluetooth
-   */
-  extern BleKeyboard bleKeyboard;
-
-  /**
-   * @var    mutex_serial
-   * @brief  Reference to serial interface mutex
-   * @note   Used to avoid Monitor and Clock streamDecoTasks uses Serial interface in same time
-   */
-  extern rtos::MutexRecursiveStatic mutex_serial;
+     * @brief    Characters typed by the text steps of the last macro
+     * @note     Valid after bleKeyboard.isPlaying() is false
+     */
+    uint32_t characters();
 
-  /**
-   * @brief    Process buttons event
-   * @param    button_event  Event generated by streamDecoButtons
-   * @param    settings      Reference to StreamDeco settings
-   * @details  Called by streamDecoTasks streamDecoButtons to send shortcuts to computer via BLE Bluetooth interface
-    * @note     Each streamDecoButtons sends an event code registered during streamDecoButtons configuration
-   *
-   */
-  void process_event(uint32_t button_event);
+  } // namespace shortcuts
 
 } // namespace streamDeco
 
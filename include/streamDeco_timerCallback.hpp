@@ -27,16 +27,9 @@
 namespace streamDeco
 {
 
-  /**
-   * @brief    Callback function to handle backlight timer
-   * @details  Set backlight brightness to 10% after timer overflow
-   * @param    timerHandle The rtos timer send the timer handler to callback function
-   **/
-  void timer_callback(TimerHandle_t timerHandle);
-
   /**
    * @brief   Callback registered on buttons
-   * @details Send notifications with event code to streamDecoTasks buttons handler
+   * @details Post button_message with event code to streamDecoTasks worker
    * @param   event  Event received by the callback
    * @note    This callback is registered on buttons and streamDecoBrightSlider objects
    * @note    Each streamDecoButtons and streamDecoBrightSlider send a different event
@@ -0,0 +1,128 @@
+#include "BleConnectionPolicy.h"
+
+// 7.5 to 15 ms, the shortest interval accepted by most hosts
+static const BleConnParams ACTIVE_PARAMS = {6, 12, 0, 400};
+// 60 to 100 ms, 4 events may be skipped when nothing is sent
+static const BleConnParams IDLE_PARAMS = {48, 80, 4, 400};
+
+BleConnectionPolicy::BleConnectionPolicy()
+    : _active(ACTIVE_PARAMS)
+    , _idle(IDLE_PARAMS) {}
+
+void BleConnectionPolicy::setActiveParams(const BleConnParams& params) {
+  _active = params;
+}
+
+void BleConnectionPolicy::setIdleParams(const BleConnParams& params) {
+  _idle = params;
+}
+
+/**
+ * @brief Sets the time (in milliseconds) to wait the host apply a request
+ *        before it is sent again
+ */
+void BleConnectionPolicy::setRetryTime(uint32_t ms) {
+  _retry_ms = ms;
+}
+
+// Keys are expected right after a connection, start on active parameters
+void BleConnectionPolicy::onConnect(uint16_t interval, uint16_t latency) {
+  _interval = interval;
+  _latency = latency;
+  _target = DISCONNECTED;
+  target(ACTIVE);
+}
+
+void BleConnectionPolicy::onDisconnect(void) {
+  _target = DISCONNECTED;
+  _pending = false;
+  _interval = 0;
+  _latency = 0;
+}
+
+void BleConnectionPolicy::onParams(uint16_t interval, uint16_t latency) {
+  _interval = interval;
+  _latency = latency;
+}
+
+void BleConnectionPolicy::activity(void) {
+  if (_target != DISCONNECTED)
+    target(ACTIVE);
+}
+
+void BleConnectionPolicy::idle(void) {
+  if (_target != DISCONNECTED)
+    target(IDLE);
+}
+
+bool BleConnectionPolicy::poll(uint32_t now_ms, BleConnParams& request) {
+  if (_target == DISCONNECTED)
+    return false;
+
+  if (matches(_target)) {
+    _pending = false;
+    return false;
+  }
+
+  if (_pending) {
+    if (now_ms - _last_request_ms < _retry_ms)
+      return false;
+    // the host kept the previous values or picked some out of range
+    _pending = false;
+    _rejected++;
+  }
+
+  if (_attempts >= CONN_MAX_ATTEMPTS)
+    return false;
+
+  request = params(_target);
+  _pending = true;
+  _attempts++;
+  _requests++;
+  _last_request_ms = now_ms;
+  return true;
+}
+
+BleConnectionPolicy::Mode BleConnectionPolicy::getMode(void) {
+  if (_target == DISCONNECTED)
+    return DISCONNECTED;
+  return _interval <= _active.maxInterval ? ACTIVE : IDLE;
+}
+
+BleConnectionPolicy::Mode BleConnectionPolicy::getTarget(void) {
+  return _target;
+}
+
+uint16_t BleConnectionPolicy::getInterval(void) {
+  return _interval;
+}
+
+uint16_t BleConnectionPolicy::getLatency(void) {
+  return _latency;
+}
+
+uint32_t BleConnectionPolicy::getRequests(void) {
+  return _requests;
+}
+
+uint32_t BleConnectionPolicy::getRejected(void) {
+  return _rejected;
+}
+
+const BleConnParams& BleConnectionPolicy::params(Mode mode) {
+  return mode == ACTIVE ? _active : _idle;
+}
+
+bool BleConnectionPolicy::matches(Mode mode) {
+  const BleConnParams& wanted = params(mode);
+  return _interval >= wanted.minInterval && _interval <= wanted.maxInterval;
+}
+
+// A new target restarts the attempts, the same one keeps counting
+void BleConnectionPolicy::target(Mode mode) {
+  if (_target == mode)
+    return;
+  _target = mode;
+  _pending = false;
+  _attempts = 0;
+}
@@ -0,0 +1,73 @@
+#ifndef ESP32_BLE_CONNECTION_POLICY_H
+#define ESP32_BLE_CONNECTION_POLICY_H
+
+#include <stdint.h>
+
+//  Connection parameters, in Bluetooth units:
+//  interval 1.25 ms, latency in connection events, timeout 10 ms
+typedef struct
+{
+  uint16_t minInterval;
+  uint16_t maxInterval;
+  uint16_t latency;
+  uint16_t timeout;
+} BleConnParams;
+
+//  Decide when to request a connection parameters update.
+//  Short interval while keys are sent, long interval with slave latency when
+//  idle. Requests are retried until the host applies them or gives up after
+//  CONN_MAX_ATTEMPTS, the host has the last word on the negotiated values.
+//  No radio dependencies, time and negotiated values are fed by the caller,
+//  so it can be built and driven natively.
+class BleConnectionPolicy
+{
+public:
+  enum Mode : uint8_t
+  {
+    DISCONNECTED,
+    ACTIVE,
+    IDLE,
+  };
+
+  static const uint8_t CONN_MAX_ATTEMPTS = 3;
+
+  BleConnectionPolicy();
+  void setActiveParams(const BleConnParams& params);
+  void setIdleParams(const BleConnParams& params);
+  void setRetryTime(uint32_t ms);
+
+  void onConnect(uint16_t interval, uint16_t latency);
+  void onDisconnect(void);
+  void onParams(uint16_t interval, uint16_t latency);
+  void activity(void);
+  void idle(void);
+
+  // true when request must be sent to the host now
+  bool poll(uint32_t now_ms, BleConnParams& request);
+
+  Mode getMode(void);
+  Mode getTarget(void);
+  uint16_t getInterval(void);
+  uint16_t getLatency(void);
+  uint32_t getRequests(void);
+  uint32_t getRejected(void);
+
+private:
+  const BleConnParams& params(Mode mode);
+  bool matches(Mode mode);
+  void target(Mode mode);
+
+  BleConnParams _active;
+  BleConnParams _idle;
+  uint32_t _retry_ms = 2000;
+  Mode _target = DISCONNECTED;
+  uint16_t _interval = 0;
+  uint16_t _latency = 0;
+  bool _pending = false;
+  uint8_t _attempts = 0;
+  uint32_t _last_request_ms = 0;
+  uint32_t _requests = 0;
+  uint32_t _rejected = 0;
+};
+
+#endif // ESP32_BLE_CONNECTION_POLICY_H
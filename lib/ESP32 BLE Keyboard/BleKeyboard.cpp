@@ -13,6 +13,7 @@
 #include "BLEHIDDevice.h"
 #endif // USE_NIMBLE
 #include "HIDTypes.h"
+#include "BleKeyboardAsciiMap.h"
 #include <driver/adc.h>
 #include "sdkconfig.h"
 
@@ -29,6 +30,23 @@
 // Report IDs:
 #define KEYBOARD_ID 0x01
 #define MEDIA_KEYS_ID 0x02
+#define FEEDBACK_ID 0x03
+
+// Output queue
+#define REPORT_QUEUE_SIZE 16
+#define REPORT_RETRIES 5
+#define SENDER_STACK_SIZE 3072
+#define SENDER_PRIORITY 2
+// Connection parameters are checked at least this often
+#define CONN_POLL_MS 250
+// Queued to wake the sender task, not sent
+#define WAKE_ID 0x00
+// Queued to switch the host notified by the sender task, data[0] is the host
+#define HOST_ID 0xFF
+
+const uint32_t BleKeyboard::LATENCY_LIMITS_US[BLE_LATENCY_BUCKETS - 1] = {
+  5000, 10000, 15000, 20000, 30000, 50000, 100000
+};
 
 static const uint8_t _hidReportDescriptor[] = {
   USAGE_PAGE(1),      0x01,          // USAGE_PAGE (Generic Desktop Ctrls)
@@ -92,6 +110,18 @@ static const uint8_t _hidReportDescriptor[] = {
   USAGE(2),           0x83, 0x01,    //   Usage (Media sel)   ; bit 6: 64
   USAGE(2),           0x8A, 0x01,    //   Usage (Mail)        ; bit 7: 128
   HIDINPUT(1),        0x02,          //   INPUT (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+  END_COLLECTION(0),                 // END_COLLECTION
+  // ------------------------------------------------- Host feedback
+  USAGE_PAGE(2),      0x00, 0xFF,    // USAGE_PAGE (Vendor Defined 0xFF00)
+  USAGE(1),           0x01,          // USAGE (Vendor Usage 1)
+  COLLECTION(1),      0x01,          // COLLECTION (Application)
+  REPORT_ID(1),       FEEDBACK_ID,   //   REPORT_ID (3)
+  USAGE(1),           0x02,          //   USAGE (Vendor Usage 2) ; state bits, valid bits
+  LOGICAL_MINIMUM(1), 0x00,          //   LOGICAL_MINIMUM (0)
+  LOGICAL_MAXIMUM(2), 0xFF, 0x00,    //   LOGICAL_MAXIMUM (255)
+  REPORT_SIZE(1),     0x08,          //   REPORT_SIZE (8)
+  REPORT_COUNT(1),    0x02,          //   REPORT_COUNT (2)
+  HIDOUTPUT(1),       0x02,          //   OUTPUT (Data,Var,Abs)
   END_COLLECTION(0)                  // END_COLLECTION
 };
 
@@ -99,7 +129,14 @@ BleKeyboard::BleKeyboard(std::string deviceName, std::string deviceManufacturer,
     : hid(0)
     , deviceName(std::string(deviceName).substr(0, 15))
     , deviceManufacturer(std::string(deviceManufacturer).substr(0,15))
-    , batteryLevel(batteryLevel) {}
+    , batteryLevel(batteryLevel) {
+  for (BleHost& host : _hosts) {
+    host.handle = BLE_HOST_NONE;
+    memset(host.address, 0, sizeof(host.address));
+    host.subscribed = 0;
+    host.mtu = BLE_ATT_DEFAULT_MTU;
+  }
+}
 
 void BleKeyboard::begin(void)
 {
@@ -113,6 +150,17 @@ void BleKeyboard::begin(void)
   inputMediaKeys = hid->inputReport(MEDIA_KEYS_ID);
 
   outputKeyboard->setCallbacks(this);
+  outputFeedback = hid->outputReport(FEEDBACK_ID);
+  outputFeedback->setCallbacks(this);
+#if defined(USE_NIMBLE)
+  inputKeyboard->setCallbacks(this);
+  inputMediaKeys->setCallbacks(this);
+#endif // USE_NIMBLE
+
+  _reportQueue = xQueueCreate(REPORT_QUEUE_SIZE, sizeof(HidReport));
+  _notifySemaphore = xSemaphoreCreateBinary();
+  _sentSemaphore = xSemaphoreCreateBinary();
+  xTaskCreate(senderTask, "BleKeyboard", SENDER_STACK_SIZE, this, SENDER_PRIORITY, &_senderTask);
 
   hid->manufacturer()->setValue(deviceManufacturer);
 
@@ -134,6 +182,17 @@ void BleKeyboard::begin(void)
   hid->reportMap((uint8_t*)_hidReportDescriptor, sizeof(_hidReportDescriptor));
   hid->startServices();
 
+#if defined(USE_NIMBLE)
+  // not advertised, the computer finds it on the services of the connected keyboard
+  if (_dataCallback != nullptr) {
+    NimBLEService* dataService = pServer->createService(BLE_DATA_SERVICE_UUID);
+    dataRx = dataService->createCharacteristic(BLE_DATA_RX_UUID,
+        NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR | NIMBLE_PROPERTY::WRITE_ENC);
+    dataRx->setCallbacks(this);
+    dataService->start();
+  }
+#endif // USE_NIMBLE
+
   onStarted(pServer);
 
   advertising = pServer->getAdvertising();
@@ -150,8 +209,11 @@ void BleKeyboard::end(void)
 {
 }
 
+/**
+ * @brief true if the active host is connected
+ */
 bool BleKeyboard::isConnected(void) {
-  return this->connected;
+  return _hosts[_activeHost].handle != BLE_HOST_NONE;
 }
 
 void BleKeyboard::setBatteryLevel(uint8_t level) {
@@ -166,7 +228,8 @@ void BleKeyboard::setName(std::string deviceName) {
 }
 
 /**
- * @brief Sets the waiting time (in milliseconds) between multiple keystrokes in NimBLE mode.
+ * @brief Sets the maximum waiting time (in milliseconds) for a notification to be sent
+ *        before the next report. The sender yields while waiting, it doesn't spin.
  * 
  * @param ms Time in milliseconds
  */
@@ -174,6 +237,302 @@ void BleKeyboard::setDelay(uint32_t ms) {
   this->_delay_ms = ms;
 }
 
+/**
+ * @brief Sets the time (in milliseconds) a key press waits for room on the output
+ *        queue when the link is congested, the report is dropped after it.
+ * 
+ * @param ms Time in milliseconds
+ */
+void BleKeyboard::setQueueTimeout(uint32_t ms) {
+  this->_queue_timeout_ms = ms;
+}
+
+/**
+ * @brief Wait until all queued reports are sent
+ * 
+ * @param ms Maximum time to wait in milliseconds
+ * @return true if the queue is empty
+ */
+bool BleKeyboard::waitSent(uint32_t ms) {
+  TickType_t start = xTaskGetTickCount();
+  while (_sent != _queued || _source != nullptr) {
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    if (elapsed >= pdMS_TO_TICKS(ms))
+      return false;
+    xSemaphoreTake(_sentSemaphore, pdMS_TO_TICKS(ms) - elapsed);
+  }
+  return true;
+}
+
+/**
+ * @brief Play the reports of a source on the sender task, the caller does not wait.
+ *        Queued reports are sent first, the source must stay valid until
+ *        isPlaying() is false.
+ * 
+ * @param source Reports to send
+ * @return false if not connected or another source is playing
+ */
+bool BleKeyboard::play(BleReportSource* source) {
+  if (!this->isConnected() || _reportQueue == nullptr)
+    return false;
+
+  BleReportSource* idle = nullptr;
+  if (!_source.compare_exchange_strong(idle, source))
+    return false;
+
+  setActive();
+  _sourceStartUs = esp_timer_get_time();
+  HidReport wake = {};
+  wake.id = WAKE_ID;
+  xQueueSend(_reportQueue, &wake, 0);
+  return true;
+}
+
+bool BleKeyboard::isPlaying(void) {
+  return _source != nullptr;
+}
+
+/**
+ * @brief Time (in microseconds) to play the last source
+ */
+int64_t BleKeyboard::getLastPlayTime(void) {
+  return _sourceTimeUs;
+}
+
+uint32_t BleKeyboard::getSentCount(void) {
+  return _sent;
+}
+
+uint32_t BleKeyboard::getDroppedCount(void) {
+  return _dropped;
+}
+
+uint32_t BleKeyboard::getCongestionCount(void) {
+  return _congestions;
+}
+
+/**
+ * @brief Time (in microseconds) from key press to notification sent of the last report
+ */
+int64_t BleKeyboard::getLastLatency(void) {
+  return _lastLatencyUs;
+}
+
+int64_t BleKeyboard::getMaxLatency(void) {
+  return _maxLatencyUs;
+}
+
+/**
+ * @brief Copy the report latency histogram
+ * 
+ * @param buckets BLE_LATENCY_BUCKETS counters
+ */
+void BleKeyboard::getLatencyHistogram(uint32_t* buckets) {
+  memcpy(buckets, _latencyHistogram, sizeof(_latencyHistogram));
+}
+
+void BleKeyboard::resetLatencyHistogram(void) {
+  memset(_latencyHistogram, 0, sizeof(_latencyHistogram));
+}
+
+/**
+ * @brief Request the short connection interval, keys are about to be sent.
+ *        Called on every report, call it earlier to have the link ready.
+ */
+void BleKeyboard::setActive(void) {
+  portENTER_CRITICAL(&_connLock);
+  _hosts[_activeHost].policy.activity();
+  portEXIT_CRITICAL(&_connLock);
+}
+
+/**
+ * @brief Request the long connection interval with slave latency on all hosts to save power
+ */
+void BleKeyboard::setIdle(void) {
+  portENTER_CRITICAL(&_connLock);
+  for (BleHost& host : _hosts)
+    host.policy.idle();
+  portEXIT_CRITICAL(&_connLock);
+}
+
+BleConnectionPolicy::Mode BleKeyboard::getConnMode(void) {
+  return _hosts[_activeHost].policy.getMode();
+}
+
+/**
+ * @brief Negotiated connection interval, in units of 1.25 ms
+ */
+uint16_t BleKeyboard::getConnInterval(void) {
+  return _hosts[_activeHost].policy.getInterval();
+}
+
+/**
+ * @brief Negotiated slave latency, in connection events
+ */
+uint16_t BleKeyboard::getConnLatency(void) {
+  return _hosts[_activeHost].policy.getLatency();
+}
+
+uint32_t BleKeyboard::getConnRequests(void) {
+  return _hosts[_activeHost].policy.getRequests();
+}
+
+uint32_t BleKeyboard::getConnRejected(void) {
+  return _hosts[_activeHost].policy.getRejected();
+}
+
+uint8_t BleKeyboard::getHostCount(void) {
+  uint8_t count = 0;
+  for (BleHost& host : _hosts)
+    if (host.handle != BLE_HOST_NONE)
+      count++;
+  return count;
+}
+
+uint8_t BleKeyboard::getActiveHost(void) {
+  return _activeHost;
+}
+
+bool BleKeyboard::isHostConnected(uint8_t host) {
+  return host < BLE_KEYBOARD_MAX_HOSTS && _hosts[host].handle != BLE_HOST_NONE;
+}
+
+/**
+ * @brief Send next reports to another connected host, the links of all hosts
+ *        are kept so switching needs no pairing or advertising
+ * 
+ * @param host Host slot, 0 to BLE_KEYBOARD_MAX_HOSTS - 1
+ * @return false if the host is not connected
+ */
+bool BleKeyboard::selectHost(uint8_t host) {
+  if (!isHostConnected(host))
+    return false;
+  if (host != _activeHost)
+    activateHost(host);
+  return true;
+}
+
+/**
+ * @brief Select the next connected host, in slot order
+ * 
+ * @return false if no other host is connected
+ */
+bool BleKeyboard::nextHost(void) {
+  for (uint8_t step = 1; step < BLE_KEYBOARD_MAX_HOSTS; step++) {
+    uint8_t host = (_activeHost + step) % BLE_KEYBOARD_MAX_HOSTS;
+    if (isHostConnected(host))
+      return selectHost(host);
+  }
+  return false;
+}
+
+/**
+ * @brief Time (in microseconds) from the last host switch to the first report notified to it
+ */
+int64_t BleKeyboard::getLastSwitchLatency(void) {
+  return _lastSwitchUs;
+}
+
+int64_t BleKeyboard::getMaxSwitchLatency(void) {
+  return _maxSwitchUs;
+}
+
+// Reports queued from now on go to the new host, its link is woken up right
+// away. The sender task switches after the reports already queued, see switchHost.
+// onConnect calls it on the NimBLE host task, so it never waits for the queue:
+// a switch that finds it full is left in _pendingHost for the next report or
+// for the sender task once the queue is drained
+void BleKeyboard::activateHost(uint8_t host) {
+  _switchStartUs = esp_timer_get_time();
+  _activeHost = host;
+  setActive();
+
+  if (!postHost(host, 0))
+    _pendingHost = host;
+}
+
+// Queue the switch marker of a host, the sender task switches when it takes it
+bool BleKeyboard::postHost(uint8_t host, uint32_t timeout_ms) {
+  if (_reportQueue == nullptr)
+    return false;
+  HidReport next = {};
+  next.id = HOST_ID;
+  next.data[0] = host;
+  return xQueueSend(_reportQueue, &next, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+// Release all keys on the outgoing host before notifying the new one, a key
+// pressed by a shortcut or a macro would otherwise stay down on it
+void BleKeyboard::switchHost(uint8_t host) {
+  _nextHost = BLE_HOST_KEEP;
+  if (host == _sendHost)
+    return;
+
+  HidReport released = {};
+  released.id = KEYBOARD_ID;
+  released.size = sizeof(KeyReport);
+  notifyReport(released);
+  released.id = MEDIA_KEYS_ID;
+  released.size = sizeof(MediaKeyReport);
+  notifyReport(released);
+  _sendHost = host;
+}
+
+int8_t BleKeyboard::findHost(uint16_t handle) {
+  for (uint8_t host = 0; host < BLE_KEYBOARD_MAX_HOSTS; host++)
+    if (_hosts[host].handle == handle)
+      return host;
+  return -1;
+}
+
+/**
+ * @brief Register the function called when the computer writes the feedback output report
+ * @note  Called by the bluetooth host task, keep it short
+ * 
+ * @param callback Receives the state bits and the mask of bits the computer knows
+ */
+void BleKeyboard::onFeedback(BleFeedbackCallback callback) {
+  _feedbackCallback = callback;
+}
+
+/**
+ * @brief Register the function called when the computer writes on the data service
+ * @note  Must be called before begin, the service is only created with NimBLE.
+ *        Called by the bluetooth host task, keep it short
+ * 
+ * @param callback Receives the bytes of one write, at most MTU - 3
+ */
+void BleKeyboard::onData(BleDataCallback callback) {
+  _dataCallback = callback;
+}
+
+/**
+ * @brief Register the function called when all reports are sent, the same
+ *        moment waitSent returns true
+ * @note  Called by the sender task, keep it short
+ * 
+ * @param callback Called once the queue is empty and no source is playing
+ */
+void BleKeyboard::onSent(BleSentCallback callback) {
+  _sentCallback = callback;
+}
+
+/**
+ * @brief ATT MTU of the active host, a write carries up to MTU - 3 bytes
+ */
+uint16_t BleKeyboard::getMtu(void) {
+  return _hosts[_activeHost].mtu;
+}
+
+// Feedback report: state bits and valid bits, meaning defined by the application
+void BleKeyboard::receiveFeedback(BLECharacteristic* me) {
+  auto value = me->getValue();
+  const uint8_t* data = (const uint8_t*)value.c_str();
+  if (value.length() < 2 || _feedbackCallback == nullptr)
+    return;
+  _feedbackCallback(data[0], data[1]);
+}
+
 void BleKeyboard::set_vendor_id(uint16_t vid) { 
 	this->vid = vid; 
 }
@@ -188,167 +547,206 @@ void BleKeyboard::set_version(uint16_t version) {
 
 void BleKeyboard::sendReport(KeyReport* keys)
 {
-  if (this->isConnected())
-  {
-    this->inputKeyboard->setValue((uint8_t*)keys, sizeof(KeyReport));
-    this->inputKeyboard->notify();
-#if defined(USE_NIMBLE)        
-    // vTaskDelay(delayTicks);
-    this->delay_ms(_delay_ms);
-#endif // USE_NIMBLE
-  }	
+  queueReport(KEYBOARD_ID, (uint8_t*)keys, sizeof(KeyReport));
 }
 
 void BleKeyboard::sendReport(MediaKeyReport* keys)
 {
-  if (this->isConnected())
-  {
-    this->inputMediaKeys->setValue((uint8_t*)keys, sizeof(MediaKeyReport));
-    this->inputMediaKeys->notify();
-#if defined(USE_NIMBLE)        
-    //vTaskDelay(delayTicks);
-    this->delay_ms(_delay_ms);
+  queueReport(MEDIA_KEYS_ID, (uint8_t*)keys, sizeof(MediaKeyReport));
+}
+
+// Reports are sent by the sender task, the caller only waits when the queue
+// is full because the link is congested
+void BleKeyboard::queueReport(uint8_t id, const uint8_t* data, uint8_t size)
+{
+  if (!this->isConnected() || _reportQueue == nullptr)
+    return;
+
+  HidReport report;
+  report.id = id;
+  report.size = size;
+  memcpy(report.data, data, size);
+  report.queued_us = esp_timer_get_time();
+
+  setActive();
+
+  // a switch activateHost could not queue goes before this report
+  uint8_t pending = _pendingHost.exchange(BLE_HOST_KEEP);
+  if (pending != BLE_HOST_KEEP && !postHost(pending, _queue_timeout_ms)) {
+    uint8_t none = BLE_HOST_KEEP;
+    _pendingHost.compare_exchange_strong(none, pending);
+  }
+
+  _queued++;
+  if (xQueueSend(_reportQueue, &report, pdMS_TO_TICKS(_queue_timeout_ms)) != pdTRUE) {
+    _queued--;
+    _dropped++;
+  }
+}
+
+// Notify one report and wait the host stack to send it, retry while congested
+bool BleKeyboard::notifyReport(const HidReport& report)
+{
+  BLECharacteristic* characteristic = report.id == KEYBOARD_ID ? inputKeyboard : inputMediaKeys;
+#if defined(USE_NIMBLE)
+  uint16_t handle = _hosts[_sendHost].handle;
+  if (!(_hosts[_sendHost].subscribed & (report.id == KEYBOARD_ID ? 0x01 : 0x02)))
+    return false;
+#endif // USE_NIMBLE
+
+  for (int retry = 0; retry < REPORT_RETRIES && _hosts[_sendHost].handle != BLE_HOST_NONE; retry++) {
+    xSemaphoreTake(_notifySemaphore, 0);
+    _notifyFailed = false;
+    characteristic->setValue((uint8_t*)report.data, report.size);
+#if defined(USE_NIMBLE)
+    // only the host of the sender gets the report
+    if (ble_gattc_notify_custom(handle, characteristic->getHandle(),
+                                ble_hs_mbuf_from_flat(report.data, report.size)) != 0) {
+      _congestions++;
+      vTaskDelay(pdMS_TO_TICKS(_delay_ms));
+      continue;
+    }
+
+    // given by onStatus when the notification leaves the host stack
+    bool done = xSemaphoreTake(_notifySemaphore, pdMS_TO_TICKS(_delay_ms)) == pdTRUE;
+    if (done && !_notifyFailed)
+      return true;
+    _congestions++;
+    vTaskDelay(pdMS_TO_TICKS(_delay_ms));
+#else
+    characteristic->notify();
+    vTaskDelay(pdMS_TO_TICKS(_delay_ms));
+    return true;
+#endif // USE_NIMBLE
+  }
+  return false;
+}
+
+// Read the negotiated parameters and send the update requested by the policy
+void BleKeyboard::updateConnection(void)
+{
+#if defined(USE_NIMBLE)
+  ble_gap_conn_desc desc;
+  BleConnParams request;
+  uint32_t now_ms = esp_timer_get_time() / 1000;
+
+  for (BleHost& host : _hosts) {
+    uint16_t handle = host.handle;
+    if (handle == BLE_HOST_NONE || ble_gap_conn_find(handle, &desc) != 0)
+      continue;
+
+    portENTER_CRITICAL(&_connLock);
+    host.policy.onParams(desc.conn_itvl, desc.conn_latency);
+    bool send = host.policy.poll(now_ms, request);
+    portEXIT_CRITICAL(&_connLock);
+
+    if (send)
+      BLEDevice::getServer()->updateConnParams(handle, request.minInterval, request.maxInterval,
+                                               request.latency, request.timeout);
+  }
 #endif // USE_NIMBLE
-  }	
 }
 
-extern
-const uint8_t _asciimap[128] PROGMEM;
+// Notify one report taken from the queue and update the statistics
+void BleKeyboard::sendQueued(const HidReport& report)
+{
+  if (notifyReport(report)) {
+    int64_t now = esp_timer_get_time();
+    if (_switchStartUs && _sendHost == _activeHost) {
+      _lastSwitchUs = now - _switchStartUs;
+      if (_lastSwitchUs > _maxSwitchUs)
+        _maxSwitchUs = _lastSwitchUs;
+      _switchStartUs = 0;
+    }
+    _lastLatencyUs = now - report.queued_us;
+    if (_lastLatencyUs > _maxLatencyUs)
+      _maxLatencyUs = _lastLatencyUs;
+    uint8_t bucket = 0;
+    while (bucket < BLE_LATENCY_BUCKETS - 1 && _lastLatencyUs >= LATENCY_LIMITS_US[bucket])
+      bucket++;
+    _latencyHistogram[bucket]++;
+  } else {
+    _dropped++;
+  }
+
+  _sent++;
+  if (_sent == _queued)
+    allSent();
+}
 
-#define SHIFT 0x80
-const uint8_t _asciimap[128] =
+// Wake waitSent and tell the application, a playing source is not done yet
+void BleKeyboard::allSent(void)
 {
-	0x00,             // NUL
-	0x00,             // SOH
-	0x00,             // STX
-	0x00,             // ETX
-	0x00,             // EOT
-	0x00,             // ENQ
-	0x00,             // ACK
-	0x00,             // BEL
-	0x2a,			// BS	Backspace
-	0x2b,			// TAB	Tab
-	0x28,			// LF	Enter
-	0x00,             // VT
-	0x00,             // FF
-	0x00,             // CR
-	0x00,             // SO
-	0x00,             // SI
-	0x00,             // DEL
-	0x00,             // DC1
-	0x00,             // DC2
-	0x00,             // DC3
-	0x00,             // DC4
-	0x00,             // NAK
-	0x00,             // SYN
-	0x00,             // ETB
-	0x00,             // CAN
-	0x00,             // EM
-	0x00,             // SUB
-	0x00,             // ESC
-	0x00,             // FS
-	0x00,             // GS
-	0x00,             // RS
-	0x00,             // US
-
-	0x2c,		   //  ' '
-	0x1e|SHIFT,	   // !
-	0x34|SHIFT,	   // "
-	0x20|SHIFT,    // #
-	0x21|SHIFT,    // $
-	0x22|SHIFT,    // %
-	0x24|SHIFT,    // &
-	0x34,          // '
-	0x26|SHIFT,    // (
-	0x27|SHIFT,    // )
-	0x25|SHIFT,    // *
-	0x2e|SHIFT,    // +
-	0x36,          // ,
-	0x2d,          // -
-	0x37,          // .
-	0x38,          // /
-	0x27,          // 0
-	0x1e,          // 1
-	0x1f,          // 2
-	0x20,          // 3
-	0x21,          // 4
-	0x22,          // 5
-	0x23,          // 6
-	0x24,          // 7
-	0x25,          // 8
-	0x26,          // 9
-	0x33|SHIFT,      // :
-	0x33,          // ;
-	0x36|SHIFT,      // <
-	0x2e,          // =
-	0x37|SHIFT,      // >
-	0x38|SHIFT,      // ?
-	0x1f|SHIFT,      // @
-	0x04|SHIFT,      // A
-	0x05|SHIFT,      // B
-	0x06|SHIFT,      // C
-	0x07|SHIFT,      // D
-	0x08|SHIFT,      // E
-	0x09|SHIFT,      // F
-	0x0a|SHIFT,      // G
-	0x0b|SHIFT,      // H
-	0x0c|SHIFT,      // I
-	0x0d|SHIFT,      // J
-	0x0e|SHIFT,      // K
-	0x0f|SHIFT,      // L
-	0x10|SHIFT,      // M
-	0x11|SHIFT,      // N
-	0x12|SHIFT,      // O
-	0x13|SHIFT,      // P
-	0x14|SHIFT,      // Q
-	0x15|SHIFT,      // R
-	0x16|SHIFT,      // S
-	0x17|SHIFT,      // T
-	0x18|SHIFT,      // U
-	0x19|SHIFT,      // V
-	0x1a|SHIFT,      // W
-	0x1b|SHIFT,      // X
-	0x1c|SHIFT,      // Y
-	0x1d|SHIFT,      // Z
-	0x2f,          // [
-	0x31,          // bslash
-	0x30,          // ]
-	0x23|SHIFT,    // ^
-	0x2d|SHIFT,    // _
-	0x35,          // `
-	0x04,          // a
-	0x05,          // b
-	0x06,          // c
-	0x07,          // d
-	0x08,          // e
-	0x09,          // f
-	0x0a,          // g
-	0x0b,          // h
-	0x0c,          // i
-	0x0d,          // j
-	0x0e,          // k
-	0x0f,          // l
-	0x10,          // m
-	0x11,          // n
-	0x12,          // o
-	0x13,          // p
-	0x14,          // q
-	0x15,          // r
-	0x16,          // s
-	0x17,          // t
-	0x18,          // u
-	0x19,          // v
-	0x1a,          // w
-	0x1b,          // x
-	0x1c,          // y
-	0x1d,          // z
-	0x2f|SHIFT,    // {
-	0x31|SHIFT,    // |
-	0x30|SHIFT,    // }
-	0x35|SHIFT,    // ~
-	0				// DEL
-};
+  xSemaphoreGive(_sentSemaphore);
+  if (_sentCallback != nullptr && _source == nullptr)
+    _sentCallback();
+}
 
+// Send the next report of the playing source, stop at its end or on disconnect
+void BleKeyboard::playNext(void)
+{
+  BleSourceReport next;
+  if (_hosts[_sendHost].handle == BLE_HOST_NONE || !_source.load()->next(next)) {
+    _sourceTimeUs = esp_timer_get_time() - _sourceStartUs;
+    _sourceStarted = false;
+    _source = nullptr;
+    allSent();
+    return;
+  }
+  _sourceStarted = true;
+
+  if (next.delay_ms)
+    vTaskDelay(pdMS_TO_TICKS(next.delay_ms));
+
+  HidReport report;
+  report.id = next.media ? MEDIA_KEYS_ID : KEYBOARD_ID;
+  report.size = next.media ? sizeof(MediaKeyReport) : sizeof(KeyReport);
+  memcpy(report.data, next.data, report.size);
+  report.queued_us = esp_timer_get_time();
+  _queued++;
+  sendQueued(report);
+}
+
+void BleKeyboard::senderTask(void* arg)
+{
+  BleKeyboard* keyboard = static_cast<BleKeyboard*>(arg);
+  HidReport report;
+
+  while (true) {
+    // a switch activateHost could not queue, taken once the reports queued
+    // before it are sent, the same as its HOST_ID marker
+    if (keyboard->_nextHost == BLE_HOST_KEEP && uxQueueMessagesWaiting(keyboard->_reportQueue) == 0) {
+      uint8_t pending = keyboard->_pendingHost.exchange(BLE_HOST_KEEP);
+      if (pending != BLE_HOST_KEEP) {
+        keyboard->_nextHost = pending;
+        if (!keyboard->_sourceStarted)
+          keyboard->switchHost(keyboard->_nextHost);
+      }
+    }
+
+    // a source started on the outgoing host ends there before the switch,
+    // the reports queued after the switch wait for it
+    if (keyboard->_nextHost != BLE_HOST_KEEP && keyboard->_source == nullptr)
+      keyboard->switchHost(keyboard->_nextHost);
+    bool switching = keyboard->_nextHost != BLE_HOST_KEEP;
+
+    // queued reports go first, a playing source is polled without waiting
+    TickType_t wait = keyboard->_source != nullptr ? 0 : pdMS_TO_TICKS(CONN_POLL_MS);
+    bool received = !switching && xQueueReceive(keyboard->_reportQueue, &report, wait) == pdTRUE;
+    keyboard->updateConnection();
+    if (received) {
+      if (report.id == HOST_ID) {
+        keyboard->_nextHost = report.data[0];
+        if (!keyboard->_sourceStarted)
+          keyboard->switchHost(keyboard->_nextHost);
+      } else if (report.id != WAKE_ID) {
+        keyboard->sendQueued(report);
+      }
+    } else if (keyboard->_source != nullptr) {
+      keyboard->playNext();
+    }
+  }
+}
 
 uint8_t USBPutChar(uint8_t c);
 
@@ -500,10 +898,10 @@ size_t BleKeyboard::write(const uint8_t *buffer, size_t size) {
 }
 
 void BleKeyboard::onConnect(BLEServer* pServer) {
-  this->connected = true;
 
 #if !defined(USE_NIMBLE)
 
+  _hosts[0].handle = 0;
   BLE2902* desc = (BLE2902*)this->inputKeyboard->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
   desc->setNotifications(true);
   desc = (BLE2902*)this->inputMediaKeys->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
@@ -513,11 +911,76 @@ void BleKeyboard::onConnect(BLEServer* pServer) {
 
 }
 
+#if defined(USE_NIMBLE)
+// A known host gets its slot back, a new one takes a free slot or the
+// slot of a disconnected host. Advertising goes on while a slot is free.
+void BleKeyboard::onConnect(BLEServer* pServer, ble_gap_conn_desc* desc) {
+  const uint8_t* address = desc->peer_id_addr.val;
+  int8_t slot = -1;
+
+  portENTER_CRITICAL(&_connLock);
+  for (uint8_t host = 0; host < BLE_KEYBOARD_MAX_HOSTS && slot < 0; host++)
+    if (_hosts[host].handle == BLE_HOST_NONE && memcmp(_hosts[host].address, address, 6) == 0)
+      slot = host;
+  for (uint8_t host = 0; host < BLE_KEYBOARD_MAX_HOSTS && slot < 0; host++)
+    if (_hosts[host].handle == BLE_HOST_NONE)
+      slot = host;
+  if (slot >= 0) {
+    BleHost& host = _hosts[slot];
+    host.handle = desc->conn_handle;
+    memcpy(host.address, address, 6);
+    host.subscribed = 0;
+    host.mtu = BLE_ATT_DEFAULT_MTU;
+    host.policy.onConnect(desc->conn_itvl, desc->conn_latency);
+  }
+  portEXIT_CRITICAL(&_connLock);
+
+  if (slot >= 0 && _hosts[_activeHost].handle == BLE_HOST_NONE)
+    activateHost(slot);
+  if (getHostCount() < BLE_KEYBOARD_MAX_HOSTS)
+    advertising->start();
+}
+
+void BleKeyboard::onDisconnect(BLEServer* pServer, ble_gap_conn_desc* desc) {
+  int8_t slot = findHost(desc->conn_handle);
+  if (slot < 0)
+    return;
+
+  portENTER_CRITICAL(&_connLock);
+  _hosts[slot].handle = BLE_HOST_NONE;
+  _hosts[slot].subscribed = 0;
+  _hosts[slot].policy.onDisconnect();
+  portEXIT_CRITICAL(&_connLock);
+
+  // keep typing on another host if the active one left
+  if (slot == _activeHost)
+    nextHost();
+}
+
+void BleKeyboard::onSubscribe(BLECharacteristic* pCharacteristic, ble_gap_conn_desc* desc, uint16_t subValue) {
+  uint8_t bit = pCharacteristic == inputKeyboard ? 0x01 : pCharacteristic == inputMediaKeys ? 0x02 : 0;
+  int8_t slot = findHost(desc->conn_handle);
+  if (bit == 0 || slot < 0)
+    return;
+
+  portENTER_CRITICAL(&_connLock);
+  if (subValue)
+    _hosts[slot].subscribed |= bit;
+  else
+    _hosts[slot].subscribed &= ~bit;
+  portEXIT_CRITICAL(&_connLock);
+}
+#endif // USE_NIMBLE
+
 void BleKeyboard::onDisconnect(BLEServer* pServer) {
-  this->connected = false;
 
 #if !defined(USE_NIMBLE)
 
+  _hosts[0].handle = BLE_HOST_NONE;
+  portENTER_CRITICAL(&_connLock);
+  _hosts[0].policy.onDisconnect();
+  portEXIT_CRITICAL(&_connLock);
+
   BLE2902* desc = (BLE2902*)this->inputKeyboard->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
   desc->setNotifications(false);
   desc = (BLE2902*)this->inputMediaKeys->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
@@ -528,19 +991,47 @@ void BleKeyboard::onDisconnect(BLEServer* pServer) {
 #endif // !USE_NIMBLE
 }
 
+#if defined(USE_NIMBLE)
+void BleKeyboard::onStatus(BLECharacteristic* pCharacteristic, Status s, int code) {
+  if (pCharacteristic != inputKeyboard && pCharacteristic != inputMediaKeys)
+    return;
+  // BLE_HS_ENOMEM means the host stack is out of buffers, the link is congested
+  _notifyFailed = s != Status::SUCCESS_NOTIFY;
+  xSemaphoreGive(_notifySemaphore);
+}
+
+void BleKeyboard::onMTUChange(uint16_t MTU, ble_gap_conn_desc* desc) {
+  int8_t slot = findHost(desc->conn_handle);
+  if (slot >= 0)
+    _hosts[slot].mtu = MTU;
+}
+#endif // USE_NIMBLE
+
 void BleKeyboard::onWrite(BLECharacteristic* me) {
+  if (me == outputFeedback) {
+#if !defined(USE_NIMBLE)
+    receiveFeedback(me);
+#endif // !USE_NIMBLE
+    return;
+  }
+
   uint8_t* value = (uint8_t*)(me->getValue().c_str());
   (void)value;
   ESP_LOGI(LOG_TAG, "special keys: %d", *value);
 }
 
-void BleKeyboard::delay_ms(uint64_t ms) {
-  uint64_t m = esp_timer_get_time();
-  if(ms){
-    uint64_t e = (m + (ms * 1000));
-    if(m > e){ //overflow
-        while(esp_timer_get_time() > e) { }
-    }
-    while(esp_timer_get_time() < e) {}
+#if defined(USE_NIMBLE)
+// Only the active host state is shown, data is taken from any host so
+// the monitor keeps running while typing on another computer, the
+// application decides what a host other than the active one may send
+void BleKeyboard::onWrite(BLECharacteristic* me, ble_gap_conn_desc* desc) {
+  if (me == outputFeedback && desc->conn_handle == _hosts[_activeHost].handle)
+    receiveFeedback(me);
+  if (me == dataRx && _dataCallback != nullptr) {
+    int8_t slot = findHost(desc->conn_handle);
+    if (slot < 0) return;
+    auto value = me->getValue();
+    _dataCallback(slot, value.data(), value.length());
   }
-}
\ No newline at end of file
+}
+#endif // USE_NIMBLE
@@ -27,12 +27,35 @@
 #endif // USE_NIMBLE
 
 #include "Print.h"
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "BleConnectionPolicy.h"
 
 #define BLE_KEYBOARD_VERSION "0.0.4"
 #define BLE_KEYBOARD_VERSION_MAJOR 0
 #define BLE_KEYBOARD_VERSION_MINOR 0
 #define BLE_KEYBOARD_VERSION_REVISION 4
 
+//  Report latency histogram, bucket n counts latencies below
+//  BleKeyboard::LATENCY_LIMITS_US[n], the last bucket counts the remaining ones
+#define BLE_LATENCY_BUCKETS 8
+
+// Hosts connected at once, reports go to the active one
+#if defined(USE_NIMBLE)
+#define BLE_KEYBOARD_MAX_HOSTS CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#else
+#define BLE_KEYBOARD_MAX_HOSTS 1
+#endif // USE_NIMBLE
+#define BLE_HOST_NONE 0xFFFF
+#define BLE_HOST_KEEP 0xFF
+
+// Data service, the computer writes bytes without response on the RX characteristic
+#define BLE_DATA_SERVICE_UUID "90bc52b6-eabf-4f2a-a557-bba3abf28c6b"
+#define BLE_DATA_RX_UUID      "90bc52b7-eabf-4f2a-a557-bba3abf28c6b"
+#define BLE_ATT_DEFAULT_MTU   23
+
 const uint8_t KEY_LEFT_CTRL = 0x80;
 const uint8_t KEY_LEFT_SHIFT = 0x81;
 const uint8_t KEY_LEFT_ALT = 0x82;
@@ -128,6 +151,53 @@ typedef struct
   uint8_t keys[6];
 } KeyReport;
 
+//  Report waiting on the output queue
+typedef struct
+{
+  uint8_t id;
+  uint8_t size;
+  uint8_t data[sizeof(KeyReport)];
+  int64_t queued_us;
+} HidReport;
+
+//  Report generated by a BleReportSource
+typedef struct
+{
+  bool media;
+  uint8_t data[sizeof(KeyReport)];
+  uint32_t delay_ms;  // wait before sending
+} BleSourceReport;
+
+//  Reports played by the sender task, see BleKeyboard::play()
+class BleReportSource
+{
+public:
+  virtual ~BleReportSource() {}
+  // Next report to send, false at the end
+  virtual bool next(BleSourceReport& report) = 0;
+};
+
+//  Paired host, the slot and its address are kept after disconnect so the
+//  host gets the same slot when it reconnects
+typedef struct
+{
+  uint16_t handle;      // connection handle, BLE_HOST_NONE when disconnected
+  uint8_t address[6];   // identity address, all zero if the slot was never used
+  uint8_t subscribed;   // bit 0 keyboard report, bit 1 media keys report
+  uint16_t mtu;         // ATT MTU negotiated by the host
+  BleConnectionPolicy policy;
+} BleHost;
+
+//  Called with the state written by the computer on the feedback report
+typedef void (*BleFeedbackCallback)(uint8_t state, uint8_t mask);
+
+//  Called with the bytes written by the computer on the data service,
+//  host is the slot of the writer, compare with getActiveHost()
+typedef void (*BleDataCallback)(uint8_t host, const uint8_t* data, size_t size);
+
+//  Called when the queued reports and the playing source are all sent
+typedef void (*BleSentCallback)(void);
+
 class BleKeyboard : public Print, public BLEServerCallbacks, public BLECharacteristicCallbacks
 {
 private:
@@ -135,15 +205,56 @@ private:
   BLECharacteristic* inputKeyboard;
   BLECharacteristic* outputKeyboard;
   BLECharacteristic* inputMediaKeys;
+  BLECharacteristic* outputFeedback;
+  BLECharacteristic* dataRx = nullptr;
   BLEAdvertising*    advertising;
   KeyReport          _keyReport;
   MediaKeyReport     _mediaKeyReport;
   std::string        deviceName;
   std::string        deviceManufacturer;
   uint8_t            batteryLevel;
-  bool               connected = false;
   uint32_t           _delay_ms = 7;
-  void delay_ms(uint64_t ms);
+  uint32_t           _queue_timeout_ms = 100;
+  QueueHandle_t      _reportQueue = nullptr;
+  SemaphoreHandle_t  _notifySemaphore = nullptr;
+  SemaphoreHandle_t  _sentSemaphore = nullptr;
+  TaskHandle_t       _senderTask = nullptr;
+  volatile bool      _notifyFailed = false;
+  std::atomic<uint32_t> _queued{0};
+  std::atomic<uint32_t> _sent{0};
+  uint32_t           _dropped = 0;
+  uint32_t           _congestions = 0;
+  int64_t            _lastLatencyUs = 0;
+  int64_t            _maxLatencyUs = 0;
+  BleHost            _hosts[BLE_KEYBOARD_MAX_HOSTS];
+  volatile uint8_t   _activeHost = 0;  // host selected by the application
+  volatile uint8_t   _sendHost = 0;    // host notified by the sender task
+  uint8_t            _nextHost = BLE_HOST_KEEP; // switch waiting the source of the outgoing host
+  std::atomic<uint8_t> _pendingHost{BLE_HOST_KEEP}; // switch activateHost could not queue
+  int64_t            _switchStartUs = 0;
+  int64_t            _lastSwitchUs = 0;
+  int64_t            _maxSwitchUs = 0;
+  BleFeedbackCallback _feedbackCallback = nullptr;
+  BleDataCallback    _dataCallback = nullptr;
+  BleSentCallback    _sentCallback = nullptr;
+  portMUX_TYPE       _connLock = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t           _latencyHistogram[BLE_LATENCY_BUCKETS] = {};
+  std::atomic<BleReportSource*> _source{nullptr};
+  bool               _sourceStarted = false; // first report of the source was sent
+  int64_t            _sourceStartUs = 0;
+  int64_t            _sourceTimeUs = 0;
+  void queueReport(uint8_t id, const uint8_t* data, uint8_t size);
+  bool notifyReport(const HidReport& report);
+  void sendQueued(const HidReport& report);
+  void playNext(void);
+  void allSent(void);
+  void updateConnection(void);
+  int8_t findHost(uint16_t handle);
+  void activateHost(uint8_t host);
+  bool postHost(uint8_t host, uint32_t timeout_ms);
+  void switchHost(uint8_t host);
+  void receiveFeedback(BLECharacteristic* me);
+  static void senderTask(void* arg);
 
   uint16_t vid       = 0x05ac;
   uint16_t pid       = 0x820a;
@@ -167,6 +278,38 @@ public:
   void setBatteryLevel(uint8_t level);
   void setName(std::string deviceName);  
   void setDelay(uint32_t ms);
+  void setQueueTimeout(uint32_t ms);
+  bool waitSent(uint32_t ms);
+  bool play(BleReportSource* source);
+  bool isPlaying(void);
+  int64_t getLastPlayTime(void);
+  uint32_t getSentCount(void);
+  uint32_t getDroppedCount(void);
+  uint32_t getCongestionCount(void);
+  int64_t getLastLatency(void);
+  int64_t getMaxLatency(void);
+  void getLatencyHistogram(uint32_t* buckets);
+  void resetLatencyHistogram(void);
+  void setActive(void);
+  void setIdle(void);
+  BleConnectionPolicy::Mode getConnMode(void);
+  uint16_t getConnInterval(void);
+  uint16_t getConnLatency(void);
+  uint32_t getConnRequests(void);
+  uint32_t getConnRejected(void);
+  uint8_t getHostCount(void);
+  uint8_t getActiveHost(void);
+  bool isHostConnected(uint8_t host);
+  bool selectHost(uint8_t host);
+  bool nextHost(void);
+  int64_t getLastSwitchLatency(void);
+  int64_t getMaxSwitchLatency(void);
+  void onFeedback(BleFeedbackCallback callback);
+  void onData(BleDataCallback callback);
+  void onSent(BleSentCallback callback);
+  uint16_t getMtu(void);
+
+  static const uint32_t LATENCY_LIMITS_US[BLE_LATENCY_BUCKETS - 1];
 
   void set_vendor_id(uint16_t vid);
   void set_product_id(uint16_t pid);
@@ -176,6 +319,14 @@ protected:
   virtual void onConnect(BLEServer* pServer) override;
   virtual void onDisconnect(BLEServer* pServer) override;
   virtual void onWrite(BLECharacteristic* me) override;
+#if defined(USE_NIMBLE)
+  virtual void onConnect(BLEServer* pServer, ble_gap_conn_desc* desc) override;
+  virtual void onDisconnect(BLEServer* pServer, ble_gap_conn_desc* desc) override;
+  virtual void onWrite(BLECharacteristic* me, ble_gap_conn_desc* desc) override;
+  virtual void onSubscribe(BLECharacteristic* pCharacteristic, ble_gap_conn_desc* desc, uint16_t subValue) override;
+  virtual void onStatus(BLECharacteristic* pCharacteristic, Status s, int code) override;
+  virtual void onMTUChange(uint16_t MTU, ble_gap_conn_desc* desc) override;
+#endif // USE_NIMBLE
 
 };
 
@@ -0,0 +1,143 @@
+#ifndef ESP32_BLE_KEYBOARD_ASCII_MAP_H
+#define ESP32_BLE_KEYBOARD_ASCII_MAP_H
+
+#include <stdint.h>
+
+//  ASCII to HID usage map of press() and release(), characters typed with
+//  shift have ASCII_SHIFT set. constexpr so reports can also be built at
+//  compile time from the same map, see streamDeco_chord.hpp.
+inline constexpr uint8_t ASCII_SHIFT = 0x80;
+
+inline constexpr uint8_t _asciimap[128] =
+{
+  0x00,              // NUL
+  0x00,              // SOH
+  0x00,              // STX
+  0x00,              // ETX
+  0x00,              // EOT
+  0x00,              // ENQ
+  0x00,              // ACK
+  0x00,              // BEL
+  0x2a,              // BS Backspace
+  0x2b,              // TAB Tab
+  0x28,              // LF Enter
+  0x00,              // VT
+  0x00,              // FF
+  0x00,              // CR
+  0x00,              // SO
+  0x00,              // SI
+  0x00,              // DEL
+  0x00,              // DC1
+  0x00,              // DC2
+  0x00,              // DC3
+  0x00,              // DC4
+  0x00,              // NAK
+  0x00,              // SYN
+  0x00,              // ETB
+  0x00,              // CAN
+  0x00,              // EM
+  0x00,              // SUB
+  0x00,              // ESC
+  0x00,              // FS
+  0x00,              // GS
+  0x00,              // RS
+  0x00,              // US
+  0x2c,              // ' '
+  0x1e|ASCII_SHIFT,  // !
+  0x34|ASCII_SHIFT,  // "
+  0x20|ASCII_SHIFT,  // #
+  0x21|ASCII_SHIFT,  // $
+  0x22|ASCII_SHIFT,  // %
+  0x24|ASCII_SHIFT,  // &
+  0x34,              // '
+  0x26|ASCII_SHIFT,  // (
+  0x27|ASCII_SHIFT,  // )
+  0x25|ASCII_SHIFT,  // *
+  0x2e|ASCII_SHIFT,  // +
+  0x36,              // ,
+  0x2d,              // -
+  0x37,              // .
+  0x38,              // /
+  0x27,              // 0
+  0x1e,              // 1
+  0x1f,              // 2
+  0x20,              // 3
+  0x21,              // 4
+  0x22,              // 5
+  0x23,              // 6
+  0x24,              // 7
+  0x25,              // 8
+  0x26,              // 9
+  0x33|ASCII_SHIFT,  // :
+  0x33,              // ;
+  0x36|ASCII_SHIFT,  // <
+  0x2e,              // =
+  0x37|ASCII_SHIFT,  // >
+  0x38|ASCII_SHIFT,  // ?
+  0x1f|ASCII_SHIFT,  // @
+  0x04|ASCII_SHIFT,  // A
+  0x05|ASCII_SHIFT,  // B
+  0x06|ASCII_SHIFT,  // C
+  0x07|ASCII_SHIFT,  // D
+  0x08|ASCII_SHIFT,  // E
+  0x09|ASCII_SHIFT,  // F
+  0x0a|ASCII_SHIFT,  // G
+  0x0b|ASCII_SHIFT,  // H
+  0x0c|ASCII_SHIFT,  // I
+  0x0d|ASCII_SHIFT,  // J
+  0x0e|ASCII_SHIFT,  // K
+  0x0f|ASCII_SHIFT,  // L
+  0x10|ASCII_SHIFT,  // M
+  0x11|ASCII_SHIFT,  // N
+  0x12|ASCII_SHIFT,  // O
+  0x13|ASCII_SHIFT,  // P
+  0x14|ASCII_SHIFT,  // Q
+  0x15|ASCII_SHIFT,  // R
+  0x16|ASCII_SHIFT,  // S
+  0x17|ASCII_SHIFT,  // T
+  0x18|ASCII_SHIFT,  // U
+  0x19|ASCII_SHIFT,  // V
+  0x1a|ASCII_SHIFT,  // W
+  0x1b|ASCII_SHIFT,  // X
+  0x1c|ASCII_SHIFT,  // Y
+  0x1d|ASCII_SHIFT,  // Z
+  0x2f,              // [
+  0x31,              // bslash
+  0x30,              // ]
+  0x23|ASCII_SHIFT,  // ^
+  0x2d|ASCII_SHIFT,  // _
+  0x35,              // `
+  0x04,              // a
+  0x05,              // b
+  0x06,              // c
+  0x07,              // d
+  0x08,              // e
+  0x09,              // f
+  0x0a,              // g
+  0x0b,              // h
+  0x0c,              // i
+  0x0d,              // j
+  0x0e,              // k
+  0x0f,              // l
+  0x10,              // m
+  0x11,              // n
+  0x12,              // o
+  0x13,              // p
+  0x14,              // q
+  0x15,              // r
+  0x16,              // s
+  0x17,              // t
+  0x18,              // u
+  0x19,              // v
+  0x1a,              // w
+  0x1b,              // x
+  0x1c,              // y
+  0x1d,              // z
+  0x2f|ASCII_SHIFT,  // {
+  0x31|ASCII_SHIFT,  // |
+  0x30|ASCII_SHIFT,  // }
+  0x35|ASCII_SHIFT,  // ~
+  0x00               // DEL
+};
+
+#endif // ESP32_BLE_KEYBOARD_ASCII_MAP_H
@@ -145,6 +145,46 @@
  */
 // #define CONFIG_NIMBLE_STACK_USE_MEM_POOLS 1
 
+/**
+ * @brief Define NIMBLE_HID_PERIPHERAL_ONLY (build flag) for a peripheral HID device.
+ * @details Client and scan roles are removed, two hosts can be connected and the pools\n
+ * are sized for a few short notifications, leaving internal SRAM to the application.\n
+ * Options defined by the build flags are kept.
+ */
+#ifdef NIMBLE_HID_PERIPHERAL_ONLY
+#  ifndef CONFIG_BT_NIMBLE_ROLE_CENTRAL_DISABLED
+#    define CONFIG_BT_NIMBLE_ROLE_CENTRAL_DISABLED
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_ROLE_OBSERVER_DISABLED
+#    define CONFIG_BT_NIMBLE_ROLE_OBSERVER_DISABLED
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#    define CONFIG_BT_NIMBLE_MAX_CONNECTIONS 2
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_MAX_BONDS
+#    define CONFIG_BT_NIMBLE_MAX_BONDS 2
+#  endif
+/* keyboard, media keys and battery level reports of each bond */
+#  ifndef CONFIG_BT_NIMBLE_MAX_CCCDS
+#    define CONFIG_BT_NIMBLE_MAX_CCCDS 6
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_ATT_PREFERRED_MTU
+#    define CONFIG_BT_NIMBLE_ATT_PREFERRED_MTU 64
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_MSYS1_BLOCK_COUNT
+#    define CONFIG_BT_NIMBLE_MSYS1_BLOCK_COUNT 8
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_ACL_BUF_COUNT
+#    define CONFIG_BT_NIMBLE_ACL_BUF_COUNT 6
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_HCI_EVT_HI_BUF_COUNT
+#    define CONFIG_BT_NIMBLE_HCI_EVT_HI_BUF_COUNT 12
+#  endif
+#  ifndef CONFIG_BT_NIMBLE_HOST_TASK_STACK_SIZE
+#    define CONFIG_BT_NIMBLE_HOST_TASK_STACK_SIZE 3584
+#  endif
+#endif // NIMBLE_HID_PERIPHERAL_ONLY
+
 /**********************************
  End Arduino user-config
 **********************************/
@@ -231,7 +271,9 @@
 #define CONFIG_BT_NIMBLE_GAP_DEVICE_NAME_MAX_LEN 31
 
 /** @brief ACL Buffer count */
+#ifndef CONFIG_BT_NIMBLE_ACL_BUF_COUNT
 #define CONFIG_BT_NIMBLE_ACL_BUF_COUNT 12
+#endif
 
 /** @brief ACL Buffer size */
 #define CONFIG_BT_NIMBLE_ACL_BUF_SIZE 255
@@ -244,7 +286,9 @@
 #endif
 
 /** @brief Number of high priority HCI event buffers */
+#ifndef CONFIG_BT_NIMBLE_HCI_EVT_HI_BUF_COUNT
 #define CONFIG_BT_NIMBLE_HCI_EVT_HI_BUF_COUNT 30
+#endif
 
 /** @brief Number of low priority HCI event buffers */
 #define CONFIG_BT_NIMBLE_HCI_EVT_LO_BUF_COUNT 8
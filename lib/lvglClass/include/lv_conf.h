@@ -49,7 +49,10 @@
 #define LV_MEM_CUSTOM 0
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
+    /*Native builds have 64-bit pointers, their objects are larger and set it from build flags*/
+    #ifndef LV_MEM_SIZE
     #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
+    #endif
 
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #define LV_MEM_ADR 0     /*0: unused*/
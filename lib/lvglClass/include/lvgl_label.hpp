@@ -28,10 +28,74 @@
 #include "lvgl_color.hpp"
 #include "esp_heap_caps.h"
 #include "stdio.h"
+#include "string.h"
 
 namespace lvgl
 {
 
+  namespace text
+  {
+
+    /**
+     * @brief  Fixed size text builder, lives on the caller stack
+     * @details Integer and string pieces are appended without printf,
+     *          text longer than SIZE - 1 is truncated
+     * @code
+     * lvgl::text::Buffer<32> text;
+     * text.append("RAM: ").append(value).append(" MB");
+     * label.set_text(text.c_str());
+     */
+    template <size_t SIZE>
+    class Buffer
+    {
+    public:
+      Buffer() { buffer[0] = '\0'; }
+
+      Buffer &append(const char *text)
+      {
+        if (text == nullptr)
+          return *this;
+        while (*text != '\0' && length < SIZE - 1)
+          buffer[length++] = *text++;
+        buffer[length] = '\0';
+        return *this;
+      }
+
+      Buffer &append(char character)
+      {
+        if (length < SIZE - 1)
+          buffer[length++] = character;
+        buffer[length] = '\0';
+        return *this;
+      }
+
+      Buffer &append(int32_t value)
+      {
+        char digits[12];
+        int count = 0;
+        uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+        do
+        {
+          digits[count++] = '0' + magnitude % 10;
+          magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0)
+          digits[count++] = '-';
+        while (count > 0)
+          append(digits[--count]);
+        return *this;
+      }
+
+      const char *c_str() const { return buffer; }
+      size_t size() const { return length; }
+
+    private:
+      char buffer[SIZE];
+      size_t length = 0;
+    }; // class Buffer
+
+  } // namespace text
+
   class Label : public Object
   {
 
@@ -81,13 +145,14 @@ namespace lvgl
      * the label.
      * @param text          '\0' terminated character string. nullptr to refresh with
      * the current text.
+     * @note  Same text as the current one is ignored, nothing is reallocated or redrawn
      */
     void set_text(const char *text)
     {
       if (object == nullptr)
         return;
       port::mutex_take();
-      lv_label_set_text(object, text);
+      set_text_locked(text);
       port::mutex_give();
     }
 
@@ -96,23 +161,49 @@ namespace lvgl
      * text by the label.
      * @param fmt           `printf`-like format
      * @example lv_label_set_text_fmt(label1, "%d user", user_num);
+     * @note  Formatted on a stack buffer, the label storage is reused by LVGL
+     *        when the length fits. Only text longer than fmt_buffer_size uses the heap
      */
     void set_text_fmt(const char *fmt, ...)
     {
       if (object == nullptr)
         return;
+      char buffer[fmt_buffer_size];
       va_list args;
       va_start(args, fmt);
-      int size = vsnprintf(nullptr, 0, fmt, args);
+      int size = vsnprintf(buffer, sizeof(buffer), fmt, args);
       va_end(args);
-      char *buffer = (char *)heap_caps_malloc(size + 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+      if (size < 0)
+        return;
+      if (static_cast<size_t>(size) < sizeof(buffer))
+      {
+        set_text(buffer);
+        return;
+      }
+      char *heap_buffer = (char *)heap_caps_malloc(size + 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+      if (heap_buffer == nullptr)
+        return;
       va_start(args, fmt);
-      vsnprintf(buffer, size + 1, fmt, args);
+      vsnprintf(heap_buffer, size + 1, fmt, args);
       va_end(args);
-      port::mutex_take();
-      lv_label_set_text(object, buffer);
-      heap_caps_free(buffer);
-      port::mutex_give();
+      set_text(heap_buffer);
+      heap_caps_free(heap_buffer);
+    }
+
+    /**
+     * Set a text made of prefix, integer value and sufix, without printf
+     * @param prefix  Text before value, can be nullptr
+     * @param value   Integer value
+     * @param sufix   Text after value, can be nullptr
+     * @example label.set_text_int("RAM: ", 1024, " MB");
+     */
+    void set_text_int(const char *prefix, int32_t value, const char *sufix = nullptr)
+    {
+      if (object == nullptr)
+        return;
+      text::Buffer<fmt_buffer_size> buffer;
+      buffer.append(prefix).append(value).append(sufix);
+      set_text(buffer.c_str());
     }
 
     /**
@@ -380,6 +471,26 @@ namespace lvgl
       lv_obj_set_local_style_prop(object, LV_STYLE_TEXT_ALIGN, v, 0);
       port::mutex_give();
     }
+
+  private:
+    /**
+     * @brief  Stack buffer size used to format label text
+     */
+    static constexpr size_t fmt_buffer_size = 64;
+
+    /**
+     * @brief  Set text with LVGL mutex taken, skip if text didn't change
+     */
+    void set_text_locked(const char *text)
+    {
+      if (text != nullptr)
+      {
+        const char *current = lv_label_get_text(object);
+        if (current != nullptr && strcmp(current, text) == 0)
+          return;
+      }
+      lv_label_set_text(object, text);
+    }
   };
 
 } // namespace lvgl
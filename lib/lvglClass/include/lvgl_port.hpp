@@ -24,6 +24,30 @@
 
 #include <lvgl.h>
 
+/**
+ * @brief    Render modes selected by LVGL_RENDER_MODE board define
+ * @details  LVGL_RENDER_MODE_PARTIAL  Two LVGL_BUFFER_PIXELS draw buffers allocated
+ *                                     with LVGL_BUFFER_MALLOC_FLAGS, dirty areas are
+ *                                     copied to the panel framebuffer
+ *           LVGL_RENDER_MODE_STRIPE   Two DISPLAY_WIDTH * LVGL_STRIPE_LINES draw buffers
+ *                                     in internal DMA capable SRAM, the panel can use
+ *                                     bounce buffers with ST7262_PANEL_CONFIG_BOUNCE_BUFFER_SIZE_PX
+ */
+#define LVGL_RENDER_MODE_PARTIAL 0
+#define LVGL_RENDER_MODE_STRIPE 1
+
+#ifndef LVGL_RENDER_MODE
+#define LVGL_RENDER_MODE LVGL_RENDER_MODE_PARTIAL
+#endif
+
+#ifndef LVGL_STRIPE_LINES
+#define LVGL_STRIPE_LINES 20
+#endif
+
+#ifndef CONFIG_ESP_LCD_TOUCH_MAX_POINTS
+#define CONFIG_ESP_LCD_TOUCH_MAX_POINTS 1
+#endif
+
 namespace lvgl
 {
 
@@ -74,6 +98,65 @@ namespace lvgl
          */
         void mutex_give();
 
+        /**
+         * @struct   lock_stats_s
+         * @typedef  lock_stats_t
+         * @brief    LVGL mutex counters
+         */
+        typedef struct lock_stats_s
+        {
+            uint32_t acquisitions; /* outermost takes, the mutex was really acquired */
+            uint32_t takes;        /* all takes, including recursive ones */
+        } lock_stats_t;
+
+        /**
+         * @brief    Wake LVGL task
+         * @details  LVGL task sleeps until its next timer, widget changes made
+         *           with the mutex already wake it when the mutex is released
+         */
+        void wake();
+
+        /**
+         * @brief    Get LVGL mutex counters
+         * @note     Read without taking the mutex, use for benchmarking only
+         */
+        lock_stats_t get_lock_stats();
+
+        /**
+         * @class    Batch
+         * @brief    Hold LVGL mutex for a whole group of widget updates
+         * @details  Widgets take the recursive mutex again inside the scope
+         *           without blocking, lv_timer_handler can't run in the middle
+         *           of the group so its invalidated areas are refreshed together
+         * @code
+         * {
+         *   lvgl::port::Batch batch;
+         *   label.set_text("text");
+         *   bar.set_value(10, lvgl::animation::OFF);
+         * } // mutex released here
+         */
+        class Batch
+        {
+        public:
+            Batch()
+            {
+                mutex_take();
+                start_takes = get_lock_stats().takes;
+            }
+            ~Batch() { mutex_give(); }
+            Batch(const Batch &) = delete;
+            Batch &operator=(const Batch &) = delete;
+
+            /**
+             * @brief   Mutex takes nested inside this batch
+             * @details Each one would be a separate acquisition without the batch
+             */
+            uint32_t takes() const { return get_lock_stats().takes - start_takes; }
+
+        private:
+            uint32_t start_takes = 0;
+        }; // class Batch
+
         /**
          * @brief   Set screen rotations
          * @param   rotation An lv_disp_rot_t type
@@ -100,6 +183,153 @@ namespace lvgl
          */
         void print_task_memory_usage();
 
+        /**
+         * @struct   render_stats_s
+         * @typedef  render_stats_t
+         * @brief    Display refresh counters
+         * @details  Updated by LVGL at the end of each display refresh
+         */
+        typedef struct render_stats_s
+        {
+            uint32_t refreshes;   /* number of refreshes with invalidated areas */
+            uint64_t pixels;      /* sum of invalidated pixels redrawn */
+            uint32_t time_ms;     /* sum of refresh time */
+            uint32_t flushes;     /* number of flush calls */
+            uint64_t flush_us;    /* sum of time from flush call to flush ready */
+            int64_t elapsed_us;   /* time since the counters were cleared */
+        } render_stats_t;
+
+        /**
+         * @struct   task_stats_s
+         * @typedef  task_stats_t
+         * @brief    LVGL task counters
+         */
+        typedef struct task_stats_s
+        {
+            uint32_t wakeups;   /* lv_timer_handler calls */
+            uint64_t busy_us;   /* sum of time inside lv_timer_handler */
+            int64_t elapsed_us; /* time since the counters were cleared */
+        } task_stats_t;
+
+        /**
+         * @brief    LVGL task wakeup limits
+         * @details  The task sleeps until the next LVGL timer is ready or a
+         *           notification arrives, bounded by these periods
+         */
+        constexpr uint32_t task_period_min_ms = 5;
+        constexpr uint32_t task_period_max_ms = 1000;
+
+        /**
+         * @brief    Get LVGL task counters
+         */
+        task_stats_t get_task_stats();
+
+        /**
+         * @brief    Clear LVGL task counters
+         */
+        void reset_task_stats();
+
+        /**
+         * @brief    LVGL task wakeups per second
+         */
+        inline float task_wakeups_rate(const task_stats_t &stats)
+        {
+            return stats.elapsed_us > 0 ? stats.wakeups * 1000000.0f / stats.elapsed_us : 0.0f;
+        }
+
+        /**
+         * @brief    Part of time the LVGL task was running, 0 to 1
+         */
+        inline float task_duty(const task_stats_t &stats)
+        {
+            return stats.elapsed_us > 0 ? static_cast<float>(stats.busy_us) / stats.elapsed_us : 0.0f;
+        }
+
+        /**
+         * @brief    Maximum touch points read from touch controller
+         */
+        constexpr uint8_t touch_max_points = CONFIG_ESP_LCD_TOUCH_MAX_POINTS;
+
+        /**
+         * @struct   touch_points_s
+         * @typedef  touch_points_t
+         * @brief    Touch points of one touch controller read
+         * @details  Points are in display coordinates, LVGL input uses only the first one
+         */
+        typedef struct touch_points_s
+        {
+            int64_t timestamp_us; /* time of the touch interrupt */
+            int64_t read_us;      /* time LVGL input read the sample */
+            uint8_t count;        /* number of valid points */
+            struct
+            {
+                uint16_t x;
+                uint16_t y;
+                uint16_t strength;
+            } point[touch_max_points];
+        } touch_points_t;
+
+        /**
+         * @brief    Touch latency histogram upper limits in microseconds
+         * @details  From touch interrupt to LVGL input read, last bucket has no limit
+         */
+        constexpr size_t touch_latency_buckets = 6;
+        constexpr int64_t touch_latency_limits_us[touch_latency_buckets - 1] = {1000, 5000, 10000, 20000, 50000};
+
+        /**
+         * @struct   touch_stats_s
+         * @typedef  touch_stats_t
+         * @brief    Touch counters
+         */
+        typedef struct touch_stats_s
+        {
+            uint32_t interrupts; /* touch controller interrupts */
+            uint32_t reads;      /* touch controller I2C reads */
+            uint32_t dropped;    /* samples lost because LVGL didn't read them in time */
+            uint32_t latency[touch_latency_buckets];
+        } touch_stats_t;
+
+        /**
+         * @brief    Get last touch points delivered to LVGL
+         * @return   true while the screen is touched
+         * @note     All points are available to gestures, not only the first
+         */
+        bool get_touch_points(touch_points_t &points);
+
+        /**
+         * @brief    Get touch counters
+         */
+        touch_stats_t get_touch_stats();
+
+        /**
+         * @brief    Clear touch counters
+         */
+        void reset_touch_stats();
+
+        /**
+         * @brief    Render mode built in this port
+         * @return   LVGL_RENDER_MODE_PARTIAL or LVGL_RENDER_MODE_STRIPE
+         */
+        int render_mode();
+
+        /**
+         * @brief    Refreshes per second of the counters
+         */
+        inline float render_fps(const render_stats_t &stats)
+        {
+            return stats.elapsed_us > 0 ? stats.refreshes * 1000000.0f / stats.elapsed_us : 0.0f;
+        }
+
+        /**
+         * @brief    Get display refresh counters
+         */
+        render_stats_t get_render_stats();
+
+        /**
+         * @brief    Clear display refresh counters
+         */
+        void reset_render_stats();
+
     } // namespace port
 
 } // namespace lvgl
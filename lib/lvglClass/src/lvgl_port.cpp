@@ -23,6 +23,7 @@
 #include "const_user.hpp"
 
 #include "rtos_mutex_static.hpp"
+#include "rtos_semaphore_static.hpp"
 #include "rtos_task_static.hpp"
 
 #include "driver/ledc.h"
@@ -38,6 +39,9 @@
 #include "driver/i2c.h"
 
 #include "esp_log.h"
+#include "esp_idf_version.h"
+
+#include <atomic>
 
 namespace lvgl
 {
@@ -45,13 +49,6 @@ namespace lvgl
   namespace port
   {
 
-    /**
-     * @brief    Enable or disable port testing features
-     * @details  Uses display buffer transfer done callback to notify LVGL
-     * @note     Don't working yet
-     */
-    #define PORT_TESTING 0
-
     /**
      * @brief    Use simple backlight control for testing
      * @details  Set backlight pin high to enable backlight without PWM
@@ -66,6 +63,17 @@ namespace lvgl
      */
     const char *log_tag = "LVGL PORT";
 
+    /**
+     * @brief    LVGL draw buffer size and memory capabilities of render mode
+     */
+#if LVGL_RENDER_MODE == LVGL_RENDER_MODE_STRIPE
+    constexpr size_t draw_buffer_pixels = DISPLAY_WIDTH * LVGL_STRIPE_LINES;
+    constexpr uint32_t draw_buffer_caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+#else
+    constexpr size_t draw_buffer_pixels = LVGL_BUFFER_PIXELS;
+    constexpr uint32_t draw_buffer_caps = LVGL_BUFFER_MALLOC_FLAGS;
+#endif
+
     /**
      * @brief    LVGL mutex
      * @details  This mutex prevents display alterations while internal timer are processed
@@ -73,11 +81,34 @@ namespace lvgl
      */
     static rtos::MutexRecursiveStatic mutex;
 
+    /**
+     * @brief    LVGL mutex counters
+     * @details  Only changed by the mutex holder
+     */
+    static lock_stats_t lock_stats = {};
+    static uint32_t lock_depth = 0;
+
     /**
      * @brief    LVGL task
      * @details  Task to handle LVGL timer
      */
     static rtos::TaskStatic<4_kB> task("Port task LVGL", 3);
+    static TaskHandle_t task_id = nullptr;
+
+    /**
+     * @brief    Touchpad read period while nobody touches the screen
+     * @details  After touch_idle_ms released the read timer slows down,
+     *           the first touch returns it to LV_INDEV_DEF_READ_PERIOD
+     */
+    constexpr uint32_t touch_idle_ms = 2000;
+    constexpr uint32_t touch_idle_read_period_ms = 200;
+
+    /**
+     * @brief    LVGL task counters
+     * @details  Written by LVGL task
+     */
+    static task_stats_t task_stats = {};
+    static int64_t task_stats_start = 0;
 
     /**
      * @brief    Pointer to backlight PWM channel configurations
@@ -100,19 +131,12 @@ namespace lvgl
       return (unsigned long) (esp_timer_get_time() / 1000UL);
     }
 
-#if PORT_TESTING
     /**
-     * @brief    Display flush done
-     * @details  Indicate to LVGL that previous framebuffer is free to be used again
-     * */
-    bool display_transfer_done(esp_lcd_panel_handle_t panel_io, esp_lcd_rgb_panel_event_data_t *edata, void *user_data)
-    {
-      lv_disp_drv_t *lvgl_display_driver = static_cast<lv_disp_drv_t *>(user_data);
-      if(lvgl_display_driver == nullptr) return 0;
-      lv_disp_flush_ready(lvgl_display_driver);
-      return false;
-    }
-#endif
+     * @brief    Display refresh counters
+     * @details  Written on LVGL task with mutex taken
+     */
+    static render_stats_t render_stats = {};
+    static int64_t render_stats_start = 0;
 
     /**
      * @brief    Display flush
@@ -120,22 +144,225 @@ namespace lvgl
      * @note     The framebuffer is provided by LVGL and should be ready to be sent to display after this function is called,
      *           the framebuffer will be used by LVGL again to draw the next screen,
      *           so this function must not free or alter the framebuffer,
-     *           just send it to display and call lv_disp_flush_ready() when done 
+     *           just send it to display and call lv_disp_flush_ready() when done
      * */
     static void display_flush(lv_disp_drv_t *lvgl_display_driver, const lv_area_t *area, lv_color_t *framebuffer)
     {
       // get esp display handle from LVGL display driver user data
       const esp_lcd_panel_handle_t esp_display_handle = static_cast<const esp_lcd_panel_handle_t>(lvgl_display_driver->user_data);
       assert(esp_display_handle); // check if display handle is valid
+      const int64_t flush_start = esp_timer_get_time();
       // send framebuffer to display
       ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(esp_display_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, framebuffer));
-#if PORT_TESTING == 0
+      render_stats.flushes++;
       // indicate to LVGL that previous framebuffer is free to be used again
+      render_stats.flush_us += esp_timer_get_time() - flush_start;
       lv_disp_flush_ready(lvgl_display_driver);
-#endif
+    }
+
+    /**
+     * @brief    Display refresh monitor
+     * @details  Called by LVGL after each refresh with the number of pixels redrawn
+     */
+    static void display_monitor(lv_disp_drv_t *lvgl_display_driver, uint32_t time, uint32_t pixels)
+    {
+      render_stats.refreshes++;
+      render_stats.pixels += pixels;
+      render_stats.time_ms += time;
     }
 
 #ifdef BOARD_HAS_TOUCH
+    /**
+     * @brief    Touch controller interrupt is used
+     * @details  Without the INT line the touchpad is polled by LVGL input timer
+     */
+    #define TOUCH_INTERRUPT (GT911_TOUCH_CONFIG_INT_GPIO_NUM >= 0)
+
+    /**
+     * @brief    Touch counters
+     * @details  Written by touch interrupt, touch task and LVGL task
+     */
+    static touch_stats_t touch_stats = {};
+
+    /**
+     * @brief    Last touch points delivered to LVGL
+     * @details  Written on LVGL task with mutex taken
+     */
+    static touch_points_t touch_last = {};
+
+    /**
+     * @brief    Read touch controller points
+     * @details  One I2C transaction, the points are mapped to display coordinates
+     */
+    static void touch_sample(esp_lcd_touch_handle_t esp_touchscreen_panel, touch_points_t &sample)
+    {
+      uint16_t touchscreen_x[touch_max_points];
+      uint16_t touchscreen_y[touch_max_points];
+      uint16_t touchscreen_strength[touch_max_points];
+      uint8_t touchscreen_cnt = 0;
+
+      // read touchpad data to update internal coordinates and touch state
+      esp_lcd_touch_read_data(esp_touchscreen_panel);
+      touch_stats.reads++;
+
+      sample.count = 0;
+      if (!esp_lcd_touch_get_coordinates(esp_touchscreen_panel, touchscreen_x, touchscreen_y, touchscreen_strength, &touchscreen_cnt, touch_max_points))
+        return;
+
+      for (uint8_t i = 0; i < touchscreen_cnt && i < touch_max_points; i++)
+      {
+        sample.point[i].x = math::map<uint16_t>(touchscreen_x[i], 0, GT911_TOUCH_CONFIG_X_MAX, 0, DISPLAY_WIDTH);
+        sample.point[i].y = math::map<uint16_t>(touchscreen_y[i], 0, GT911_TOUCH_CONFIG_Y_MAX, 0, DISPLAY_HEIGHT);
+        sample.point[i].strength = touchscreen_strength[i];
+        sample.count++;
+      }
+    }
+
+    /**
+     * @brief    Record the time from touch interrupt to LVGL input read
+     */
+    static void touch_latency_record(int64_t timestamp_us)
+    {
+      const int64_t latency = esp_timer_get_time() - timestamp_us;
+      size_t bucket = 0;
+      while (bucket < touch_latency_buckets - 1 && latency >= touch_latency_limits_us[bucket])
+        bucket++;
+      touch_stats.latency[bucket]++;
+    }
+
+#if TOUCH_INTERRUPT
+    /**
+     * @brief    Touch task
+     * @details  Read the touch controller on its interrupt, out of LVGL task
+     */
+    static rtos::TaskStatic<3_kB> touch_task("Port task touch", 4);
+
+    /**
+     * @brief    LVGL touch input, its read timer is paused while released
+     */
+    static lv_indev_t *touch_indev = nullptr;
+
+    /**
+     * @brief    Time of the last touch interrupt
+     */
+    static volatile int64_t touch_interrupt_us = 0;
+
+    /**
+     * @brief    Touch samples from touch task to LVGL input read
+     * @details  Lock free, the touch task is the only producer
+     *           and LVGL task the only consumer
+     */
+    constexpr uint32_t touch_ring_size = 8;
+    static touch_points_t touch_ring[touch_ring_size];
+    static std::atomic<uint32_t> touch_head{0};
+    static std::atomic<uint32_t> touch_tail{0};
+
+    static bool touch_push(const touch_points_t &sample)
+    {
+      const uint32_t head = touch_head.load(std::memory_order_relaxed);
+      if (head - touch_tail.load(std::memory_order_acquire) == touch_ring_size)
+        return false;
+      touch_ring[head % touch_ring_size] = sample;
+      touch_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    static bool touch_pop(touch_points_t &sample)
+    {
+      const uint32_t tail = touch_tail.load(std::memory_order_relaxed);
+      if (tail == touch_head.load(std::memory_order_acquire))
+        return false;
+      sample = touch_ring[tail % touch_ring_size];
+      touch_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    static bool touch_pending()
+    {
+      return touch_tail.load(std::memory_order_relaxed) != touch_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief    Touch controller interrupt
+     * @details  Called from GPIO ISR, the controller is read by touch task
+     */
+    static void touch_interrupt(esp_lcd_touch_handle_t esp_touchscreen_panel)
+    {
+      touch_interrupt_us = esp_timer_get_time();
+      touch_stats.interrupts++;
+      touch_task.sendNotifyFromISR(1);
+    }
+
+    /**
+     * @brief    Handle touch controller
+     * @details  Sleeps until the touch interrupt, while pressed the controller
+     *           is also read each input period to catch the release
+     */
+    static void touch_handle(void *arg)
+    {
+      const esp_lcd_touch_handle_t esp_touchscreen_panel = static_cast<esp_lcd_touch_handle_t>(arg);
+      bool pressed = false;
+
+      while (1)
+      {
+        const uint32_t notified = pressed ? touch_task.takeNotify(milliseconds(LV_INDEV_DEF_READ_PERIOD)) : touch_task.takeNotify();
+
+        touch_points_t sample = {};
+        sample.timestamp_us = notified ? touch_interrupt_us : esp_timer_get_time();
+        touch_sample(esp_touchscreen_panel, sample);
+
+        // nothing to report
+        if (sample.count == 0 && !pressed)
+          continue;
+
+        const bool resume = !pressed;
+        pressed = sample.count > 0;
+        if (!touch_push(sample))
+          touch_stats.dropped++;
+
+        // first point of a touch, start LVGL input reads
+        if (resume)
+        {
+          mutex_take();
+          lv_timer_resume(touch_indev->driver->read_timer);
+          lv_timer_ready(touch_indev->driver->read_timer);
+          mutex_give();
+          wake();
+        }
+      }
+    }
+
+    /**
+     * @brief    Touchpad read
+     * @details  Consume the samples of touch task and send the first point to LVGL,
+     *           the read timer is paused when the touch is released
+     * */
+    static void touchpad_read(lv_indev_drv_t *lvgl_indev_driver, lv_indev_data_t *lvgl_out_data)
+    {
+      touch_points_t sample;
+      if (touch_pop(sample))
+      {
+        touch_latency_record(sample.timestamp_us);
+        sample.read_us = esp_timer_get_time();
+        touch_last = sample;
+        lvgl_out_data->continue_reading = touch_pending();
+      }
+
+      if (touch_last.count > 0)
+      {
+        lvgl_out_data->point.x = touch_last.point[0].x;
+        lvgl_out_data->point.y = touch_last.point[0].y;
+        lvgl_out_data->state = LV_INDEV_STATE_PRESSED;
+      }
+      else
+      {
+        lvgl_out_data->state = LV_INDEV_STATE_RELEASED;
+        // no I2C reads until next interrupt
+        if (!touch_pending())
+          lv_timer_pause(lvgl_indev_driver->read_timer);
+      }
+    }
+#else
     /**
      * @brief    Touchpad read
      * @details  Read touchpad and send coordinates to LVGL if touch is pressed
@@ -147,20 +374,16 @@ namespace lvgl
       // check if touchscreen panel handle is valid
       assert(esp_touchscreen_panel);
 
-      uint16_t touchscreen_x = 0;
-      uint16_t touchscreen_y = 0;
-      uint8_t touchscreen_cnt = 0;
-
-      // read touchpad data to update internal coordinates and touch state
-      esp_lcd_touch_read_data(esp_touchscreen_panel);
-
-      // get touchpad coordinates and touch state, if touch is pressed send coordinates to LVGL, if not send released state to LVGL
-      bool touchpad_pressed = esp_lcd_touch_get_coordinates(esp_touchscreen_panel, &touchscreen_x, &touchscreen_y, nullptr, &touchscreen_cnt, 1);
+      touch_last.timestamp_us = esp_timer_get_time();
+      touch_last.read_us = touch_last.timestamp_us;
+      touch_sample(esp_touchscreen_panel, touch_last);
+      touch_latency_record(touch_last.timestamp_us);
 
-      if (touchpad_pressed && touchscreen_cnt > 0)
+      // if touch is pressed send coordinates to LVGL, if not send released state to LVGL
+      if (touch_last.count > 0)
       {
-        lvgl_out_data->point.x = math::map<uint16_t>(touchscreen_x, 0, GT911_TOUCH_CONFIG_X_MAX, 0, DISPLAY_WIDTH);
-        lvgl_out_data->point.y = math::map<uint16_t>(touchscreen_y, 0, GT911_TOUCH_CONFIG_Y_MAX, 0, DISPLAY_HEIGHT);
+        lvgl_out_data->point.x = touch_last.point[0].x;
+        lvgl_out_data->point.y = touch_last.point[0].y;
         lvgl_out_data->state = LV_INDEV_STATE_PRESSED;
       }
       else
@@ -168,7 +391,22 @@ namespace lvgl
         lvgl_out_data->state = LV_INDEV_STATE_RELEASED;
       }
 
+      // slow down the read timer while idle so the LVGL task can sleep
+      static uint32_t last_touch = 0;
+      lv_timer_t *read_timer = lvgl_indev_driver->read_timer;
+      if (lvgl_out_data->state == LV_INDEV_STATE_PRESSED)
+      {
+        last_touch = lv_tick_get();
+        if (read_timer && read_timer->period != LV_INDEV_DEF_READ_PERIOD)
+          lv_timer_set_period(read_timer, LV_INDEV_DEF_READ_PERIOD);
+      }
+      else if (read_timer && read_timer->period != touch_idle_read_period_ms && lv_tick_elaps(last_touch) > touch_idle_ms)
+      {
+        lv_timer_set_period(read_timer, touch_idle_read_period_ms);
+      }
+
     }
+#endif // TOUCH_INTERRUPT
 #endif // BOARD_HAS_TOUCH
 
     /**
@@ -177,23 +415,37 @@ namespace lvgl
      */
     static void task_handle(void *arg)
     {
-      
-      task.sleepUntilInit();
+
+      task_id = xTaskGetCurrentTaskHandle();
 
       while (1)
       {
-        mutex.take();
-        lv_timer_handler();
-        mutex.give();
-        #if 1
-          task.sleepUntil(20ms);
-        #else
-          rtos::sleep(20ms);
-        #endif
+        mutex_take();
+        const int64_t start = esp_timer_get_time();
+        uint32_t next_ms = lv_timer_handler();
+        task_stats.wakeups++;
+        task_stats.busy_us += esp_timer_get_time() - start;
+        mutex_give();
+        // LV_NO_TIMER_READY when there is nothing to run
+        math::clamp<uint32_t>(next_ms, task_period_min_ms, task_period_max_ms);
+        task.takeNotify(milliseconds(next_ms));
       }
 
     }
 
+    /**
+     * @brief    Check if LVGL has work to do before its next timer
+     * @details  A widget change resumes the display refresh timer,
+     *           a new animation resumes the animation timer
+     */
+    static bool refresh_pending()
+    {
+      lv_disp_t *display = lv_disp_get_default();
+      if (display && display->refr_timer && !display->refr_timer->paused)
+        return true;
+      return lv_anim_count_running() > 0;
+    }
+
     /**
      * @brief    Get maximun PWM value based on PWM resolution
       * @return   Maximum PWM value
@@ -245,14 +497,40 @@ namespace lvgl
      *           internal timer are processed, changes cant no be done while LVGL handle
       * @note     After taking, the mutex must be released as soon as possible
      */
-    void mutex_take() { mutex.take(); }
+    void mutex_take()
+    {
+      mutex.take();
+      lock_stats.takes++;
+      if (lock_depth++ == 0)
+        lock_stats.acquisitions++;
+    }
 
     /**
      * @brief    release LVGL mutex
       * @details  Must be called after the mutex is taken to release
      *           LVGL interface to do other process
      */
-    void mutex_give() { mutex.give(); }
+    void mutex_give()
+    {
+      // wake LVGL task when a widget is changed from other task
+      const bool wake = --lock_depth == 0 && task_id != nullptr && xTaskGetCurrentTaskHandle() != task_id && refresh_pending();
+      mutex.give();
+      if (wake)
+        task.sendNotify(1);
+    }
+
+    /**
+     * @brief    Wake LVGL task
+     */
+    void wake()
+    {
+      task.sendNotify(1);
+    }
+
+    /**
+     * @brief    Get LVGL mutex counters
+     */
+    lock_stats_t get_lock_stats() { return lock_stats; }
 
     /**
      * @brief    Init display panel, touchpad panel and LVGL port
@@ -281,7 +559,7 @@ namespace lvgl
        * The configuration is passed to the esp_lcd_new_rgb_panel() function to create a new panel handle, and then the panel is reset and initialized with the created handle
        * The configuration is based on macros defined in board/esp32-8048s043c.json for this port
        */
-      const esp_lcd_rgb_panel_config_t rgb_panel_config = {
+      esp_lcd_rgb_panel_config_t rgb_panel_config = {
         .clk_src = ST7262_PANEL_CONFIG_CLK_SRC,
         .timings = {
           .pclk_hz = static_cast<int>(ST7262_PANEL_CONFIG_TIMINGS_PCLK_HZ),
@@ -327,20 +605,26 @@ namespace lvgl
           ST7262_PANEL_CONFIG_DATA_GPIO_B4,
         },
         .disp_gpio_num = ST7262_PANEL_CONFIG_DISP_GPIO_NUM,
-#if PORT_TESTING
-        .on_frame_trans_done = display_transfer_done,
-        .user_ctx = &lvgl_display_driver,
-#else 
+#if ESP_IDF_VERSION_MAJOR < 5
         .on_frame_trans_done = nullptr,
         .user_ctx = nullptr,
-#endif
+#endif // ESP_IDF_VERSION_MAJOR
         .flags = {
           .disp_active_low = ST7262_PANEL_CONFIG_FLAGS_DISP_ACTIVE_LOW, 
+#if ESP_IDF_VERSION_MAJOR < 5
           .relax_on_idle = ST7262_PANEL_CONFIG_FLAGS_RELAX_ON_IDLE, 
+#else
+          .refresh_on_demand = ST7262_PANEL_CONFIG_FLAGS_RELAX_ON_IDLE,
+#endif
           .fb_in_psram = ST7262_PANEL_CONFIG_FLAGS_FB_IN_PSRAM
         }
       };
 
+#if defined(ST7262_PANEL_CONFIG_BOUNCE_BUFFER_SIZE_PX) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 4)
+      // DMA reads the small SRAM bounce buffers, CPU refills them from the PSRAM framebuffer
+      rgb_panel_config.bounce_buffer_size_px = ST7262_PANEL_CONFIG_BOUNCE_BUFFER_SIZE_PX;
+#endif
+
       ESP_ERROR_CHECK(esp_lcd_new_rgb_panel(&rgb_panel_config, &esp_display_handle));
       ESP_ERROR_CHECK(esp_lcd_panel_reset(esp_display_handle));
       ESP_ERROR_CHECK(esp_lcd_panel_init(esp_display_handle));
@@ -390,7 +674,11 @@ namespace lvgl
           .mirror_y = TOUCH_MIRROR_Y
         },
         .process_coordinates = nullptr,
+#if TOUCH_INTERRUPT
+        .interrupt_callback = touch_interrupt,
+#else
         .interrupt_callback = nullptr,
+#endif
         .user_data = nullptr,
         .driver_data = nullptr
       };
@@ -447,10 +735,11 @@ namespace lvgl
        *         memory that wont be freed while LVGL is using it
        *         in fact this buffer will never be freed until system shutdown
        *         dinamic allocation is usefull when PSRAM is used to allocate
-       *         the framebuffer once internal RAM can be limited
+       *         the framebuffer once internal RAM can be limited,
+       *         stripe mode uses small buffers on internal RAM
        */
-      lv_color_t *display_draw_buffer1 = memory::alloc<lv_color_t>(LVGL_BUFFER_PIXELS, LVGL_BUFFER_MALLOC_FLAGS);
-      lv_color_t *display_draw_buffer2 = memory::alloc<lv_color_t>(LVGL_BUFFER_PIXELS, LVGL_BUFFER_MALLOC_FLAGS);
+      lv_color_t *display_draw_buffer1 = memory::alloc<lv_color_t>(draw_buffer_pixels, draw_buffer_caps);
+      lv_color_t *display_draw_buffer2 = memory::alloc<lv_color_t>(draw_buffer_pixels, draw_buffer_caps);
 
       if (display_draw_buffer1 == nullptr || display_draw_buffer2 == nullptr)
       {
@@ -458,7 +747,7 @@ namespace lvgl
         return;
       }
       
-      lv_disp_draw_buf_init(&lvgl_draw_buffer, display_draw_buffer1, display_draw_buffer2, LVGL_BUFFER_PIXELS);
+      lv_disp_draw_buf_init(&lvgl_draw_buffer, display_draw_buffer1, display_draw_buffer2, draw_buffer_pixels);
 
       /**
        * LVGL display driver link
@@ -468,10 +757,12 @@ namespace lvgl
       lvgl_display_driver.hor_res = DISPLAY_WIDTH;
       lvgl_display_driver.ver_res = DISPLAY_HEIGHT;
       lvgl_display_driver.flush_cb = display_flush;
+      lvgl_display_driver.monitor_cb = display_monitor;
       lvgl_display_driver.draw_buf = &lvgl_draw_buffer;
       lvgl_display_driver.sw_rotate = true;
       lvgl_display_driver.drv_update_cb = nullptr;
       lv_disp_drv_register(&lvgl_display_driver);
+      render_stats_start = esp_timer_get_time();
 
       /**
        * LVGL touch driver link
@@ -481,11 +772,17 @@ namespace lvgl
       lvgl_indev_driver.type = LV_INDEV_TYPE_POINTER;
       lvgl_indev_driver.user_data = esp_touchscreen_handle;
       lvgl_indev_driver.read_cb = touchpad_read;
+#if defined(BOARD_HAS_TOUCH) && TOUCH_INTERRUPT
+      touch_indev = lv_indev_drv_register(&lvgl_indev_driver);
+      touch_task.attach(touch_handle, esp_touchscreen_handle);
+#else
       lv_indev_drv_register(&lvgl_indev_driver);
+#endif
 
       /**
        * LVGL update task init
        */
+      task_stats_start = esp_timer_get_time();
       task.attach(task_handle);
     }
 
@@ -529,6 +826,91 @@ namespace lvgl
       ESP_LOGI(log_tag, "Task memory used %d kB\n", task.memUsage());
     }
 
+    /**
+     * @brief    Get LVGL task counters
+     */
+    task_stats_t get_task_stats()
+    {
+      mutex_take();
+      task_stats_t ret = task_stats;
+      ret.elapsed_us = esp_timer_get_time() - task_stats_start;
+      mutex_give();
+      return ret;
+    }
+
+    /**
+     * @brief    Clear LVGL task counters
+     */
+    void reset_task_stats()
+    {
+      mutex_take();
+      task_stats = {};
+      task_stats_start = esp_timer_get_time();
+      mutex_give();
+    }
+
+#ifdef BOARD_HAS_TOUCH
+    /**
+     * @brief    Get last touch points delivered to LVGL
+     */
+    bool get_touch_points(touch_points_t &points)
+    {
+      mutex_take();
+      points = touch_last;
+      mutex_give();
+      return points.count > 0;
+    }
+
+    /**
+     * @brief    Get touch counters
+     */
+    touch_stats_t get_touch_stats()
+    {
+      mutex_take();
+      touch_stats_t ret = touch_stats;
+      mutex_give();
+      return ret;
+    }
+
+    /**
+     * @brief    Clear touch counters
+     */
+    void reset_touch_stats()
+    {
+      mutex_take();
+      touch_stats = {};
+      mutex_give();
+    }
+#endif // BOARD_HAS_TOUCH
+
+    /**
+     * @brief    Render mode built in this port
+     */
+    int render_mode() { return LVGL_RENDER_MODE; }
+
+    /**
+     * @brief    Get display refresh counters
+     */
+    render_stats_t get_render_stats()
+    {
+      mutex_take();
+      render_stats_t ret = render_stats;
+      ret.elapsed_us = esp_timer_get_time() - render_stats_start;
+      mutex_give();
+      return ret;
+    }
+
+    /**
+     * @brief    Clear display refresh counters
+     */
+    void reset_render_stats()
+    {
+      mutex_take();
+      render_stats = {};
+      render_stats_start = esp_timer_get_time();
+      mutex_give();
+    }
+
   } // namespace port
 
 } // namespace lvgl
@@ -41,6 +41,7 @@
 #include "rtos_eventGroup_static.hpp"
 #include "rtos_mutex.hpp"
 #include "rtos_mutex_static.hpp"
+#include "rtos_profiler.hpp"
 #include "rtos_queue.hpp"
 #include "rtos_queue_static.hpp"
 #include "rtos_semaphore.hpp"
@@ -0,0 +1,142 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the “Software”), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _RTOS_PROFILER_HPP_
+#define _RTOS_PROFILER_HPP_
+
+/**
+ * @def      RTOS_PROFILER
+ * @brief    Task profiler switch, 0 removes the profiler and its tick hooks entirely
+ * @details  Set it with -DRTOS_PROFILER=1 on build_flags, see env esp32-8048S043C-profiler
+ */
+#ifndef RTOS_PROFILER
+#define RTOS_PROFILER 0
+#endif
+
+#if RTOS_PROFILER
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * @namespace  rtos
+ * @brief      Name space with freeRTOS functions
+ */
+namespace rtos
+{
+
+  /**
+   * @namespace  profiler
+   * @brief      Sampling profiler of tasks
+   * @details    A tick hook on each core counts the task found running on that core,
+   *             so run time has tick resolution (1 ms) and runs count the times a
+   *             task was found on a core after another task, context switches seen
+   *             at tick resolution. Idle tasks give the load of each core.
+   *             rtos::Task and rtos::TaskStatic are added by attach(), other tasks
+   *             can be added by handle and the rest is counted as unregistered.
+   * @note       FreeRTOS run time stats are not enabled by Arduino framework,
+   *             the cycles spent inside the hooks are counted as profiler overhead
+   */
+  namespace profiler
+  {
+    constexpr size_t max_tasks = 16;
+    constexpr uint8_t core_count = portNUM_PROCESSORS;
+    constexpr uint8_t no_core = 0xFF;
+
+    /**
+     * @struct   core_stats_s
+     * @typedef  core_stats_t
+     * @brief    Counters of one core since the last sample
+     */
+    typedef struct core_stats_s
+    {
+      uint32_t ticks;        /* tick hooks run */
+      uint32_t idle_ticks;   /* ticks of the idle task */
+      uint32_t other_ticks;  /* ticks of tasks not added */
+      uint32_t switches;     /* task found differs from the previous tick */
+      uint32_t hook_cycles;  /* CPU cycles spent inside the tick hook */
+    } core_stats_t;
+
+    /**
+     * @struct   task_stats_s
+     * @typedef  task_stats_t
+     * @brief    Counters of one task since the last sample
+     */
+    typedef struct task_stats_s
+    {
+      const char *name;
+      uint32_t ticks;       /* ticks found running */
+      uint32_t runs;        /* ticks found running after another task */
+      uint32_t stack_free;  /* stack high water mark in bytes */
+      uint8_t core;         /* last core found running, no_core if never */
+    } task_stats_t;
+
+    /**
+     * @struct   report_s
+     * @typedef  report_t
+     * @brief    Sample of all counters
+     */
+    typedef struct report_s
+    {
+      core_stats_t cores[core_count];
+      task_stats_t tasks[max_tasks];
+      size_t count;              /* tasks in use */
+      uint32_t cycles_per_tick;  /* CPU cycles of a tick, for the overhead */
+    } report_t;
+
+    /**
+     * @brief    Register the tick hooks of each core
+     * @return   true if profiling is running
+     * @note     Call it after the scheduler is started, tasks can be added before
+     */
+    bool start();
+
+    /**
+     * @brief    Add a task to the profiled tasks
+     * @param    handle  Task handle
+     * @param    name    Name printed on reports, must outlive the task
+     * @return   false if the table is full
+     */
+    bool add(TaskHandle_t handle, const char *name);
+
+    /**
+     * @brief    Remove a task, call it before the task is deleted
+     * @param    handle  Task handle
+     */
+    void remove(TaskHandle_t handle);
+
+    /**
+     * @brief    Copy the counters and clear them
+     * @param    report  Counters since the previous sample
+     * @note     NSFI - Not Safe For ISR, reads the stack high water marks
+     */
+    void sample(report_t &report);
+
+  } // namespace profiler
+
+} // namespace rtos
+
+#endif // RTOS_PROFILER
+
+#endif
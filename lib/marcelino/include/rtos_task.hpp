@@ -29,6 +29,7 @@
 #include "freertos/task.h"
 
 #include "rtos_chrono.hpp"
+#include "rtos_profiler.hpp"
 
 /**
  * @typedef  taskArg_t
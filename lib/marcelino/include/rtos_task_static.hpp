@@ -29,6 +29,7 @@
 #include "freertos/task.h"
 
 #include "rtos_chrono.hpp"
+#include "rtos_profiler.hpp"
 
 /**
  * @typedef  taskStaticArg_t
@@ -140,6 +141,9 @@ namespace rtos
       if (_handle != nullptr)
         return;
       _handle = xTaskCreateStatic(callback, _name, _stackSize, args, _priority, _stackBuffer, &_stack);
+#if RTOS_PROFILER
+      profiler::add(_handle, _name);
+#endif
     }
 
     /**
@@ -0,0 +1,200 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the “Software”), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "rtos_profiler.hpp"
+
+#if RTOS_PROFILER
+
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_freertos_hooks.h"
+#include "esp_idf_version.h"
+#include "esp32-hal-cpu.h"
+
+namespace rtos
+{
+
+  namespace profiler
+  {
+
+    /**
+     * @brief   Counters written by the tick hooks, in internal RAM
+     */
+    typedef struct entry_s
+    {
+      TaskHandle_t handle;
+      const char *name;
+      uint32_t ticks;
+      uint32_t runs;
+      uint8_t core;
+    } entry_t;
+
+    static portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+    static entry_t _tasks[max_tasks];
+    static size_t _count = 0;
+    static core_stats_t _cores[core_count];
+    static TaskHandle_t _idle[core_count];
+    static TaskHandle_t _last[core_count];
+    static bool _running = false;
+
+    static inline uint32_t IRAM_ATTR cycles()
+    {
+#if ESP_IDF_VERSION_MAJOR < 5
+      return esp_cpu_get_ccount();
+#else
+      return esp_cpu_get_cycle_count();
+#endif
+    }
+
+    static inline TaskHandle_t IRAM_ATTR current_task(uint8_t core)
+    {
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 1, 0)
+      return xTaskGetCurrentTaskHandleForCPU(core);
+#else
+      return xTaskGetCurrentTaskHandleForCore(core);
+#endif
+    }
+
+    /**
+     * @brief   Count the task running on core, called by the tick interrupt of that core
+     */
+    static void IRAM_ATTR tick(uint8_t core)
+    {
+      const uint32_t begin = cycles();
+      const TaskHandle_t current = current_task(core);
+      core_stats_t &stats = _cores[core];
+      const bool switched = current != _last[core];
+
+      portENTER_CRITICAL_ISR(&_lock);
+      stats.ticks++;
+      if (switched)
+        stats.switches++;
+      if (current == _idle[core])
+        stats.idle_ticks++;
+      else
+      {
+        size_t index = 0;
+        while (index < _count && _tasks[index].handle != current)
+          index++;
+        if (index < _count)
+        {
+          _tasks[index].ticks++;
+          _tasks[index].core = core;
+          if (switched)
+            _tasks[index].runs++;
+        }
+        else
+          stats.other_ticks++;
+      }
+      _last[core] = current;
+      stats.hook_cycles += cycles() - begin;
+      portEXIT_CRITICAL_ISR(&_lock);
+    }
+
+    static void IRAM_ATTR tick_core0() { tick(0); }
+#if portNUM_PROCESSORS > 1
+    static void IRAM_ATTR tick_core1() { tick(1); }
+#endif
+
+    bool start()
+    {
+      if (_running)
+        return true;
+
+      for (uint8_t core = 0; core < core_count; core++)
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 1, 0)
+        _idle[core] = xTaskGetIdleTaskHandleForCPU(core);
+#else
+        _idle[core] = xTaskGetIdleTaskHandleForCore(core);
+#endif
+
+      _running = esp_register_freertos_tick_hook_for_cpu(tick_core0, 0) == ESP_OK;
+#if portNUM_PROCESSORS > 1
+      _running = _running && esp_register_freertos_tick_hook_for_cpu(tick_core1, 1) == ESP_OK;
+#endif
+      return _running;
+    } // profiler::start
+
+    bool add(TaskHandle_t handle, const char *name)
+    {
+      if (handle == nullptr)
+        return false;
+
+      bool added = false;
+      portENTER_CRITICAL(&_lock);
+      size_t index = 0;
+      while (index < _count && _tasks[index].handle != nullptr && _tasks[index].handle != handle)
+        index++;
+      if (index < max_tasks)
+      {
+        _tasks[index] = {handle, name, 0, 0, no_core};
+        if (index == _count)
+          _count++;
+        added = true;
+      }
+      portEXIT_CRITICAL(&_lock);
+      return added;
+    } // profiler::add
+
+    void remove(TaskHandle_t handle)
+    {
+      if (handle == nullptr)
+        return;
+
+      portENTER_CRITICAL(&_lock);
+      for (size_t index = 0; index < _count; index++)
+        if (_tasks[index].handle == handle)
+          _tasks[index].handle = nullptr;
+      portEXIT_CRITICAL(&_lock);
+    } // profiler::remove
+
+    void sample(report_t &report)
+    {
+      TaskHandle_t handles[max_tasks];
+
+      /* copy and clear inside the lock, the hooks of both cores wait for it */
+      portENTER_CRITICAL(&_lock);
+      memcpy(report.cores, _cores, sizeof(_cores));
+      memset(_cores, 0, sizeof(_cores));
+      report.count = 0;
+      for (size_t index = 0; index < _count; index++)
+      {
+        if (_tasks[index].handle == nullptr)
+          continue;
+        handles[report.count] = _tasks[index].handle;
+        report.tasks[report.count++] = {_tasks[index].name, _tasks[index].ticks, _tasks[index].runs, 0, _tasks[index].core};
+        _tasks[index].ticks = 0;
+        _tasks[index].runs = 0;
+      }
+      portEXIT_CRITICAL(&_lock);
+
+      for (size_t index = 0; index < report.count; index++)
+        report.tasks[index].stack_free = uxTaskGetStackHighWaterMark(handles[index]);
+      report.cycles_per_tick = getCpuFrequencyMhz() * 1000000UL / configTICK_RATE_HZ;
+    } // profiler::sample
+
+  } // namespace profiler
+
+} // namespace rtos
+
+#endif // RTOS_PROFILER
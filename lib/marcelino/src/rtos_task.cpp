@@ -39,6 +39,9 @@ namespace rtos
     if (_handle != nullptr)
       return;
     xTaskCreatePinnedToCore(callback, _name, _stackSize, args, _priority, &_handle, _core);
+#if RTOS_PROFILER
+    profiler::add(_handle, _name);
+#endif
   }
 
   void Task::sendNotify(uint32_t notification)
@@ -109,6 +112,9 @@ namespace rtos
   {
     if (_handle == nullptr)
       return;
+#if RTOS_PROFILER
+    profiler::remove(_handle);
+#endif
     vTaskDelete(_handle);
     _handle = nullptr;
   }
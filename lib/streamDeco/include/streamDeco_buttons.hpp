@@ -123,6 +123,12 @@ namespace streamDeco
      * @brief   If using two icons change between then
      */
     void iconSwap();
+
+    /**
+     * @brief   Show a known toggle state, the second icon and pinned when on
+     * @param   on  State reported by the computer
+     */
+    void setToggled(bool on);
     
     /**
      * @brief   Pin the streamDecoButtons
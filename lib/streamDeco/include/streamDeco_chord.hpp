@@ -0,0 +1,165 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_CHORD_HPP_
+#define _STREAMDECO_CHORD_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "BleKeyboardAsciiMap.h"
+
+namespace streamDeco
+{
+
+    /**
+     * Keyboard chords built at compile time.
+     *
+     * Keys use BleKeyboard codes: 0x80 to 0x87 are modifiers, 136 and above
+     * are non printing keys (HID usage + 136) and below 128 are ASCII
+     * characters mapped to HID usages, shifted characters add left shift.
+     * A chord is one HID keyboard report with all modifiers and keys pressed
+     * together, sent as one press report and one release report.
+     */
+    namespace chord
+    {
+
+        constexpr uint8_t shift = ASCII_SHIFT;
+        constexpr uint8_t left_shift_modifier = 0x02;
+        constexpr uint8_t modifier_first = 0x80;
+        constexpr uint8_t non_printing_first = 136;
+        constexpr size_t max_keys = 6;
+
+        /**
+         * @brief    ASCII to HID usage, the map of BleKeyboard press and release
+         */
+        inline constexpr const uint8_t (&ascii_map)[128] = _asciimap;
+
+        /**
+         * @struct   report_s
+         * @typedef  report_t
+         * @brief    HID keyboard report, same layout of BleKeyboard KeyReport
+         */
+        typedef struct report_s
+        {
+            uint8_t modifiers;
+            uint8_t reserved;
+            uint8_t keys[max_keys];
+        } report_t;
+
+        /**
+         * @enum     action_e
+         * @brief    HID report sent by a shortcut
+         */
+        enum action_e : uint8_t
+        {
+            no_action,
+            key_action,
+            media_action,
+        };
+
+        /**
+         * @struct   shortcut_s
+         * @typedef  shortcut_t
+         * @brief    Keyboard or media shortcut of a button event
+         */
+        typedef struct shortcut_s
+        {
+            action_e action;
+            report_t report;  /* key_action, pressed then released */
+            uint8_t media[2]; /* media_action, same layout of BleKeyboard MediaKeyReport */
+        } shortcut_t;
+
+        /**
+         * @brief    Add one key to a report
+         * @details  Same rules of BleKeyboard::press, keys already in the report
+         *           or beyond max_keys are ignored
+         */
+        constexpr void add_key(report_t &report, uint8_t key)
+        {
+            uint8_t usage = 0;
+            if (key >= non_printing_first)
+            {
+                usage = key - non_printing_first;
+            }
+            else if (key >= modifier_first)
+            {
+                report.modifiers |= 1 << (key - modifier_first);
+                return;
+            }
+            else
+            {
+                usage = ascii_map[key];
+                if (usage & shift)
+                {
+                    report.modifiers |= left_shift_modifier;
+                    usage &= ~shift;
+                }
+            }
+
+            if (usage == 0)
+                return;
+
+            for (size_t i = 0; i < max_keys; i++)
+            {
+                if (report.keys[i] == usage)
+                    return;
+                if (report.keys[i] == 0)
+                {
+                    report.keys[i] = usage;
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief    Shortcut of keys pressed together
+         * @code
+         * constexpr chord::shortcut_t terminal = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, KEY_RETURN);
+         */
+        template <typename... KEYS>
+        constexpr shortcut_t keys(KEYS... key)
+        {
+            static_assert(sizeof...(KEYS) > 0, "A chord needs at least one key");
+            shortcut_t shortcut = {};
+            shortcut.action = key_action;
+            (add_key(shortcut.report, static_cast<uint8_t>(key)), ...);
+            return shortcut;
+        }
+
+        /**
+         * @brief    Shortcut of a media key
+         */
+        constexpr shortcut_t media(const uint8_t (&media_key)[2])
+        {
+            shortcut_t shortcut = {};
+            shortcut.action = media_action;
+            shortcut.media[0] = media_key[0];
+            shortcut.media[1] = media_key[1];
+            return shortcut;
+        }
+
+    } // namespace chord
+
+} // namespace streamDeco
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_EXECUTOR_HPP_
+#define _STREAMDECO_EXECUTOR_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace streamDeco
+{
+
+    /**
+     * Event loop executor.
+     *
+     * One worker drains typed messages posted by callbacks, frameRouter and
+     * timers. Messages are dispatched by priority, FIFO within a priority,
+     * so the order is the same on every run. Timers are kept on a min-heap
+     * ordered by due time, a due timer posts its message like any producer.
+     *
+     * The handler of each message type is timed and the queue depth is kept,
+     * the time from post to dispatch is the queue wait of the message.
+     * Not thread safe, the owner serializes post(), next() and timer calls,
+     * dispatch() runs handlers outside of that lock.
+     */
+    namespace executor
+    {
+
+        constexpr size_t queue_size = 16; /* pending messages of each priority */
+        constexpr size_t max_timers = 16;
+
+        /**
+         * @enum     priority_e
+         * @brief    Dispatch priority, high first
+         */
+        enum priority_e : uint8_t
+        {
+            high_priority,
+            normal_priority,
+            low_priority,
+            priority_count,
+        };
+
+        /**
+         * @enum     message_e
+         * @brief    Types of message, each type has one handler
+         */
+        enum message_e : uint8_t
+        {
+            button_message,   /* value is the button event */
+            sent_message,     /* HID reports of the last button were notified */
+            feedback_message, /* computer state written on the HID feedback report */
+            ingest_message,   /* bytes received on Serial or BLE */
+            frame_message,    /* metrics published by frameRouter */
+            tick_message,     /* clock refresh or frame with date */
+            idle_message,     /* value is the idle event */
+            memory_message,   /* memory telemetry sample */
+            dump_message,     /* value is the serial log dump requested */
+            save_message,     /* value is the save event */
+            message_count,
+        };
+
+        /**
+         * @struct   message_s
+         * @typedef  message_t
+         * @brief    Message waiting on the queue
+         */
+        typedef struct message_s
+        {
+            message_e type;
+            uint32_t value;
+            int64_t posted_us;
+            uint32_t tap; /* trace id of the touch that posted it, 0 for none */
+        } message_t;
+
+        /**
+         * @struct   handler_stats_s
+         * @typedef  handler_stats_t
+         * @brief    Execution time of the handler of one message type
+         */
+        typedef struct handler_stats_s
+        {
+            uint32_t count;
+            int64_t total_us;
+            int64_t max_us;
+            int64_t wait_max_us; /* longest time from post to dispatch */
+        } handler_stats_t;
+
+        /**
+         * @struct   queue_stats_s
+         * @typedef  queue_stats_t
+         * @brief    Queue counters
+         */
+        typedef struct queue_stats_s
+        {
+            uint32_t posted;
+            uint32_t coalesced; /* same type and value already waiting */
+            uint32_t dropped;   /* queue of the priority was full */
+            uint32_t depth;
+            uint32_t max_depth;
+        } queue_stats_t;
+
+        /**
+         * @typedef  handler_t
+         * @brief    Handler of a message type, runs on the worker
+         */
+        typedef void (*handler_t)(const message_t &message);
+
+        /**
+         * @typedef  now_t
+         * @brief    Monotonic clock in microseconds
+         */
+        typedef int64_t (*now_t)();
+
+        /**
+         * @typedef  timer_id_t
+         * @brief    Timer returned by Executor::schedule
+         */
+        typedef uint8_t timer_id_t;
+        constexpr timer_id_t no_timer = 0xFF;
+
+        /**
+         * @brief    Short name of a message type
+         */
+        const char *name(message_e type);
+
+        /**
+         * @class    Executor
+         * @brief    Priority message queue and timers of one worker
+         */
+        class Executor
+        {
+        public:
+            explicit Executor(now_t now) : _now(now) {}
+
+            /**
+             * @brief   Route a message type to its handler
+             * @param   coalesce  Drop a post when the same type and value is already waiting
+             */
+            void on(message_e type, handler_t handler, priority_e priority, bool coalesce = false);
+
+            /**
+             * @brief   Post a message
+             * @param   tap  Trace id carried to the handler, see trace::Tracer::begin()
+             * @return  false if the queue of its priority is full or the type has no handler
+             */
+            bool post(message_e type, uint32_t value = 0, uint32_t tap = 0);
+
+            /**
+             * @brief   Post a message after delay_us, again every period_us if not 0
+             * @return  Timer id, no_timer if all timers are in use
+             */
+            timer_id_t schedule(message_e type, uint32_t value, int64_t delay_us, int64_t period_us = 0);
+
+            /**
+             * @brief   Delay a timer again from now, stopped timers are started
+             */
+            void restart(timer_id_t timer);
+
+            /**
+             * @brief   Change the period of a timer and restart it, 0 stops it
+             */
+            void period(timer_id_t timer, int64_t period_us);
+
+            /**
+             * @brief   Stop a timer, it can be restarted
+             */
+            void stop(timer_id_t timer);
+
+            /**
+             * @brief   Post the due timers and take the next message
+             * @return  false if no message is waiting
+             */
+            bool next(message_t &message);
+
+            /**
+             * @brief   Time until the next message
+             * @return  0 if a message is waiting, -1 if no timer is running
+             */
+            int64_t wait_us() const;
+
+            /**
+             * @brief   Run the handler of a message taken by next() and time it
+             */
+            void dispatch(const message_t &message);
+
+            /**
+             * @brief   Messages waiting
+             */
+            size_t depth() const { return _queue_stats.depth; }
+
+            const handler_stats_t &stats(message_e type) const { return _stats[type]; }
+
+            const queue_stats_t &queue_stats() const { return _queue_stats; }
+
+            /**
+             * @brief   Clear handler and queue counters, depth is kept
+             */
+            void reset_stats();
+
+        private:
+            typedef struct route_s
+            {
+                handler_t handler;
+                priority_e priority;
+                bool coalesce;
+            } route_t;
+
+            typedef struct timer_s
+            {
+                int64_t due_us;
+                int64_t delay_us;
+                int64_t period_us;
+                uint32_t value;
+                message_e type;
+                bool used;
+                uint8_t heap; /* index on _heap, no_timer when stopped */
+            } timer_slot_t;
+
+            typedef struct ring_s
+            {
+                message_t messages[queue_size];
+                uint8_t head;
+                uint8_t count;
+            } ring_t;
+
+            bool push(const message_t &message);
+            void heap_insert(timer_id_t timer);
+            void heap_remove(timer_id_t timer);
+            void heap_swap(uint8_t a, uint8_t b);
+            void sift_up(uint8_t index);
+            void sift_down(uint8_t index);
+
+            now_t _now;
+            route_t _routes[message_count] = {};
+            ring_t _rings[priority_count] = {};
+            timer_slot_t _timers[max_timers] = {};
+            timer_id_t _heap[max_timers] = {};
+            uint8_t _heap_size = 0;
+            handler_stats_t _stats[message_count] = {};
+            queue_stats_t _queue_stats = {};
+        }; // class Executor
+
+    } // namespace executor
+
+} // namespace streamDeco
+
+#endif
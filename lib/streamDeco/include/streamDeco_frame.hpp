@@ -0,0 +1,437 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_FRAME_HPP_
+#define _STREAMDECO_FRAME_HPP_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace streamDeco
+{
+
+    /**
+     * StreamDecoMonitor frame protocol, binary layout little-endian:
+     *
+     * | sync | version | type | length | payload ... | crc16 |
+     * | 0xA5 |    1    |  1   |   1    |   length    |   2   |
+     *
+     * crc16 is CCITT (poly 0x1021, init 0xFFFF) over version, type, length
+     * and payload. The legacy text frame "v0, v1, ..., v16/" is still
+     * accepted, the parser detects the format by the first byte of a frame.
+     * Shortcuts frames carry a command byte followed by its arguments:
+     *
+     * | begin_command  | image size (2)            |
+     * | data_command   | offset (2) | chunk ...    |
+     * | commit_command |                           |
+     *
+     * Request frames carry one request byte and its arguments, answered on the serial log:
+     *
+     * | trace_request    |              | tap to keystroke trace dump                   |
+     * | top_request      | interval (1) | task profiler table, every interval seconds,  |
+     * |                  |              | once when interval is 0 or missing            |
+     * | memory_request   |              | memory telemetry history                      |
+     * | executor_request |              | queue depth and execution time of handlers    |
+     *
+     * Chunks must be sent in order, the image layout is on streamDeco_keymap.hpp.
+     * Frames arrive as a byte stream on Serial or on the BLE data channel,
+     * a frame can be split across BLE writes and a write can carry several frames.
+     */
+    namespace frame
+    {
+
+        constexpr uint8_t sync_byte = 0xA5;
+        constexpr uint8_t protocol_version = 1;
+        constexpr char text_terminator = '/';
+
+        constexpr size_t header_size = 4;
+        constexpr size_t crc_size = 2;
+        constexpr size_t metrics_payload_size = 36;
+        constexpr size_t max_payload_size = 64;
+        constexpr size_t max_binary_size = header_size + max_payload_size + crc_size;
+        constexpr size_t max_text_size = 128;
+        constexpr size_t ring_size = 256;
+
+        /**
+         * @enum     type_e
+         * @brief    Payload type carried by a binary frame
+         */
+        enum type_e : uint8_t
+        {
+            metrics_type = 0x01,
+            shortcuts_type = 0x02,
+            request_type = 0x03,
+        };
+
+        /**
+         * @enum     command_e
+         * @brief    First payload byte of a shortcuts frame
+         */
+        enum command_e : uint8_t
+        {
+            begin_command = 0x01,
+            data_command = 0x02,
+            commit_command = 0x03,
+        };
+
+        /**
+         * @enum     request_e
+         * @brief    First payload byte of a request frame
+         */
+        enum request_e : uint8_t
+        {
+            trace_request = 0x01,
+            top_request = 0x02,
+            memory_request = 0x03,
+            executor_request = 0x04,
+        };
+
+        /**
+         * @enum     format_e
+         * @brief    Wire format of the last frame received
+         */
+        enum format_e : uint8_t
+        {
+            format_unknown,
+            format_text,
+            format_binary,
+        };
+
+        /**
+         * @enum     transport_e
+         * @brief    Link a frame arrived on
+         */
+        enum transport_e : uint8_t
+        {
+            transport_serial,
+            transport_ble,
+            transport_count,
+        };
+
+        /**
+         * @struct   metrics_s
+         * @typedef  metrics_t
+         * @brief    Computer metrics decoded from a frame
+         * @details  Same field order of the text frame, the wire layout is
+         *           packed by encode() and decode() field by field
+         */
+        typedef struct metrics_s
+        {
+            int16_t cpu_load;
+            int16_t cpu_temp;
+            int16_t cpu_freq;
+            int16_t gpu_load;
+            int16_t gpu_temp;
+            int16_t gpu_freq;
+            int32_t mem_used;
+            int32_t mem_max;
+            int32_t disk_used;
+            int32_t disk_max;
+            uint8_t sec;
+            uint8_t min;
+            uint8_t hour;
+            uint8_t wday;
+            uint8_t mday;
+            uint8_t month;
+            uint16_t year;
+            bool clock_valid; /* not sent, true if the frame carries the date */
+        } metrics_t;
+
+        /**
+         * @struct   payload_s
+         * @typedef  payload_t
+         * @brief    Raw payload of frames other than metrics
+         */
+        typedef struct payload_s
+        {
+            uint8_t size;
+            uint8_t data[max_payload_size];
+        } payload_t;
+
+        /**
+         * @struct   slot_s
+         * @typedef  slot_t
+         * @brief    Fixed size frame slot passed through frame queues
+         */
+        typedef struct slot_s
+        {
+            type_e type;
+            union
+            {
+                metrics_t metrics; /* metrics_type */
+                payload_t payload; /* other types */
+            };
+            format_e format;
+            transport_e transport;
+            int64_t arrival_us; /* time of the first byte of the frame */
+        } slot_t;
+
+        /**
+         * @brief    CRC-16/CCITT-FALSE
+         * @param    data    Bytes to check
+         * @param    length  Number of bytes
+         * @param    crc     Initial value, used to chain calls
+         */
+        uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+        /**
+         * @brief    Encode metrics into a binary frame
+         * @param    metrics  Metrics to encode
+         * @param    buffer   Output buffer
+         * @param    size     Output buffer size
+         * @return   Number of bytes written, 0 if buffer is too small
+         */
+        size_t encode(const metrics_t &metrics, uint8_t *buffer, size_t size);
+
+        /**
+         * @brief    Decode a complete binary frame in place
+         * @param    data     Frame starting with sync byte
+         * @param    length   Frame length
+         * @param    metrics  Decoded metrics
+         * @return   true if the frame is valid
+         */
+        bool decode(const uint8_t *data, size_t length, metrics_t &metrics);
+
+        /**
+         * @brief    Copy the payload of a complete binary frame
+         * @param    data     Frame starting with sync byte
+         * @param    length   Frame length
+         * @param    payload  Frame payload
+         * @return   true if the frame is valid and its type is not metrics
+         */
+        bool decode_payload(const uint8_t *data, size_t length, payload_t &payload);
+
+        /**
+         * @brief    Decode a legacy text frame
+         * @param    text     Comma separated values, terminator optional
+         * @param    length   Text length
+         * @param    metrics  Decoded metrics, fields missing on text are kept
+         * @return   true if at least the computer metrics are present
+         */
+        bool decode_text(const char *text, size_t length, metrics_t &metrics);
+
+        /**
+         * @class    Parser
+         * @brief    Byte oriented frame parser
+         * @details  Feed bytes as they arrive, binary and text frames are
+         *           reassembled on a fixed buffer without heap allocation
+         */
+        class Parser
+        {
+        public:
+            enum result_e
+            {
+                pending,
+                complete,
+                error,
+            };
+
+            /**
+             * @brief   Push one received byte
+             * @return  complete when metrics() holds a new frame
+             */
+            result_e push(uint8_t byte);
+
+            /**
+             * @brief   Discard a partial frame
+             */
+            void reset();
+
+            /**
+             * @brief   Metrics of the last complete frame
+             */
+            const metrics_t &metrics() const { return _metrics; }
+
+            /**
+             * @brief   Payload of the last complete frame, if it is not metrics
+             */
+            const payload_t &payload() const { return _payload; }
+
+            /**
+             * @brief   Type of the last complete frame
+             */
+            type_e type() const { return _type; }
+
+            /**
+             * @brief   Format of the last complete frame
+             */
+            format_e format() const { return _format; }
+
+            /**
+             * @brief   Number of frames dropped by CRC, version or overflow
+             */
+            uint32_t errors() const { return _errors; }
+
+            /**
+             * @brief   true while a frame is partially received
+             */
+            bool busy() const { return _state != idle; }
+
+        private:
+            enum state_e : uint8_t
+            {
+                idle,
+                binary,
+                text,
+            };
+
+            result_e fail();
+
+            uint8_t _buffer[max_text_size > max_binary_size ? max_text_size : max_binary_size];
+            size_t _index = 0;
+            size_t _expected = 0;
+            state_e _state = idle;
+            format_e _format = format_unknown;
+            type_e _type = metrics_type;
+            uint32_t _errors = 0;
+            metrics_t _metrics = {};
+            payload_t _payload = {};
+        }; // class Parser
+
+        /**
+         * @class    Source
+         * @brief    Byte source read by Assembler
+         * @details  Implemented by the Serial interface on target,
+         *           can be a pty or a plain buffer on host tests
+         */
+        class Source
+        {
+        public:
+            virtual ~Source() = default;
+
+            /**
+             * @brief   Read available bytes without blocking
+             * @return  Number of bytes read
+             */
+            virtual size_t read(uint8_t *data, size_t size) = 0;
+        }; // class Source
+
+        /**
+         * @class    Channel
+         * @brief    Byte source filled by another task
+         * @details  Single producer, single consumer ring buffer without locks,
+         *           write() is called by the producer (BLE host task on target)
+         *           and read() by the Assembler owner
+         */
+        class Channel : public Source
+        {
+        public:
+            /**
+             * @brief   Copy received bytes
+             * @return  Number of bytes accepted, the rest is dropped
+             */
+            size_t write(const uint8_t *data, size_t size);
+
+            size_t read(uint8_t *data, size_t size) override;
+
+            /**
+             * @brief   Bytes dropped because the ring buffer was full
+             */
+            uint32_t dropped() const { return _dropped; }
+
+        private:
+            uint8_t _ring[ring_size];
+            std::atomic<size_t> _head{0}; /* written by producer */
+            std::atomic<size_t> _tail{0}; /* written by consumer */
+            uint32_t _dropped = 0;
+        }; // class Channel
+
+        /**
+         * @class    Assembler
+         * @brief    Reassemble frames from a byte source
+         * @details  Bytes are copied from Source to a fixed ring buffer by fill()
+         *           and parsed by next(), each complete frame fills a slot_t
+         *           stamped with the arrival time of its first byte
+         */
+        class Assembler
+        {
+        public:
+            /**
+             * @param   transport  Link of the source, copied to each slot
+             */
+            explicit Assembler(transport_e transport = transport_serial) : _transport(transport) {}
+
+            /**
+             * @brief   Move the available bytes of source to the ring buffer
+             * @param   source  Bytes source
+             * @param   now_us  Arrival time of the bytes, in microseconds
+             * @return  Number of bytes moved
+             * @note    Stop when the ring buffer is full, remaining bytes are
+             *          kept by the source until next() makes room
+             */
+            size_t fill(Source &source, int64_t now_us);
+
+            /**
+             * @brief   Parse the ring buffer until a frame is complete
+             * @param   slot  Complete frame
+             * @return  true if slot was filled
+             */
+            bool next(slot_t &slot);
+
+            /**
+             * @brief   Bytes waiting on ring buffer
+             */
+            size_t pending() const { return _count; }
+
+            /**
+             * @brief   Parser used by the assembler
+             */
+            const Parser &parser() const { return _parser; }
+
+        private:
+            uint8_t _ring[ring_size];
+            size_t _head = 0;
+            size_t _tail = 0;
+            size_t _count = 0;
+            int64_t _oldest_us = 0;
+            int64_t _frame_us = 0;
+            transport_e _transport;
+            Parser _parser;
+        }; // class Assembler
+
+        /**
+         * @class    Latency
+         * @brief    Latency counters in microseconds
+         */
+        class Latency
+        {
+        public:
+            void record(int64_t us);
+            void reset();
+            uint32_t count() const { return _count; }
+            int64_t last() const { return _last; }
+            int64_t max() const { return _max; }
+            int64_t average() const { return _count ? _sum / _count : 0; }
+
+        private:
+            uint32_t _count = 0;
+            int64_t _last = 0;
+            int64_t _max = 0;
+            int64_t _sum = 0;
+        }; // class Latency
+
+    } // namespace frame
+
+} // namespace streamDeco
+
+#endif
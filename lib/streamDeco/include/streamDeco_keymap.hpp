@@ -0,0 +1,261 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_KEYMAP_HPP_
+#define _STREAMDECO_KEYMAP_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "streamDeco_chord.hpp"
+
+namespace streamDeco
+{
+
+    /**
+     * Shortcut table image, binary layout little-endian:
+     *
+     * | magic | version | events | generation | crc16 | size | offsets ... | steps ... |
+     * |   2   |    1    |   1    |     4      |   2   |  2   | events + 1  |           |
+     *
+     * size is the whole image size and crc16 (same of frame::crc16) covers
+     * size, offsets and steps. Generation is stamped by the device when
+     * the image is stored and is left out of crc16.
+     * Offsets are 2 bytes each, relative to the first step, the steps of
+     * event n are between offsets[n] and offsets[n + 1], so an event is
+     * found without walking the table.
+     * Each step is a type byte followed by its arguments:
+     *
+     * | chord_step | report (8) |   HID keyboard report, pressed then released
+     * | media_step | media (2)  |   media keys report, pressed then released
+     * | delay_step | ms (2)     |   wait before next step
+     * | text_step  | length (1) | characters ...   ASCII text typed key by key
+     */
+    namespace keymap
+    {
+
+        constexpr uint16_t magic = 0x4B53; /* "SK" */
+        constexpr uint8_t table_version = 1;
+
+        constexpr size_t header_size = 12;
+        constexpr size_t max_image_size = 1024;
+        constexpr size_t max_sequence_size = 256;
+
+        /**
+         * @enum     step_e
+         * @brief    Step type of a shortcut sequence
+         */
+        enum step_e : uint8_t
+        {
+            chord_step = 0x01,
+            media_step = 0x02,
+            delay_step = 0x03,
+            text_step = 0x04,
+        };
+
+        /**
+         * @struct   step_s
+         * @typedef  step_t
+         * @brief    Step decoded by Cursor
+         */
+        typedef struct step_s
+        {
+            step_e type;
+            chord::report_t report; /* chord_step */
+            uint8_t media[2];       /* media_step */
+            uint16_t delay_ms;      /* delay_step */
+            const char *text;       /* text_step, points to the sequence */
+            uint8_t text_size;      /* text_step */
+        } step_t;
+
+        /**
+         * @struct   image_s
+         * @typedef  image_t
+         * @brief    Fixed size image, used as flash file
+         */
+        typedef struct image_s
+        {
+            uint8_t data[max_image_size];
+        } image_t;
+
+        /**
+         * @brief    Size of a step, type byte included
+         * @param    step       Step starting with type byte
+         * @param    available  Bytes available from step
+         * @return   0 if the step type is unknown or the step is truncated
+         */
+        size_t step_size(const uint8_t *step, size_t available);
+
+        /**
+         * @brief    Check magic, version, size, crc16, offsets and steps of an image
+         * @param    image   Image starting with magic
+         * @param    size    Bytes available on image
+         * @param    events  Number of events expected
+         * @return   true if the image can be loaded
+         */
+        bool validate(const uint8_t *image, size_t size, uint8_t events);
+
+        /**
+         * @brief    Generation stamped on a valid image
+         */
+        uint32_t generation(const uint8_t *image);
+
+        /**
+         * @brief    Image size written on header
+         */
+        size_t image_size(const uint8_t *image);
+
+        /**
+         * @class    Builder
+         * @brief    Write an image, events must be added in ascending order
+         * @code
+         * keymap::Builder builder(buffer, sizeof(buffer), event_count);
+         * builder.event(terminal_event);
+         * builder.chord(chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, KEY_RETURN).report);
+         * size_t size = builder.finish();
+         */
+        class Builder
+        {
+        public:
+            Builder(uint8_t *buffer, size_t size, uint8_t events);
+
+            /**
+             * @brief   Start the sequence of an event
+             * @return  false if the event is out of order or out of range
+             */
+            bool event(uint8_t event);
+
+            bool chord(const chord::report_t &report);
+            bool media(const uint8_t (&media)[2]);
+            bool delay(uint16_t ms);
+
+            /**
+             * @brief   Type text, split on steps of 255 characters
+             */
+            bool text(const char *text, size_t length);
+
+            /**
+             * @brief   Close the image and write header
+             * @return  Image size, 0 if any step did not fit
+             */
+            size_t finish(uint32_t generation = 0);
+
+        private:
+            bool step(step_e type, const uint8_t *data, size_t size);
+
+            uint8_t *_buffer;
+            size_t _size;
+            uint8_t _events;
+            uint8_t _event = 0;
+            size_t _index;
+            size_t _sequence_start;
+            bool _overflow = false;
+        }; // class Builder
+
+        /**
+         * @class    Cursor
+         * @brief    Walk the steps of one sequence
+         */
+        class Cursor
+        {
+        public:
+            Cursor(const uint8_t *steps, size_t size) : _steps(steps), _size(size) {}
+
+            /**
+             * @brief   Decode next step
+             * @return  false at the end of the sequence
+             */
+            bool next(step_t &step);
+
+        private:
+            const uint8_t *_steps;
+            size_t _size;
+            size_t _index = 0;
+        }; // class Cursor
+
+        /**
+         * @class    Table
+         * @brief    Double buffered shortcut table
+         * @details  Images are loaded or received on the inactive buffer and
+         *           only replace the active one after validate(), a partial
+         *           or corrupted image keeps the previous table in use
+         * @note     Not thread safe, callers serialize access
+         */
+        class Table
+        {
+        public:
+            explicit Table(uint8_t events) : _events(events) {}
+
+            /**
+             * @brief   Validate and activate a complete image
+             */
+            bool load(const uint8_t *image, size_t size);
+
+            /**
+             * @brief   Start to receive an image in chunks
+             * @param   size  Image size
+             */
+            bool begin(size_t size);
+
+            /**
+             * @brief   Receive a chunk of the image started by begin()
+             * @param   offset  Chunk position on image
+             */
+            bool write(size_t offset, const uint8_t *data, size_t size);
+
+            /**
+             * @brief   Validate and activate the received image
+             * @return  false if chunks are missing or image is invalid
+             */
+            bool commit();
+
+            /**
+             * @brief   Copy the steps of an event
+             * @param   steps  Output buffer, max_sequence_size is enough
+             * @return  Number of bytes copied, 0 if the event has no shortcut
+             */
+            size_t sequence(uint8_t event, uint8_t *steps, size_t size) const;
+
+            /**
+             * @brief   Stamp the generation of the active image
+             */
+            void stamp(uint32_t generation);
+
+            const uint8_t *image() const { return _images[_active]; }
+            size_t size() const { return image_size(image()); }
+            uint32_t generation() const { return keymap::generation(image()); }
+            bool loaded() const { return _loaded; }
+
+        private:
+            uint8_t _images[2][max_image_size];
+            uint8_t _events;
+            uint8_t _active = 0;
+            bool _loaded = false;
+            size_t _staged_size = 0;
+            size_t _staged_bytes = 0;
+        }; // class Table
+
+    } // namespace keymap
+
+} // namespace streamDeco
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_MACRO_HPP_
+#define _STREAMDECO_MACRO_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "streamDeco_chord.hpp"
+#include "streamDeco_keymap.hpp"
+
+namespace streamDeco
+{
+
+    /**
+     * Macro player, turns a keymap sequence into the HID reports to send.
+     *
+     * Chords and media keys are pressed then released, a delay is waited
+     * with all keys released. Text keystrokes are coalesced: the report of
+     * next character replaces the current one, releasing the previous key
+     * and pressing the next in one report. A release report is only sent
+     * between two equal keys, so "hello" is 7 reports instead of 10.
+     */
+    namespace macro
+    {
+
+        /**
+         * @struct   report_s
+         * @typedef  report_t
+         * @brief    Report to send
+         */
+        typedef struct report_s
+        {
+            bool media;               /* media keys report, 2 bytes */
+            uint8_t data[sizeof(chord::report_t)];
+            uint16_t delay_ms;        /* wait before sending */
+        } report_t;
+
+        /**
+         * @brief    HID report of an ASCII character
+         * @return   false if the character has no key
+         */
+        bool key(char character, chord::report_t &report);
+
+        /**
+         * @class    Player
+         * @brief    Generate the reports of a sequence one by one
+         * @code
+         * macro::Player player;
+         * player.load(steps, size);
+         * while (player.next(report))
+         *     send(report);
+         */
+        class Player
+        {
+        public:
+            /**
+             * @brief   Copy a sequence and restart
+             * @return  false if the sequence is too long
+             */
+            bool load(const uint8_t *steps, size_t size);
+
+            /**
+             * @brief   Next report to send
+             * @return  false when the sequence is over and all keys are released
+             */
+            bool next(report_t &report);
+
+            /**
+             * @brief   Characters typed by text steps since load()
+             */
+            uint32_t characters() const { return _characters; }
+
+            /**
+             * @brief   Reports generated since load()
+             */
+            uint32_t reports() const { return _reports; }
+
+        private:
+            enum held_e : uint8_t
+            {
+                held_none,
+                held_chord,
+                held_media,
+                held_text,
+            };
+
+            bool emit(report_t &report, bool media, const uint8_t *data, size_t size);
+            bool release(report_t &report);
+
+            uint8_t _steps[keymap::max_sequence_size];
+            size_t _size = 0;
+            size_t _index = 0;
+            keymap::step_t _step = {};
+            bool _step_active = false;
+            uint8_t _text_index = 0;
+            held_e _held = held_none;
+            uint8_t _held_key = 0;
+            uint16_t _delay_ms = 0;
+            uint32_t _characters = 0;
+            uint32_t _reports = 0;
+        }; // class Player
+
+    } // namespace macro
+
+} // namespace streamDeco
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _STREAMDECO_MEMORY_HPP_
+#define _STREAMDECO_MEMORY_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace streamDeco
+{
+
+    /**
+     * Memory telemetry.
+     *
+     * A Probe reads free bytes, largest free block and minimum free ever of
+     * each pool: internal RAM and PSRAM from heap_caps on target, the LVGL
+     * TLSF pool from lv_mem_monitor, a modeled heap on the native simulator.
+     * Telemetry keeps the last samples on a ring buffer and calls its listener
+     * when the fragmentation of a pool crosses the threshold:
+     *
+     * fragmentation = 100 - largest free block * 100 / free bytes
+     *
+     * The same formula of lv_mem_monitor. A pool is armed again once its
+     * fragmentation drops hysteresis points below the threshold.
+     */
+    namespace memory
+    {
+
+        constexpr size_t history_size = 32; /* samples, about 2.5 minutes every 5 s */
+        constexpr uint8_t default_threshold = 50;
+        constexpr uint8_t hysteresis = 10;
+
+        /**
+         * @enum     pool_e
+         * @brief    Memory pools sampled
+         */
+        enum pool_e : uint8_t
+        {
+            internal_pool, /* internal SRAM, MALLOC_CAP_INTERNAL */
+            psram_pool,    /* external PSRAM, MALLOC_CAP_SPIRAM */
+            lvgl_pool,     /* LVGL TLSF pool, LV_MEM_SIZE */
+            pool_count,
+        };
+
+        /**
+         * @struct   usage_s
+         * @typedef  usage_t
+         * @brief    Usage of one pool in bytes
+         */
+        typedef struct usage_s
+        {
+            uint32_t total;
+            uint32_t free;
+            uint32_t largest;  /* largest free block */
+            uint32_t min_free; /* minimum free bytes since boot */
+        } usage_t;
+
+        /**
+         * @struct   sample_s
+         * @typedef  sample_t
+         * @brief    Usage of all pools at one time
+         */
+        typedef struct sample_s
+        {
+            int64_t us;
+            usage_t pools[pool_count];
+        } sample_t;
+
+        /**
+         * @brief    Short name of a pool
+         */
+        const char *name(pool_e pool);
+
+        /**
+         * @brief    Fragmentation of a pool
+         * @return   0 when the free bytes are one block, near 100 when scattered
+         */
+        uint8_t fragmentation(const usage_t &usage);
+
+        /**
+         * @class    Probe
+         * @brief    Reads the usage of pools
+         * @details  Implemented with heap_caps and lv_mem_monitor on target,
+         *           with a modeled heap on host tests
+         */
+        class Probe
+        {
+        public:
+            virtual ~Probe() = default;
+
+            /**
+             * @brief   Read the usage of a pool
+             * @return  false if the pool is not available, usage is zeroed
+             */
+            virtual bool read(pool_e pool, usage_t &usage) = 0;
+        }; // class Probe
+
+        /**
+         * @typedef  listener_t
+         * @brief    Called by Telemetry::sample when a pool crosses the threshold
+         */
+        typedef void (*listener_t)(pool_e pool, const usage_t &usage, uint8_t fragmentation);
+
+        /**
+         * @class    Telemetry
+         * @brief    Ring buffer of memory samples
+         * @details  Not thread safe, sample() and the readers must run on the same task
+         */
+        class Telemetry
+        {
+        public:
+            explicit Telemetry(uint8_t threshold = default_threshold) : _threshold(threshold) {}
+
+            /**
+             * @brief   Listener of fragmentation events, nullptr to remove it
+             */
+            void set_listener(listener_t listener) { _listener = listener; }
+
+            /**
+             * @brief   Fragmentation percentage that raises an event
+             */
+            void set_threshold(uint8_t threshold) { _threshold = threshold; }
+
+            uint8_t threshold() const { return _threshold; }
+
+            /**
+             * @brief   Read all pools and keep the sample
+             * @param   probe   Source of the usage
+             * @param   now_us  Time of the sample
+             * @return  Number of pools that crossed the threshold on this sample
+             */
+            size_t sample(Probe &probe, int64_t now_us);
+
+            /**
+             * @brief   Number of samples kept, up to history_size
+             */
+            size_t count() const { return _count < history_size ? _count : history_size; }
+
+            /**
+             * @brief   Last sample, zeroed before the first one
+             */
+            const sample_t &last() const { return _samples[(_count + history_size - 1) % history_size]; }
+
+            /**
+             * @brief   Copy the samples kept, oldest first
+             * @return  Number of samples copied
+             */
+            size_t history(sample_t *samples, size_t size) const;
+
+            /**
+             * @brief   Free bytes lost from the oldest to the last sample kept
+             * @return  Positive while the pool is shrinking, a leak if it keeps growing
+             */
+            int64_t growth(pool_e pool) const;
+
+            /**
+             * @brief   Pools over the threshold, bit 1 << pool_e
+             */
+            uint32_t fragmented() const { return _fragmented; }
+
+            /**
+             * @brief   Fragmentation events raised since the last reset
+             */
+            uint32_t events() const { return _events; }
+
+            /**
+             * @brief   Discard all samples and events
+             */
+            void reset();
+
+        private:
+            sample_t _samples[history_size] = {};
+            size_t _count = 0;
+            uint8_t _threshold;
+            uint32_t _fragmented = 0;
+            uint32_t _events = 0;
+            listener_t _listener = nullptr;
+        }; // class Telemetry
+
+    } // namespace memory
+
+} // namespace streamDeco
+
+#endif
@@ -33,6 +33,38 @@ namespace streamDeco
     namespace metric
     {
 
+        /**
+         * @brief    Last rendered value of a metric widget
+         * @details  A new value is rendered only when it moves more than deadband
+         *           from the last rendered one or when its text affixes change
+         */
+        class Cached
+        {
+        public:
+            bool update(int32_t value, const char *prefix = nullptr, const char *sufix = nullptr, int32_t value2 = 0);
+            void invalidate() { valid = false; }
+            int32_t deadband = 0;
+        private:
+            bool valid = false;
+            int32_t last = 0;
+            int32_t last2 = 0;
+            const char *last_prefix = nullptr;
+            const char *last_sufix = nullptr;
+        }; // class Cached
+
+        /**
+         * @brief    Last rendered range of a bar widget
+         */
+        class Range
+        {
+        public:
+            bool update(int32_t min, int32_t max);
+        private:
+            bool valid = false;
+            int32_t min = 0;
+            int32_t max = 0;
+        }; // class Range
+
         class Complete : public lvgl::Object
         {
         public:
@@ -48,6 +80,7 @@ namespace streamDeco
             void bar2_set_range(int32_t min, int32_t max);
             void bar1_set_value(int32_t value, const char *prefix, const char *sufix = "");
             void bar2_set_value(int32_t value, const char *prefix, const char *sufix = "");
+            void set_deadband(int32_t arc_deadband, int32_t bar1_deadband, int32_t bar2_deadband);
         protected:
             template <typename Action>
             void with_lock(Action action)
@@ -72,6 +105,11 @@ namespace streamDeco
             lvgl::Label bar1_label;
             lvgl::Bar bar2;
             lvgl::Label bar2_label;
+            Cached arc_cache;
+            Cached bar1_cache;
+            Cached bar2_cache;
+            Range bar1_range;
+            Range bar2_range;
         }; // class Complete
 
         class Basic : public lvgl::Object
@@ -87,6 +125,7 @@ namespace streamDeco
             void bar2_set_range(int32_t min, int32_t max);
             void bar1_set_value(int32_t value, const char *prefix, const char *sufix = "");
             void bar2_set_value(int32_t value, int32_t value2, const char *prefix, const char *sufix = "");
+            void set_deadband(int32_t bar1_deadband, int32_t bar2_deadband);
         private:
             template <typename Action>
             void with_lock(Action action)
@@ -109,6 +148,10 @@ namespace streamDeco
             lvgl::Label bar1_label;
             lvgl::Bar bar2;
             lvgl::Label bar2_label;
+            Cached bar1_cache;
+            Cached bar2_cache;
+            Range bar1_range;
+            Range bar2_range;
         }; // class Basic
 
         class Clock : public lvgl::Object
@@ -134,6 +177,8 @@ namespace streamDeco
             const char *text_scr = nullptr;
             lvgl::icon_t icon_scr = nullptr;
             int wday = 0;
+            struct tm last_time = {};
+            bool time_valid = false;
             lvgl::Label monitor_label;
             lvgl::Image monitor_icon;
             lvgl::Label date;
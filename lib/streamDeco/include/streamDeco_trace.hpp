@@ -0,0 +1,162 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _STREAMDECO_TRACE_HPP_
+#define _STREAMDECO_TRACE_HPP_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace streamDeco
+{
+
+    /**
+     * Tap to keystroke tracing.
+     *
+     * Each tap gets an id on the button event, every stage of the path
+     * records its timestamp with that id on a lock free ring buffer:
+     *
+     * touch interrupt > LVGL input read > button event > buttons task wake
+     * > reports queued > last HID report notified
+     *
+     * summary() reports p50/p99 of the time spent on each stage, measured
+     * from the previous stage recorded by the same tap. Timestamps are 32 bits
+     * microseconds, enough for stages shorter than one hour.
+     */
+    namespace trace
+    {
+
+        constexpr size_t ring_size = 128; /* records, about 20 taps */
+
+        /**
+         * @enum     stage_e
+         * @brief    Stages of the tap to keystroke path, in order
+         */
+        enum stage_e : uint8_t
+        {
+            touch_stage,  /* touch controller interrupt */
+            input_stage,  /* LVGL input read the touch sample */
+            event_stage,  /* LVGL button event callback */
+            wake_stage,   /* buttons task woke up */
+            queued_stage, /* reports queued by process_event */
+            notify_stage, /* last HID report notified */
+            stage_count,
+        };
+
+        /**
+         * @struct   record_s
+         * @typedef  record_t
+         * @brief    Timestamp of one stage of one tap
+         */
+        typedef struct record_s
+        {
+            uint32_t tap;
+            stage_e stage;
+            uint32_t us;
+        } record_t;
+
+        /**
+         * @struct   stats_s
+         * @typedef  stats_t
+         * @brief    Latency percentiles in microseconds
+         */
+        typedef struct stats_s
+        {
+            uint32_t count;
+            uint32_t p50;
+            uint32_t p99;
+            uint32_t max;
+        } stats_t;
+
+        /**
+         * @brief    Short name of a stage
+         */
+        const char *name(stage_e stage);
+
+        /**
+         * @class    Tracer
+         * @brief    Ring buffer of stage records
+         * @details  record() is wait free and can be called from any task,
+         *           the oldest records are overwritten. Readers skip records
+         *           being written with a sequence number
+         */
+        class Tracer
+        {
+        public:
+            /**
+             * @brief   Start a new tap
+             * @return  Id of the tap, also returned by current()
+             */
+            uint32_t begin();
+
+            /**
+             * @brief   Id of the last tap started
+             */
+            uint32_t current() const { return _tap.load(std::memory_order_acquire); }
+
+            /**
+             * @brief   Record a stage of a tap
+             * @param   us  Timestamp of the stage in microseconds, truncated to 32 bits
+             */
+            void record(uint32_t tap, stage_e stage, int64_t us);
+
+            /**
+             * @brief   Copy the valid records, oldest first
+             * @return  Number of records copied
+             */
+            size_t snapshot(record_t *records, size_t size) const;
+
+            /**
+             * @brief   Latency of each stage and of the whole path
+             * @param   stages  Time from previous stage of the same tap, touch_stage
+             *                  has no previous stage and only counts taps
+             * @param   total   Time from the first to the last stage of complete taps
+             */
+            void summary(stats_t (&stages)[stage_count], stats_t &total) const;
+
+            /**
+             * @brief   Discard all records
+             */
+            void reset();
+
+        private:
+            typedef struct entry_s
+            {
+                std::atomic<uint32_t> sequence; /* index + 1 when valid, 0 while written */
+                std::atomic<uint32_t> key;      /* tap << 8 | stage */
+                std::atomic<uint32_t> us;
+            } entry_t;
+
+            bool load(uint32_t index, uint32_t &key, uint32_t &us) const;
+
+            entry_t _entries[ring_size] = {};
+            std::atomic<uint32_t> _head{0};
+            std::atomic<uint32_t> _tap{0};
+        }; // class Tracer
+
+    } // namespace trace
+
+} // namespace streamDeco
+
+#endif
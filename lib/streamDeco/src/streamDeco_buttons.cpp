@@ -199,7 +199,7 @@ namespace streamDeco
 
   void MainButton::callback(lvgl::event::callback_t callback, lvgl::event::code_t code, int user_data)
   {
-    with_lock([&]() { add_event_cb(callback, code, (void *)user_data); });
+    with_lock([&]() { add_event_cb(callback, code, (void *)(intptr_t)user_data); });
   } // MainButton::callback
 
   void MainButton::iconSwap()
@@ -210,6 +210,13 @@ namespace streamDeco
     with_lock([&]() { state.icon_now ? icon.set_src(icon1_scr) : icon.set_src(icon2_scr); });
   } // MainButton::iconSwap
 
+  void MainButton::setToggled(bool on)
+  {
+    if (state.icon_now == on)
+      iconSwap();
+    on ? pin() : unpin();
+  } // MainButton::setToggled
+
   void MainButton::apply_pin_state(bool pinned)
   {
     if (pinned)
@@ -0,0 +1,270 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streamDeco_executor.hpp"
+
+namespace streamDeco
+{
+
+    namespace executor
+    {
+
+        const char *name(message_e type)
+        {
+            static const char *const names[message_count] = {
+                "button", "sent", "feedback", "ingest", "frame",
+                "tick", "idle", "memory", "dump", "save"};
+            return type < message_count ? names[type] : "unknown";
+        } // executor::name
+
+        void Executor::on(message_e type, handler_t handler, priority_e priority, bool coalesce)
+        {
+            if (type < message_count && priority < priority_count)
+                _routes[type] = {handler, priority, coalesce};
+        } // Executor::on
+
+        bool Executor::post(message_e type, uint32_t value, uint32_t tap)
+        {
+            if (type >= message_count)
+                return false;
+            return push({type, value, _now(), tap});
+        } // Executor::post
+
+        bool Executor::push(const message_t &message)
+        {
+            const route_t &route = _routes[message.type];
+            if (!route.handler)
+                return false;
+            ring_t &ring = _rings[route.priority];
+
+            if (route.coalesce)
+            {
+                for (uint8_t index = 0; index < ring.count; index++)
+                {
+                    const message_t &waiting = ring.messages[(ring.head + index) % queue_size];
+                    if (waiting.type == message.type && waiting.value == message.value)
+                    {
+                        _queue_stats.coalesced++;
+                        return true;
+                    }
+                }
+            }
+
+            if (ring.count == queue_size)
+            {
+                _queue_stats.dropped++;
+                return false;
+            }
+
+            ring.messages[(ring.head + ring.count) % queue_size] = message;
+            ring.count++;
+            _queue_stats.posted++;
+            _queue_stats.depth++;
+            if (_queue_stats.depth > _queue_stats.max_depth)
+                _queue_stats.max_depth = _queue_stats.depth;
+            return true;
+        } // Executor::push
+
+        timer_id_t Executor::schedule(message_e type, uint32_t value, int64_t delay_us, int64_t period_us)
+        {
+            if (type >= message_count)
+                return no_timer;
+
+            for (timer_id_t timer = 0; timer < max_timers; timer++)
+            {
+                if (_timers[timer].used)
+                    continue;
+                _timers[timer] = {_now() + delay_us, delay_us, period_us, value, type, true, no_timer};
+                heap_insert(timer);
+                return timer;
+            }
+            return no_timer;
+        } // Executor::schedule
+
+        void Executor::restart(timer_id_t timer)
+        {
+            if (timer >= max_timers || !_timers[timer].used)
+                return;
+            heap_remove(timer);
+            _timers[timer].due_us = _now() + _timers[timer].delay_us;
+            heap_insert(timer);
+        } // Executor::restart
+
+        void Executor::period(timer_id_t timer, int64_t period_us)
+        {
+            if (timer >= max_timers || !_timers[timer].used)
+                return;
+            if (period_us <= 0)
+            {
+                stop(timer);
+                return;
+            }
+            _timers[timer].delay_us = period_us;
+            _timers[timer].period_us = period_us;
+            restart(timer);
+        } // Executor::period
+
+        void Executor::stop(timer_id_t timer)
+        {
+            if (timer < max_timers && _timers[timer].used)
+                heap_remove(timer);
+        } // Executor::stop
+
+        bool Executor::next(message_t &message)
+        {
+            const int64_t now = _now();
+            while (_heap_size && _timers[_heap[0]].due_us <= now)
+            {
+                const timer_id_t id = _heap[0];
+                timer_slot_t &timer = _timers[id];
+                push({timer.type, timer.value, timer.due_us, 0});
+                heap_remove(id);
+                if (timer.period_us > 0)
+                {
+                    /* Missed periods are skipped, not posted in a burst */
+                    timer.due_us += timer.period_us;
+                    if (timer.due_us <= now)
+                        timer.due_us = now + timer.period_us;
+                    heap_insert(id);
+                }
+            }
+
+            for (ring_t &ring : _rings)
+            {
+                if (!ring.count)
+                    continue;
+                message = ring.messages[ring.head];
+                ring.head = (ring.head + 1) % queue_size;
+                ring.count--;
+                _queue_stats.depth--;
+                return true;
+            }
+            return false;
+        } // Executor::next
+
+        int64_t Executor::wait_us() const
+        {
+            if (_queue_stats.depth)
+                return 0;
+            if (!_heap_size)
+                return -1;
+            const int64_t wait = _timers[_heap[0]].due_us - _now();
+            return wait > 0 ? wait : 0;
+        } // Executor::wait_us
+
+        void Executor::dispatch(const message_t &message)
+        {
+            if (message.type >= message_count)
+                return;
+            const handler_t handler = _routes[message.type].handler;
+            if (!handler)
+                return;
+
+            const int64_t start = _now();
+            handler(message);
+            const int64_t elapsed = _now() - start;
+
+            handler_stats_t &stats = _stats[message.type];
+            stats.count++;
+            stats.total_us += elapsed;
+            if (elapsed > stats.max_us)
+                stats.max_us = elapsed;
+            if (start - message.posted_us > stats.wait_max_us)
+                stats.wait_max_us = start - message.posted_us;
+        } // Executor::dispatch
+
+        void Executor::reset_stats()
+        {
+            for (handler_stats_t &stats : _stats)
+                stats = {};
+            const uint32_t depth = _queue_stats.depth;
+            _queue_stats = {};
+            _queue_stats.depth = depth;
+            _queue_stats.max_depth = depth;
+        } // Executor::reset_stats
+
+        void Executor::heap_insert(timer_id_t timer)
+        {
+            _timers[timer].heap = _heap_size;
+            _heap[_heap_size] = timer;
+            _heap_size++;
+            sift_up(_timers[timer].heap);
+        } // Executor::heap_insert
+
+        void Executor::heap_remove(timer_id_t timer)
+        {
+            const uint8_t index = _timers[timer].heap;
+            if (index == no_timer)
+                return;
+
+            _heap_size--;
+            if (index != _heap_size)
+            {
+                heap_swap(index, _heap_size);
+                sift_up(index);
+                sift_down(index);
+            }
+            _timers[timer].heap = no_timer;
+        } // Executor::heap_remove
+
+        void Executor::heap_swap(uint8_t a, uint8_t b)
+        {
+            const timer_id_t timer = _heap[a];
+            _heap[a] = _heap[b];
+            _heap[b] = timer;
+            _timers[_heap[a]].heap = a;
+            _timers[_heap[b]].heap = b;
+        } // Executor::heap_swap
+
+        void Executor::sift_up(uint8_t index)
+        {
+            while (index)
+            {
+                const uint8_t parent = (index - 1) / 2;
+                if (_timers[_heap[parent]].due_us <= _timers[_heap[index]].due_us)
+                    return;
+                heap_swap(index, parent);
+                index = parent;
+            }
+        } // Executor::sift_up
+
+        void Executor::sift_down(uint8_t index)
+        {
+            while (true)
+            {
+                const uint8_t left = index * 2 + 1;
+                const uint8_t right = left + 1;
+                uint8_t first = index;
+                if (left < _heap_size && _timers[_heap[left]].due_us < _timers[_heap[first]].due_us)
+                    first = left;
+                if (right < _heap_size && _timers[_heap[right]].due_us < _timers[_heap[first]].due_us)
+                    first = right;
+                if (first == index)
+                    return;
+                heap_swap(index, first);
+                index = first;
+            }
+        } // Executor::sift_down
+
+    } // namespace executor
+
+} // namespace streamDeco
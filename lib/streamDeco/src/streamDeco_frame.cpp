@@ -0,0 +1,424 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streamDeco_frame.hpp"
+#include <limits.h>
+#include <string.h>
+
+namespace streamDeco
+{
+
+    namespace frame
+    {
+
+        namespace
+        {
+
+            constexpr size_t text_fields = 17;
+            constexpr size_t text_metric_fields = 10;
+
+            /* CRC-16/CCITT-FALSE of each byte value, one lookup per byte instead of 8 shifts */
+            struct CrcTable
+            {
+                uint16_t values[256];
+
+                constexpr CrcTable() : values()
+                {
+                    for (uint16_t byte = 0; byte < 256; ++byte)
+                    {
+                        uint16_t crc = byte << 8;
+                        for (uint8_t bit = 0; bit < 8; ++bit)
+                            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+                        values[byte] = crc;
+                    }
+                }
+            }; // struct CrcTable
+
+            constexpr CrcTable crc_table;
+            static_assert(crc_table.values[1] == 0x1021, "CRC-16/CCITT table");
+
+            class Writer
+            {
+            public:
+                explicit Writer(uint8_t *buffer) : pointer(buffer) {}
+                void u8(uint8_t value) { *pointer++ = value; }
+                void u16(uint16_t value)
+                {
+                    u8(value & 0xFF);
+                    u8(value >> 8);
+                }
+                void u32(uint32_t value)
+                {
+                    u16(value & 0xFFFF);
+                    u16(value >> 16);
+                }
+            private:
+                uint8_t *pointer;
+            }; // class Writer
+
+            class Reader
+            {
+            public:
+                explicit Reader(const uint8_t *buffer) : pointer(buffer) {}
+                uint8_t u8() { return *pointer++; }
+                uint16_t u16()
+                {
+                    uint16_t low = u8();
+                    return low | (static_cast<uint16_t>(u8()) << 8);
+                }
+                uint32_t u32()
+                {
+                    uint32_t low = u16();
+                    return low | (static_cast<uint32_t>(u16()) << 16);
+                }
+            private:
+                const uint8_t *pointer;
+            }; // class Reader
+
+            bool is_text_byte(uint8_t byte)
+            {
+                return (byte >= '0' && byte <= '9') || byte == '-' || byte == ',' || byte == ' ';
+            }
+
+            /* Text is not NUL terminated, digits are read up to end only */
+            bool parse_field(const char *&text, const char *end, long &value)
+            {
+                const char *cursor = text;
+                bool negative = cursor < end && *cursor == '-';
+                if (negative) ++cursor;
+
+                const char *digits = cursor;
+                long result = 0;
+                while (cursor < end && *cursor >= '0' && *cursor <= '9')
+                {
+                    if (result > (LONG_MAX - 9) / 10) return false;
+                    result = result * 10 + (*cursor++ - '0');
+                }
+                if (cursor == digits) return false;
+
+                value = negative ? -result : result;
+                text = cursor;
+                return true;
+            }
+
+            /* Check sync, version, length and crc of a binary frame */
+            bool check(const uint8_t *data, size_t length)
+            {
+                if (data == nullptr || length < header_size + crc_size) return false;
+                if (data[0] != sync_byte || data[1] != protocol_version) return false;
+
+                const size_t payload_size = data[3];
+                if (length != header_size + payload_size + crc_size) return false;
+
+                const size_t crc_index = header_size + payload_size;
+                const uint16_t crc = data[crc_index] | (data[crc_index + 1] << 8);
+                return crc == crc16(&data[1], crc_index - 1);
+            }
+
+        } // namespace
+
+        uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc)
+        {
+            while (length--)
+                crc = (crc << 8) ^ crc_table.values[(crc >> 8) ^ *data++];
+            return crc;
+        } // frame::crc16
+
+        size_t encode(const metrics_t &metrics, uint8_t *buffer, size_t size)
+        {
+            constexpr size_t frame_size = header_size + metrics_payload_size + crc_size;
+            if (buffer == nullptr || size < frame_size) return 0;
+
+            Writer writer(buffer);
+            writer.u8(sync_byte);
+            writer.u8(protocol_version);
+            writer.u8(metrics_type);
+            writer.u8(metrics_payload_size);
+            writer.u16(metrics.cpu_load);
+            writer.u16(metrics.cpu_temp);
+            writer.u16(metrics.cpu_freq);
+            writer.u16(metrics.gpu_load);
+            writer.u16(metrics.gpu_temp);
+            writer.u16(metrics.gpu_freq);
+            writer.u32(metrics.mem_used);
+            writer.u32(metrics.mem_max);
+            writer.u32(metrics.disk_used);
+            writer.u32(metrics.disk_max);
+            writer.u8(metrics.sec);
+            writer.u8(metrics.min);
+            writer.u8(metrics.hour);
+            writer.u8(metrics.wday);
+            writer.u8(metrics.mday);
+            writer.u8(metrics.month);
+            writer.u16(metrics.year);
+            writer.u16(crc16(&buffer[1], frame_size - 1 - crc_size));
+            return frame_size;
+        } // frame::encode
+
+        bool decode(const uint8_t *data, size_t length, metrics_t &metrics)
+        {
+            if (!check(data, length)) return false;
+            if (data[2] != metrics_type || data[3] < metrics_payload_size) return false;
+
+            Reader reader(&data[header_size]);
+            metrics.cpu_load = reader.u16();
+            metrics.cpu_temp = reader.u16();
+            metrics.cpu_freq = reader.u16();
+            metrics.gpu_load = reader.u16();
+            metrics.gpu_temp = reader.u16();
+            metrics.gpu_freq = reader.u16();
+            metrics.mem_used = reader.u32();
+            metrics.mem_max = reader.u32();
+            metrics.disk_used = reader.u32();
+            metrics.disk_max = reader.u32();
+            metrics.sec = reader.u8();
+            metrics.min = reader.u8();
+            metrics.hour = reader.u8();
+            metrics.wday = reader.u8();
+            metrics.mday = reader.u8();
+            metrics.month = reader.u8();
+            metrics.year = reader.u16();
+            metrics.clock_valid = metrics.year != 0;
+            return true;
+        } // frame::decode
+
+        bool decode_payload(const uint8_t *data, size_t length, payload_t &payload)
+        {
+            if (!check(data, length)) return false;
+            if (data[2] != shortcuts_type && data[2] != request_type) return false;
+            if (data[3] > max_payload_size) return false;
+
+            payload.size = data[3];
+            memcpy(payload.data, &data[header_size], payload.size);
+            return true;
+        } // frame::decode_payload
+
+        bool decode_text(const char *text, size_t length, metrics_t &metrics)
+        {
+            if (text == nullptr) return false;
+
+            long values[text_fields];
+            size_t count = 0;
+            const char *end = text + length;
+
+            while (text < end && *text != text_terminator && count < text_fields)
+            {
+                if (!parse_field(text, end, values[count])) return false;
+                count++;
+                while (text < end && (*text == ' ' || *text == ',')) ++text;
+            }
+
+            if (count < text_metric_fields) return false;
+
+            metrics.cpu_load = values[0];
+            metrics.cpu_temp = values[1];
+            metrics.cpu_freq = values[2];
+            metrics.gpu_load = values[3];
+            metrics.gpu_temp = values[4];
+            metrics.gpu_freq = values[5];
+            metrics.mem_used = values[6];
+            metrics.mem_max = values[7];
+            metrics.disk_used = values[8];
+            metrics.disk_max = values[9];
+
+            metrics.clock_valid = count == text_fields;
+            if (metrics.clock_valid)
+            {
+                metrics.sec = values[10];
+                metrics.min = values[11];
+                metrics.hour = values[12];
+                metrics.wday = values[13];
+                metrics.mday = values[14];
+                metrics.month = values[15];
+                metrics.year = values[16];
+            }
+            return true;
+        } // frame::decode_text
+
+        Parser::result_e Parser::push(uint8_t byte)
+        {
+            switch (_state)
+            {
+            case idle:
+                if (byte == sync_byte)
+                {
+                    _state = binary;
+                    _expected = header_size;
+                }
+                else if (is_text_byte(byte))
+                {
+                    _state = text;
+                }
+                else
+                {
+                    return pending; // line noise between frames
+                }
+                _index = 0;
+                _buffer[_index++] = byte;
+                return pending;
+
+            case binary:
+                _buffer[_index++] = byte;
+                if (_index == header_size)
+                {
+                    if (_buffer[1] != protocol_version || _buffer[3] > max_payload_size) return fail();
+                    _expected = header_size + _buffer[3] + crc_size;
+                }
+                if (_index < _expected) return pending;
+                _state = idle;
+                if (_buffer[2] == metrics_type)
+                {
+                    if (!decode(_buffer, _index, _metrics)) return fail();
+                }
+                else if (!decode_payload(_buffer, _index, _payload))
+                {
+                    return fail();
+                }
+                _type = static_cast<type_e>(_buffer[2]);
+                _format = format_binary;
+                return complete;
+
+            case text:
+                if (byte == static_cast<uint8_t>(text_terminator))
+                {
+                    _state = idle;
+                    if (!decode_text(reinterpret_cast<const char *>(_buffer), _index, _metrics)) return fail();
+                    _type = metrics_type;
+                    _format = format_text;
+                    return complete;
+                }
+                if (_index >= max_text_size || !is_text_byte(byte)) return fail();
+                _buffer[_index++] = byte;
+                return pending;
+            }
+            return pending;
+        } // Parser::push
+
+        void Parser::reset()
+        {
+            _state = idle;
+            _index = 0;
+            _expected = 0;
+        } // Parser::reset
+
+        Parser::result_e Parser::fail()
+        {
+            ++_errors;
+            reset();
+            return error;
+        } // Parser::fail
+
+        size_t Assembler::fill(Source &source, int64_t now_us)
+        {
+            if (_count == 0) _oldest_us = now_us;
+
+            size_t total = 0;
+            while (_count < ring_size)
+            {
+                // contiguous free space after head
+                size_t space = (_head >= _tail ? ring_size - _head : _tail - _head);
+                if (space > ring_size - _count) space = ring_size - _count;
+
+                size_t received = source.read(&_ring[_head], space);
+                if (received == 0) break;
+
+                _head = (_head + received) % ring_size;
+                _count += received;
+                total += received;
+            }
+            return total;
+        } // Assembler::fill
+
+        size_t Channel::write(const uint8_t *data, size_t size)
+        {
+            size_t head = _head.load(std::memory_order_relaxed);
+            size_t tail = _tail.load(std::memory_order_acquire);
+            size_t space = ring_size - 1 - (head + ring_size - tail) % ring_size;
+            size_t accepted = size < space ? size : space;
+
+            for (size_t i = 0; i < accepted; i++)
+                _ring[(head + i) % ring_size] = data[i];
+            _head.store((head + accepted) % ring_size, std::memory_order_release);
+
+            _dropped += size - accepted;
+            return accepted;
+        } // Channel::write
+
+        size_t Channel::read(uint8_t *data, size_t size)
+        {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            size_t head = _head.load(std::memory_order_acquire);
+            size_t available = (head + ring_size - tail) % ring_size;
+            if (size > available)
+                size = available;
+
+            for (size_t i = 0; i < size; i++)
+                data[i] = _ring[(tail + i) % ring_size];
+            _tail.store((tail + size) % ring_size, std::memory_order_release);
+            return size;
+        } // Channel::read
+
+        bool Assembler::next(slot_t &slot)
+        {
+            while (_count > 0)
+            {
+                if (!_parser.busy()) _frame_us = _oldest_us;
+
+                uint8_t byte = _ring[_tail];
+                _tail = (_tail + 1) % ring_size;
+                --_count;
+
+                if (_parser.push(byte) == Parser::complete)
+                {
+                    slot.type = _parser.type();
+                    if (slot.type == metrics_type)
+                        slot.metrics = _parser.metrics();
+                    else
+                        slot.payload = _parser.payload();
+                    slot.format = _parser.format();
+                    slot.transport = _transport;
+                    slot.arrival_us = _frame_us;
+                    return true;
+                }
+            }
+            return false;
+        } // Assembler::next
+
+        void Latency::record(int64_t us)
+        {
+            _last = us;
+            if (us > _max) _max = us;
+            _sum += us;
+            ++_count;
+        } // Latency::record
+
+        void Latency::reset()
+        {
+            _count = 0;
+            _last = 0;
+            _max = 0;
+            _sum = 0;
+        } // Latency::reset
+
+    } // namespace frame
+
+} // namespace streamDeco
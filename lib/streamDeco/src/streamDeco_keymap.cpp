@@ -0,0 +1,316 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streamDeco_keymap.hpp"
+#include "streamDeco_frame.hpp"
+#include <string.h>
+
+namespace streamDeco
+{
+
+    namespace keymap
+    {
+
+        namespace
+        {
+
+            constexpr size_t magic_index = 0;
+            constexpr size_t version_index = 2;
+            constexpr size_t events_index = 3;
+            constexpr size_t generation_index = 4;
+            constexpr size_t crc_index = 8;
+            constexpr size_t size_index = 10;
+
+            uint16_t get_u16(const uint8_t *data)
+            {
+                return data[0] | (static_cast<uint16_t>(data[1]) << 8);
+            }
+
+            uint32_t get_u32(const uint8_t *data)
+            {
+                return get_u16(data) | (static_cast<uint32_t>(get_u16(data + 2)) << 16);
+            }
+
+            void put_u16(uint8_t *data, uint16_t value)
+            {
+                data[0] = value & 0xFF;
+                data[1] = value >> 8;
+            }
+
+            void put_u32(uint8_t *data, uint32_t value)
+            {
+                put_u16(data, value & 0xFFFF);
+                put_u16(data + 2, value >> 16);
+            }
+
+            size_t steps_index(uint8_t events)
+            {
+                return header_size + (events + 1) * 2;
+            }
+
+        } // namespace
+
+        size_t step_size(const uint8_t *step, size_t available)
+        {
+            if (available == 0) return 0;
+
+            size_t size = 0;
+            switch (step[0])
+            {
+            case chord_step:
+                size = 1 + sizeof(chord::report_t);
+                break;
+            case media_step:
+                size = 1 + 2;
+                break;
+            case delay_step:
+                size = 1 + 2;
+                break;
+            case text_step:
+                size = available < 2 ? 0 : 2 + step[1];
+                break;
+            }
+            return size <= available ? size : 0;
+        } // keymap::step_size
+
+        bool validate(const uint8_t *image, size_t size, uint8_t events)
+        {
+            if (image == nullptr || size < header_size) return false;
+            if (get_u16(&image[magic_index]) != magic) return false;
+            if (image[version_index] != table_version || image[events_index] != events) return false;
+
+            const size_t length = get_u16(&image[size_index]);
+            const size_t first_step = steps_index(events);
+            if (length < first_step || length > size || length > max_image_size) return false;
+            if (get_u16(&image[crc_index]) != frame::crc16(&image[size_index], length - size_index)) return false;
+
+            const uint8_t *offsets = &image[header_size];
+            const uint8_t *steps = &image[first_step];
+            const size_t steps_size = length - first_step;
+            if (get_u16(&offsets[0]) != 0 || get_u16(&offsets[events * 2]) != steps_size) return false;
+
+            for (size_t event = 0; event < events; ++event)
+            {
+                const size_t start = get_u16(&offsets[event * 2]);
+                const size_t end = get_u16(&offsets[event * 2 + 2]);
+                if (end < start || end - start > max_sequence_size) return false;
+
+                for (size_t index = start; index < end;)
+                {
+                    const size_t size = step_size(&steps[index], end - index);
+                    if (size == 0) return false;
+                    index += size;
+                }
+            }
+            return true;
+        } // keymap::validate
+
+        uint32_t generation(const uint8_t *image)
+        {
+            return get_u32(&image[generation_index]);
+        } // keymap::generation
+
+        size_t image_size(const uint8_t *image)
+        {
+            return get_u16(&image[size_index]);
+        } // keymap::image_size
+
+        Builder::Builder(uint8_t *buffer, size_t size, uint8_t events)
+            : _buffer(buffer), _size(size), _events(events)
+        {
+            _index = steps_index(events);
+            _sequence_start = _index;
+            _overflow = buffer == nullptr || size > max_image_size || _index > size;
+            if (!_overflow)
+                put_u16(&_buffer[header_size], 0);
+        } // Builder::Builder
+
+        bool Builder::event(uint8_t event)
+        {
+            if (_overflow || event < _event || event >= _events) return false;
+
+            // events without steps share the offset of the next one
+            while (_event < event)
+                put_u16(&_buffer[header_size + ++_event * 2], _index - steps_index(_events));
+            _sequence_start = _index;
+            return true;
+        } // Builder::event
+
+        bool Builder::chord(const chord::report_t &report)
+        {
+            return step(chord_step, reinterpret_cast<const uint8_t *>(&report), sizeof(report));
+        } // Builder::chord
+
+        bool Builder::media(const uint8_t (&media)[2])
+        {
+            return step(media_step, media, sizeof(media));
+        } // Builder::media
+
+        bool Builder::delay(uint16_t ms)
+        {
+            uint8_t data[2];
+            put_u16(data, ms);
+            return step(delay_step, data, sizeof(data));
+        } // Builder::delay
+
+        bool Builder::text(const char *text, size_t length)
+        {
+            while (length > 0)
+            {
+                uint8_t data[1 + 255];
+                const size_t chunk = length > 255 ? 255 : length;
+                data[0] = chunk;
+                memcpy(&data[1], text, chunk);
+                if (!step(text_step, data, 1 + chunk)) return false;
+                text += chunk;
+                length -= chunk;
+            }
+            return true;
+        } // Builder::text
+
+        size_t Builder::finish(uint32_t generation)
+        {
+            if (_overflow) return 0;
+
+            while (_event < _events)
+                put_u16(&_buffer[header_size + ++_event * 2], _index - steps_index(_events));
+
+            put_u16(&_buffer[magic_index], magic);
+            _buffer[version_index] = table_version;
+            _buffer[events_index] = _events;
+            put_u32(&_buffer[generation_index], generation);
+            put_u16(&_buffer[size_index], _index);
+            put_u16(&_buffer[crc_index], frame::crc16(&_buffer[size_index], _index - size_index));
+            return _index;
+        } // Builder::finish
+
+        bool Builder::step(step_e type, const uint8_t *data, size_t size)
+        {
+            if (_overflow) return false;
+            if (_index + 1 + size > _size || _index + 1 + size - _sequence_start > max_sequence_size)
+            {
+                _overflow = true;
+                return false;
+            }
+            _buffer[_index++] = type;
+            memcpy(&_buffer[_index], data, size);
+            _index += size;
+            return true;
+        } // Builder::step
+
+        bool Cursor::next(step_t &step)
+        {
+            if (_index >= _size) return false;
+
+            const size_t size = step_size(&_steps[_index], _size - _index);
+            if (size == 0) return false;
+
+            const uint8_t *data = &_steps[_index + 1];
+            step.type = static_cast<step_e>(_steps[_index]);
+            switch (step.type)
+            {
+            case chord_step:
+                memcpy(&step.report, data, sizeof(step.report));
+                break;
+            case media_step:
+                step.media[0] = data[0];
+                step.media[1] = data[1];
+                break;
+            case delay_step:
+                step.delay_ms = get_u16(data);
+                break;
+            case text_step:
+                step.text_size = data[0];
+                step.text = reinterpret_cast<const char *>(&data[1]);
+                break;
+            }
+            _index += size;
+            return true;
+        } // Cursor::next
+
+        bool Table::load(const uint8_t *image, size_t size)
+        {
+            if (!validate(image, size, _events)) return false;
+
+            const uint8_t inactive = _active ^ 1;
+            memcpy(_images[inactive], image, image_size(image));
+            _active = inactive;
+            _loaded = true;
+            _staged_size = 0;
+            return true;
+        } // Table::load
+
+        bool Table::begin(size_t size)
+        {
+            if (size < header_size || size > max_image_size) return false;
+            _staged_size = size;
+            _staged_bytes = 0;
+            return true;
+        } // Table::begin
+
+        bool Table::write(size_t offset, const uint8_t *data, size_t size)
+        {
+            // chunks are accepted in order only, a gap aborts the transfer
+            if (_staged_size == 0 || offset != _staged_bytes || offset + size > _staged_size)
+            {
+                _staged_size = 0;
+                return false;
+            }
+            memcpy(&_images[_active ^ 1][offset], data, size);
+            _staged_bytes += size;
+            return true;
+        } // Table::write
+
+        bool Table::commit()
+        {
+            const uint8_t inactive = _active ^ 1;
+            const bool complete = _staged_size != 0 && _staged_bytes == _staged_size;
+            _staged_size = 0;
+            if (!complete || !validate(_images[inactive], max_image_size, _events)) return false;
+            if (image_size(_images[inactive]) != _staged_bytes) return false;
+
+            _active = inactive;
+            _loaded = true;
+            return true;
+        } // Table::commit
+
+        size_t Table::sequence(uint8_t event, uint8_t *steps, size_t size) const
+        {
+            if (!_loaded || event >= _events) return 0;
+
+            const uint8_t *offsets = &image()[header_size];
+            const size_t start = get_u16(&offsets[event * 2]);
+            const size_t length = get_u16(&offsets[event * 2 + 2]) - start;
+            if (length > size) return 0;
+
+            memcpy(steps, &image()[steps_index(_events) + start], length);
+            return length;
+        } // Table::sequence
+
+        void Table::stamp(uint32_t generation)
+        {
+            put_u32(&_images[_active][generation_index], generation);
+        } // Table::stamp
+
+    } // namespace keymap
+
+} // namespace streamDeco
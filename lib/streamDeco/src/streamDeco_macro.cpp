@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streamDeco_macro.hpp"
+#include <string.h>
+
+namespace streamDeco
+{
+
+    namespace macro
+    {
+
+        bool key(char character, chord::report_t &report)
+        {
+            const uint8_t code = static_cast<uint8_t>(character);
+            report = {};
+            if (code >= chord::modifier_first)
+                return false;
+            chord::add_key(report, code);
+            return report.keys[0] != 0;
+        } // macro::key
+
+        bool Player::load(const uint8_t *steps, size_t size)
+        {
+            _size = 0;
+            _index = 0;
+            _step_active = false;
+            _held = held_none;
+            _delay_ms = 0;
+            _characters = 0;
+            _reports = 0;
+            if (size > sizeof(_steps))
+                return false;
+            memcpy(_steps, steps, size);
+            _size = size;
+            return true;
+        } // Player::load
+
+        bool Player::next(report_t &report)
+        {
+            while (true)
+            {
+                if (!_step_active)
+                {
+                    keymap::Cursor cursor(&_steps[_index], _size - _index);
+                    if (!cursor.next(_step))
+                        return _held != held_none && release(report);
+                    _index += keymap::step_size(&_steps[_index], _size - _index);
+                    _text_index = 0;
+                    _step_active = true;
+                }
+
+                switch (_step.type)
+                {
+                case keymap::chord_step:
+                    if (_held != held_none)
+                        return release(report);
+                    _step_active = false;
+                    _held = held_chord;
+                    return emit(report, false, reinterpret_cast<const uint8_t *>(&_step.report), sizeof(_step.report));
+
+                case keymap::media_step:
+                    if (_held != held_none)
+                        return release(report);
+                    _step_active = false;
+                    _held = held_media;
+                    return emit(report, true, _step.media, sizeof(_step.media));
+
+                case keymap::delay_step:
+                    if (_held != held_none)
+                        return release(report);
+                    _step_active = false;
+                    _delay_ms += _step.delay_ms;
+                    break;
+
+                case keymap::text_step:
+                {
+                    if (_text_index >= _step.text_size)
+                    {
+                        _step_active = false;
+                        break;
+                    }
+
+                    chord::report_t keys;
+                    if (!key(_step.text[_text_index], keys))
+                    {
+                        _text_index++;
+                        break;
+                    }
+
+                    // same key needs a release, other ones replace the held key
+                    if ((_held != held_none && _held != held_text) || (_held == held_text && _held_key == keys.keys[0]))
+                        return release(report);
+
+                    _text_index++;
+                    _characters++;
+                    _held = held_text;
+                    _held_key = keys.keys[0];
+                    return emit(report, false, reinterpret_cast<const uint8_t *>(&keys), sizeof(keys));
+                }
+                }
+            }
+        } // Player::next
+
+        bool Player::emit(report_t &report, bool media, const uint8_t *data, size_t size)
+        {
+            report.media = media;
+            memset(report.data, 0, sizeof(report.data));
+            memcpy(report.data, data, size);
+            report.delay_ms = _delay_ms;
+            _delay_ms = 0;
+            _reports++;
+            return true;
+        } // Player::emit
+
+        bool Player::release(report_t &report)
+        {
+            const uint8_t released[sizeof(report.data)] = {};
+            const bool media = _held == held_media;
+            _held = held_none;
+            return emit(report, media, released, media ? 2 : sizeof(released));
+        } // Player::release
+
+    } // namespace macro
+
+} // namespace streamDeco
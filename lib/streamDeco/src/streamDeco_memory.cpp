@@ -0,0 +1,101 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streamDeco_memory.hpp"
+
+namespace streamDeco
+{
+
+    namespace memory
+    {
+
+        const char *name(pool_e pool)
+        {
+            static const char *const names[pool_count] = {"internal", "psram", "lvgl"};
+            return pool < pool_count ? names[pool] : "unknown";
+        } // memory::name
+
+        uint8_t fragmentation(const usage_t &usage)
+        {
+            if (usage.free == 0 || usage.largest >= usage.free)
+                return 0;
+            return static_cast<uint8_t>(100 - static_cast<uint64_t>(usage.largest) * 100 / usage.free);
+        } // memory::fragmentation
+
+        size_t Telemetry::sample(Probe &probe, int64_t now_us)
+        {
+            sample_t &sample = _samples[_count % history_size];
+            sample.us = now_us;
+            _count++;
+
+            size_t crossed = 0;
+            for (uint8_t pool = 0; pool < pool_count; pool++)
+            {
+                usage_t &usage = sample.pools[pool];
+                if (!probe.read(static_cast<pool_e>(pool), usage))
+                    usage = {};
+
+                const uint8_t percent = fragmentation(usage);
+                const uint32_t bit = 1UL << pool;
+                if (!(_fragmented & bit) && percent >= _threshold)
+                {
+                    _fragmented |= bit;
+                    _events++;
+                    crossed++;
+                    if (_listener != nullptr)
+                        _listener(static_cast<pool_e>(pool), usage, percent);
+                }
+                else if ((_fragmented & bit) && percent + hysteresis < _threshold)
+                    _fragmented &= ~bit;
+            }
+            return crossed;
+        } // Telemetry::sample
+
+        size_t Telemetry::history(sample_t *samples, size_t size) const
+        {
+            const size_t kept = count();
+            const size_t copied = size < kept ? size : kept;
+            for (size_t i = 0; i < copied; i++)
+                samples[i] = _samples[(_count - copied + i) % history_size];
+            return copied;
+        } // Telemetry::history
+
+        int64_t Telemetry::growth(pool_e pool) const
+        {
+            if (count() < 2 || pool >= pool_count)
+                return 0;
+            const sample_t &oldest = _samples[(_count - count()) % history_size];
+            return static_cast<int64_t>(oldest.pools[pool].free) - last().pools[pool].free;
+        } // Telemetry::growth
+
+        void Telemetry::reset()
+        {
+            for (sample_t &sample : _samples)
+                sample = {};
+            _count = 0;
+            _fragmented = 0;
+            _events = 0;
+        } // Telemetry::reset
+
+    } // namespace memory
+
+} // namespace streamDeco
@@ -21,6 +21,7 @@
  */
 
 #include "streamDeco_monitor.hpp"
+#include <string.h>
 
 namespace streamDeco
 {
@@ -31,6 +32,8 @@ namespace streamDeco
         namespace
         {
 
+            constexpr size_t label_buffer_size = 32;
+
             template <typename InitializeFn>
             void create_object(lvgl::object_t *&object, lvgl::object_t *parent, lvgl::palette::palette_t color, InitializeFn initialize)
             {
@@ -82,8 +85,39 @@ namespace streamDeco
                 metric_indicator_style.set_arc_color(lvgl::palette::lighten(color, 3));
             }
 
+            bool same_text(const char *text, const char *other)
+            {
+                if (text == other) return true;
+                if (text == nullptr || other == nullptr) return false;
+                return strcmp(text, other) == 0;
+            }
+
         } // namespace
 
+        bool Cached::update(int32_t value, const char *prefix, const char *sufix, int32_t value2)
+        {
+            if (valid && value2 == last2 && same_text(prefix, last_prefix) && same_text(sufix, last_sufix))
+            {
+                int64_t delta = static_cast<int64_t>(value) - last;
+                if (delta <= deadband && delta >= -deadband) return false;
+            }
+            valid = true;
+            last = value;
+            last2 = value2;
+            last_prefix = prefix;
+            last_sufix = sufix;
+            return true;
+        } // Cached::update
+
+        bool Range::update(int32_t new_min, int32_t new_max)
+        {
+            if (valid && min == new_min && max == new_max) return false;
+            valid = true;
+            min = new_min;
+            max = new_max;
+            return true;
+        } // Range::update
+
         const char* week_name_pt[] = {"DOM", "SEG", "TER", "QUA", "QUI", "SEX", "SAB"};
 
         #define WEEK_NAME week_name_pt
@@ -134,32 +168,60 @@ namespace streamDeco
 
         void Complete::arc_set_value(int16_t value)
         {
-            arc.set_value(value);
-            arc_label.set_text_fmt("%d%%", value);
+            if (!arc_cache.update(value)) return;
+            with_lock([&]() {
+                arc.set_value(value);
+                arc_label.set_text_int(nullptr, value, "%");
+            });
         } // Complete::arc_set_value
 
         void Complete::bar1_set_range(int32_t min, int32_t max)
         {
-            bar1.set_range(min, max);
+            if (!bar1_range.update(min, max)) return;
+            with_lock([&]() {
+                bar1.set_range(min, max);
+            });
+            bar1_cache.invalidate(); // value may be clamped by the new range
         } // Complete::bar1_set_range
 
         void Complete::bar2_set_range(int32_t min, int32_t max)
         {
-            bar2.set_range(min, max);
+            if (!bar2_range.update(min, max)) return;
+            with_lock([&]() {
+                bar2.set_range(min, max);
+            });
+            bar2_cache.invalidate();
         } // Complete::bar2_set_range
 
         void Complete::bar1_set_value(int32_t value, const char *prefix, const char *sufix)
         {
-            bar1.set_value(value, lvgl::animation::OFF);
-            bar1_label.set_text_fmt("%s %d %s", prefix, value, sufix);
+            if (!bar1_cache.update(value, prefix, sufix)) return;
+            with_lock([&]() {
+                bar1.set_value(value, lvgl::animation::OFF);
+                lvgl::text::Buffer<label_buffer_size> text;
+                text.append(prefix).append(' ').append(value).append(' ').append(sufix);
+                bar1_label.set_text(text.c_str());
+            });
         } // Complete::bar1_set_value
 
         void Complete::bar2_set_value(int32_t value, const char *prefix, const char *sufix)
         {
-            bar2.set_value(value, lvgl::animation::OFF);
-            bar2_label.set_text_fmt("%s %d %s", prefix, value, sufix);
+            if (!bar2_cache.update(value, prefix, sufix)) return;
+            with_lock([&]() {
+                bar2.set_value(value, lvgl::animation::OFF);
+                lvgl::text::Buffer<label_buffer_size> text;
+                text.append(prefix).append(' ').append(value).append(' ').append(sufix);
+                bar2_label.set_text(text.c_str());
+            });
         } // Complete::bar2_set_value
 
+        void Complete::set_deadband(int32_t arc_deadband, int32_t bar1_deadband, int32_t bar2_deadband)
+        {
+            arc_cache.deadband = arc_deadband;
+            bar1_cache.deadband = bar1_deadband;
+            bar2_cache.deadband = bar2_deadband;
+        } // Complete::set_deadband
+
         void Complete::init_conf(lvgl::palette::palette_t color)
         {
             setup_monitor_style(monitor_style, color);
@@ -274,26 +336,48 @@ namespace streamDeco
 
         void Basic::bar1_set_range(int32_t min, int32_t max)
         {
-            bar1.set_range(min, max);
+            if (!bar1_range.update(min, max)) return;
+            with_lock([&]() {
+                bar1.set_range(min, max);
+            });
+            bar1_cache.invalidate(); // value may be clamped by the new range
         } // Basic::bar1_set_range
 
         void Basic::bar2_set_range(int32_t min, int32_t max)
         {
-            bar2.set_range(min, max);
+            if (!bar2_range.update(min, max)) return;
+            with_lock([&]() {
+                bar2.set_range(min, max);
+            });
+            bar2_cache.invalidate();
         } //  Basic::bar2_set_range
 
         void Basic::bar1_set_value(int32_t value, const char *prefix, const char *sufix)
         {
-            bar1.set_value(value, lvgl::animation::OFF);
-            bar1_label.set_text_fmt("%s%d%s", prefix, value, sufix);
+            if (!bar1_cache.update(value, prefix, sufix)) return;
+            with_lock([&]() {
+                bar1.set_value(value, lvgl::animation::OFF);
+                bar1_label.set_text_int(prefix, value, sufix);
+            });
         } //  Basic::bar1_set_value
 
         void Basic::bar2_set_value(int32_t value, int32_t value2, const char *prefix, const char *sufix)
         {
-            bar2.set_value(value, lvgl::animation::OFF);
-            bar2_label.set_text_fmt("%s%d/%d%s", prefix, value, value2, sufix);
+            if (!bar2_cache.update(value, prefix, sufix, value2)) return;
+            with_lock([&]() {
+                bar2.set_value(value, lvgl::animation::OFF);
+                lvgl::text::Buffer<label_buffer_size> text;
+                text.append(prefix).append(value).append('/').append(value2).append(sufix);
+                bar2_label.set_text(text.c_str());
+            });
         } //  Basic::bar2_set_value
 
+        void Basic::set_deadband(int32_t bar1_deadband, int32_t bar2_deadband)
+        {
+            bar1_cache.deadband = bar1_deadband;
+            bar2_cache.deadband = bar2_deadband;
+        } // Basic::set_deadband
+
         void Basic::init_conf(lvgl::palette::palette_t color)
         {
             setup_monitor_style(monitor_style, color);
@@ -399,19 +483,40 @@ namespace streamDeco
             constexpr size_t kTimeBufferSize = 9;  // hh:mm:ss + null terminator
             char buffer[kDateBufferSize];
 
-            strftime(buffer, kDateBufferSize, "%d/%m/%Y", &rtc_time);
-            date.set_text(buffer);
-
-            strftime(buffer, kTimeBufferSize, "%H:%M:%S", &rtc_time);
-            hour.set_text(buffer);
-
-            if(wday != rtc_time.tm_wday) {
-                week[wday].remove_style(weekActual_style, lvgl::part::MAIN);
-                week[wday].add_style(week_style, lvgl::part::MAIN);
-                wday = rtc_time.tm_wday;
-                week[wday].remove_style(week_style, lvgl::part::MAIN);
-                week[wday].add_style(weekActual_style, lvgl::part::MAIN);
-            }
+            /* called every 500 ms, only redraw what changed */
+            bool date_changed = !time_valid ||
+                                last_time.tm_mday != rtc_time.tm_mday ||
+                                last_time.tm_mon != rtc_time.tm_mon ||
+                                last_time.tm_year != rtc_time.tm_year;
+            bool hour_changed = !time_valid ||
+                                last_time.tm_sec != rtc_time.tm_sec ||
+                                last_time.tm_min != rtc_time.tm_min ||
+                                last_time.tm_hour != rtc_time.tm_hour;
+            last_time = rtc_time;
+            time_valid = true;
+
+            /* one lock for both labels and week styles */
+            with_lock([&]() {
+                if (date_changed)
+                {
+                    strftime(buffer, kDateBufferSize, "%d/%m/%Y", &rtc_time);
+                    date.set_text(buffer);
+                }
+
+                if (hour_changed)
+                {
+                    strftime(buffer, kTimeBufferSize, "%H:%M:%S", &rtc_time);
+                    hour.set_text(buffer);
+                }
+
+                if(wday != rtc_time.tm_wday) {
+                    week[wday].remove_style(weekActual_style, lvgl::part::MAIN);
+                    week[wday].add_style(week_style, lvgl::part::MAIN);
+                    wday = rtc_time.tm_wday;
+                    week[wday].remove_style(week_style, lvgl::part::MAIN);
+                    week[wday].add_style(weekActual_style, lvgl::part::MAIN);
+                }
+            });
 
         } // Clock::set_time
 
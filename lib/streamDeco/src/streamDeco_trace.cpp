@@ -0,0 +1,167 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "streamDeco_trace.hpp"
+#include <algorithm>
+
+namespace streamDeco
+{
+
+    namespace trace
+    {
+
+        namespace
+        {
+            /* Percentiles of an unsorted list, the list is sorted in place */
+            stats_t percentiles(uint32_t *values, size_t count)
+            {
+                stats_t stats = {};
+                if (count == 0)
+                    return stats;
+                std::sort(values, values + count);
+                stats.count = count;
+                stats.p50 = values[(count - 1) * 50 / 100];
+                stats.p99 = values[(count - 1) * 99 / 100];
+                stats.max = values[count - 1];
+                return stats;
+            } // percentiles
+        }
+
+        const char *name(stage_e stage)
+        {
+            static const char *const names[stage_count] = {"touch", "input", "event", "wake", "queued", "notify"};
+            return stage < stage_count ? names[stage] : "unknown";
+        } // trace::name
+
+        uint32_t Tracer::begin()
+        {
+            return _tap.fetch_add(1, std::memory_order_acq_rel) + 1;
+        } // Tracer::begin
+
+        void Tracer::record(uint32_t tap, stage_e stage, int64_t us)
+        {
+            const uint32_t index = _head.fetch_add(1, std::memory_order_relaxed);
+            entry_t &entry = _entries[index % ring_size];
+
+            entry.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            entry.key.store(tap << 8 | stage, std::memory_order_relaxed);
+            entry.us.store(static_cast<uint32_t>(us), std::memory_order_relaxed);
+            entry.sequence.store(index + 1, std::memory_order_release);
+        } // Tracer::record
+
+        bool Tracer::load(uint32_t index, uint32_t &key, uint32_t &us) const
+        {
+            const entry_t &entry = _entries[index % ring_size];
+            if (entry.sequence.load(std::memory_order_acquire) != index + 1)
+                return false;
+            key = entry.key.load(std::memory_order_relaxed);
+            us = entry.us.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // overwritten while copied
+            return entry.sequence.load(std::memory_order_relaxed) == index + 1;
+        } // Tracer::load
+
+        size_t Tracer::snapshot(record_t *records, size_t size) const
+        {
+            const uint32_t head = _head.load(std::memory_order_acquire);
+            const uint32_t first = head > ring_size ? head - ring_size : 0;
+
+            size_t count = 0;
+            for (uint32_t index = first; index != head && count < size; index++)
+            {
+                uint32_t key;
+                if (!load(index, key, records[count].us))
+                    continue;
+                records[count].tap = key >> 8;
+                records[count].stage = static_cast<stage_e>(key & 0xFF);
+                count++;
+            }
+            return count;
+        } // Tracer::snapshot
+
+        void Tracer::summary(stats_t (&stages)[stage_count], stats_t &total) const
+        {
+            // compact copy, summary runs on small task stacks
+            uint32_t keys[ring_size];
+            uint32_t times[ring_size];
+            size_t count = 0;
+
+            const uint32_t head = _head.load(std::memory_order_acquire);
+            const uint32_t first = head > ring_size ? head - ring_size : 0;
+            for (uint32_t index = first; index != head; index++)
+                if (load(index, keys[count], times[count]))
+                    count++;
+
+            uint32_t values[ring_size];
+            for (uint8_t stage = 0; stage < stage_count; stage++)
+            {
+                size_t found = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    if ((keys[i] & 0xFF) != stage)
+                        continue;
+                    if (stage == touch_stage)
+                    {
+                        found++;
+                        continue;
+                    }
+
+                    // closest previous stage of the same tap
+                    size_t previous = count;
+                    for (size_t j = 0; j < count; j++)
+                        if ((keys[j] >> 8) == (keys[i] >> 8) && (keys[j] & 0xFF) < stage &&
+                            (previous == count || keys[j] > keys[previous]))
+                            previous = j;
+                    if (previous != count)
+                        values[found++] = times[i] - times[previous];
+                }
+                stages[stage] = percentiles(values, stage == touch_stage ? 0 : found);
+                if (stage == touch_stage)
+                    stages[stage].count = found;
+            }
+
+            size_t found = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                if ((keys[i] & 0xFF) != notify_stage)
+                    continue;
+                for (size_t j = 0; j < count; j++)
+                    if (keys[j] == (keys[i] & ~0xFFu))
+                    {
+                        values[found++] = times[i] - times[j];
+                        break;
+                    }
+            }
+            total = percentiles(values, found);
+        } // Tracer::summary
+
+        void Tracer::reset()
+        {
+            for (entry_t &entry : _entries)
+                entry.sequence.store(0, std::memory_order_release);
+        } // Tracer::reset
+
+    } // namespace trace
+
+} // namespace streamDeco
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Docstring para mapCompare
+
+compare the static memory of two firmware builds from their GNU ld map files,
+e.g. default NimBLE host against NIMBLE_HID_PERIPHERAL_ONLY build.
+Internal SRAM is .dram0.* and .iram0.* sections, heap allocated at boot is
+printed by StreamDeco on the "BLE ... profile" log line.
+
+"""
+
+import os
+import re
+from collections import defaultdict
+
+SECTIONS = (".dram0.data", ".dram0.bss", ".iram0.text", ".iram0.data", ".flash.text", ".flash.rodata")
+INTERNAL = (".dram0.data", ".dram0.bss", ".iram0.text", ".iram0.data")
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)\s+0x[0-9a-f]+\s+0x([0-9a-f]+)", re.IGNORECASE)
+OUTPUT_NAME = re.compile(r"^(\.\S+)\s*$")
+INPUT_SECTION = re.compile(r"^ (?:\S+)?\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)", re.IGNORECASE)
+ADDRESS_SIZE = re.compile(r"^\s+0x[0-9a-f]+\s+0x([0-9a-f]+)", re.IGNORECASE)
+
+
+def library(path):
+    """Archive of an object, objects out of archives are grouped as src."""
+    match = re.match(r"(.*\.a)\(.*\)$", path)
+    if match:
+        return os.path.basename(match.group(1))
+    return "src"
+
+
+def parse(map_file):
+    """Size of each output section and internal SRAM size of each library."""
+    if not os.path.isfile(map_file):
+        raise FileNotFoundError(f"Map file {map_file} does not exist")
+
+    sections = {}
+    libraries = defaultdict(int)
+    section = None
+    pending_name = None
+
+    with open(map_file, encoding="utf-8", errors="replace") as lines:
+        started = False
+        for line in lines:
+            if not started:
+                started = line.startswith("Linker script and memory map")
+                continue
+            line = line.rstrip("\n")
+
+            match = OUTPUT_SECTION.match(line)
+            if match:
+                section = match.group(1)
+                sections[section] = int(match.group(2), 16)
+                continue
+
+            match = OUTPUT_NAME.match(line)
+            if match:
+                # long output section names wrap their address to the next line
+                section = match.group(1)
+                pending_name = section
+                continue
+
+            if pending_name:
+                match = ADDRESS_SIZE.match(line)
+                pending_name = None
+                if match:
+                    sections[section] = int(match.group(1), 16)
+                    continue
+
+            if section not in INTERNAL:
+                continue
+            match = INPUT_SECTION.match(line)
+            if match and not match.group(2).startswith("0x"):
+                libraries[library(match.group(2))] += int(match.group(1), 16)
+
+    return sections, libraries
+
+
+def compare(before_file, after_file, top=15):
+    """Print section sizes and the libraries that changed the most."""
+    before_sections, before_libraries = parse(before_file)
+    after_sections, after_libraries = parse(after_file)
+
+    print(f"{'section':<16}{'before':>10}{'after':>10}{'diff':>10}")
+    for name in SECTIONS:
+        before = before_sections.get(name, 0)
+        after = after_sections.get(name, 0)
+        print(f"{name:<16}{before:>10}{after:>10}{after - before:>+10}")
+
+    before = sum(before_sections.get(name, 0) for name in INTERNAL)
+    after = sum(after_sections.get(name, 0) for name in INTERNAL)
+    print(f"{'internal SRAM':<16}{before:>10}{after:>10}{after - before:>+10}")
+
+    print()
+    print(f"{'library (internal SRAM)':<32}{'before':>10}{'after':>10}{'diff':>10}")
+    names = set(before_libraries) | set(after_libraries)
+    changes = sorted(names, key=lambda name: abs(after_libraries[name] - before_libraries[name]), reverse=True)
+    for name in changes[:top]:
+        before = before_libraries[name]
+        after = after_libraries[name]
+        if before != after:
+            print(f"{name:<32}{before:>10}{after:>10}{after - before:>+10}")
+
+
+if __name__ == "__main__":
+    import sys
+    if len(sys.argv) != 3:
+        print("Usage: python mapCompare.py <before_firmware.map> <after_firmware.map>")
+    else:
+        compare(sys.argv[1], sys.argv[2])
@@ -65,6 +65,26 @@ void loop()
   streamDeco::mutex_serial.take();
   lvgl::port::print_task_memory_usage();
   streamDeco::print_task_memory_usage();
+  streamDeco::print_frame_latency();
+  streamDeco::print_shortcut_latency();
+  streamDeco::print_trace();
+  lvgl::port::render_stats_t render = lvgl::port::get_render_stats();
+  ESP_LOGI("Test Cycle", "Render mode %d, refreshes %lu, pixels %llu, time %lu ms",
+           lvgl::port::render_mode(), static_cast<unsigned long>(render.refreshes), render.pixels,
+           static_cast<unsigned long>(render.time_ms));
+  ESP_LOGI("Test Cycle", "Flushes %lu, flush time %llu us, %.1f fps",
+           static_cast<unsigned long>(render.flushes), render.flush_us,
+           lvgl::port::render_fps(render));
+  lvgl::port::task_stats_t lvgl_task = lvgl::port::get_task_stats();
+  ESP_LOGI("Test Cycle", "LVGL wakeups %.1f/s, duty %.2f%%",
+           lvgl::port::task_wakeups_rate(lvgl_task), lvgl::port::task_duty(lvgl_task) * 100.0f);
+  lvgl::port::touch_stats_t touch = lvgl::port::get_touch_stats();
+  ESP_LOGI("Test Cycle", "Touch interrupts %lu, reads %lu, dropped %lu, latency <1ms %lu <5ms %lu <10ms %lu <20ms %lu <50ms %lu more %lu",
+           static_cast<unsigned long>(touch.interrupts), static_cast<unsigned long>(touch.reads),
+           static_cast<unsigned long>(touch.dropped), static_cast<unsigned long>(touch.latency[0]),
+           static_cast<unsigned long>(touch.latency[1]), static_cast<unsigned long>(touch.latency[2]),
+           static_cast<unsigned long>(touch.latency[3]), static_cast<unsigned long>(touch.latency[4]),
+           static_cast<unsigned long>(touch.latency[5]));
   ESP_LOGI("Test Cycle", "%d", test_count++);
   streamDeco::mutex_serial.give();
 #endif
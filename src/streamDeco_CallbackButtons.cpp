@@ -33,7 +33,8 @@ namespace streamDeco
 
     /**
       * @brief   Callback registered on buttons
-      * @details Send notifications with event code to task buttons handler
+      * @details Post button_message with event code to the worker,
+      *          start the trace of the tap with the touch that generated it
      * @param   lvglEvent  Event received by the callback
       * @note    This callback is registered on buttons and streamDecoBrightSlider objects
      * @note    Each streamDeco button and streamDeco bright slider send a different event
@@ -42,7 +43,15 @@ namespace streamDeco
     {
       // userdata passed are the event generated by touch at int type
       int event = lvgl::event::get_user_data<int>(lvglEvent);
-      streamDecoTasks::buttons.sendNotify(event);
+
+      const uint32_t tap = tracer.begin();
+      lvgl::port::touch_points_t points;
+      lvgl::port::get_touch_points(points);
+      tracer.record(tap, trace::touch_stage, points.timestamp_us);
+      tracer.record(tap, trace::input_stage, points.read_us);
+      tracer.record(tap, trace::event_stage, rtos::time<microseconds>().count());
+
+      events::post(executor::button_message, event, tap);
     }
 
   } // namespace streamDecoButtons
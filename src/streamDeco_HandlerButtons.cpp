@@ -20,7 +20,7 @@
  * SOFTWARE.
  *
  * @file  streamDeco_HandlerButtons.cpp
- * @brief Button task handler
+ * @brief Button message handlers
  */
 
 #include "streamDeco_objects.hpp"
@@ -28,41 +28,94 @@
 namespace streamDeco
 {
 
+  namespace
+  {
+    /* last button event, its reports are notified later by BleKeyboard sender task,
+     * pending_tap is the tap of its button_message, sent_message carries none */
+    bool pending = false;
+    uint32_t pending_tap = 0;
+    int64_t pending_time = 0;
+    uint32_t pending_reports = 0;
+
+    /* reports notified later are not counted on shortcut latency, was waitSent(100) */
+    constexpr int64_t sent_timeout_us = 100000;
+  }
+
   /**
-   * @brief   Handle the buttons task to manager buttons events
+   * @brief   Handle button_message to manager buttons events
     * @details The events can generate a keyboard code to send to computer through BLE Bluetooth
-   *          or change StreamDeco configurations
+   *          or change StreamDeco configurations, the worker does not wait for the reports
    **/
-  void handleButtons(taskArg_t task_arg)
+  void handleButton(const executor::message_t &message)
   {
+    /* carried by the message, later touches may have started other taps,
+     * 0 if the event was not posted by a touch */
+    const uint32_t tap = message.tap;
+    if (tap)
+      tracer.record(tap, trace::wake_stage, rtos::time<microseconds>().count());
+
+    /* more buttons may follow, request short BLE connection interval */
+    bleKeyboard.setActive();
 
-    while (1)
-    {
+    const int64_t event_time = rtos::time<microseconds>().count();
+    const uint32_t reports_sent = bleKeyboard.getSentCount();
 
-      /* wait for a notification
-       * this notification is sent by LVGL streamDecoButtons with a event code */
-      uint32_t button_event = streamDecoTasks::buttons.takeNotify();
+    /* BleKeyboard uses serial interface to make verbose things */
+    streamDeco::mutex_serial.take();
 
-      /* BleKeyboard uses serial interface to make verbose things */
-      streamDeco::mutex_serial.take();
+    /* function in streamDeco_shortcuts.cpp
+     * reports are queued, BleKeyboard sender task notifies them */
+    process_event(message.value, tap);
 
-      /* function in streamDeco_shortcuts.cpp */
-      process_event(button_event);
+    streamDeco::mutex_serial.give();
+    if (tap)
+      tracer.record(tap, trace::queued_stage, rtos::time<microseconds>().count());
 
-      streamDeco::mutex_serial.give();
+    /* completed by handleSent, only shortcuts with reports are measured */
+    pending = true;
+    pending_tap = tap;
+    pending_time = event_time;
+    pending_reports = reports_sent;
 
-      /**
-       * if some event is received the UI is not inactive
-       * backlight bright change to setpoint value
-        * and timers are kept reset */
-      lvgl::port::backlight_setRaw(settings::cache.lcd_bright);
-      timers_idle::backlight_idle.reset();
-      timers_idle::canvas_idle.reset();
+    /**
+     * if some event is received the UI is not inactive
+     * backlight bright change to setpoint value
+      * and timers are kept reset */
+    lvgl::port::backlight_setRaw(settings::cache.lcd_bright);
+    events::restart(timers_idle::backlight_idle);
+    events::restart(timers_idle::canvas_idle);
 
-      rtos::sleep(100ms);
+  } // end handleButton
 
-    } // end handleButtons's infinit loop
+  /**
+   * @brief   Handle sent_message, posted by BleKeyboard sender task once all reports are notified
+   * @details Message value is the sent count, posted time is the notify time of the last report
+   **/
+  void handleSent(const executor::message_t &message)
+  {
+    shortcuts::resume();
 
-  } // end handleButtons
+    /* older reports sent while the last event was processed */
+    if (!pending || message.posted_us < pending_time)
+      return;
+
+    pending = false;
+    const int64_t elapsed = message.posted_us - pending_time;
+    if (message.value == pending_reports || elapsed > sent_timeout_us)
+      return;
+
+    shortcut_latency.record(elapsed);
+    if (pending_tap)
+      tracer.record(pending_tap, trace::notify_stage, message.posted_us);
+  }
+
+  /**
+   * @brief   Handle feedback_message, computer state is shown without waking the UI up
+   **/
+  void handleFeedback(const executor::message_t &message)
+  {
+    (void)message;
+    feedback::process();
+  }
 
 } // namespace streamDeco
@@ -20,7 +20,7 @@
  * SOFTWARE.
  *
  * @file  streamDeco_HandlerClock.cpp
- * @brief Clock streamDecoTasks handler
+ * @brief Clock message handler
  */
 
 #include "streamDeco_objects.hpp"
@@ -32,56 +32,23 @@ namespace streamDeco
   namespace
   {
     constexpr time_t kEpochWrap = 2082758399;
+    constexpr time_t kMaxDriftSeconds = 2;
 
-    String nextFrameToken(const String &frame, int &start)
+    bool readClockFromFrame(const frame::metrics_t &metrics, struct tm &tm_date)
     {
-      if (start < 0 || start >= frame.length())
-      {
-        return "";
-      }
-
-      int sep = frame.indexOf(',', start);
-      String token;
-
-      if (sep < 0)
-      {
-        token = frame.substring(start);
-        start = frame.length();
-      }
-      else
-      {
-        token = frame.substring(start, sep);
-        start = sep + 1;
-      }
-
-      token.trim();
-      return token;
-    }
-
-    bool readClockFromFrame(const String &frame, struct tm &tm_date)
-    {
-      int start = 0;
-      String fields[17];
-
-      for (int i = 0; i < 17; ++i)
-      {
-        fields[i] = nextFrameToken(frame, start);
-      }
-
       // Require at least full date payload (sec..year) for RTC sync.
-      if (!fields[10].length() || !fields[11].length() || !fields[12].length() ||
-          !fields[13].length() || !fields[14].length() || !fields[15].length() || !fields[16].length())
+      if (!metrics.clock_valid)
       {
         return false;
       }
 
-      tm_date.tm_sec = fields[10].toInt();
-      tm_date.tm_min = fields[11].toInt();
-      tm_date.tm_hour = fields[12].toInt();
-      tm_date.tm_wday = fields[13].toInt();
-      tm_date.tm_mday = fields[14].toInt();
-      tm_date.tm_mon = fields[15].toInt() - 1;
-      tm_date.tm_year = fields[16].toInt() - 1900;
+      tm_date.tm_sec = metrics.sec;
+      tm_date.tm_min = metrics.min;
+      tm_date.tm_hour = metrics.hour;
+      tm_date.tm_wday = metrics.wday;
+      tm_date.tm_mday = metrics.mday;
+      tm_date.tm_mon = metrics.month - 1;
+      tm_date.tm_year = metrics.year - 1900;
 
       return true;
     }
@@ -101,41 +68,53 @@ namespace streamDeco
 
       settimeofday(&time_epoch, nullptr);
     }
+
+    /* Frames carry whole seconds, only correct the RTC when it really drifted */
+    void syncRtcFromFrame(const frame::metrics_t &metrics)
+    {
+      struct tm tm_date = {0};
+
+      if (!readClockFromFrame(metrics, tm_date))
+      {
+        return;
+      }
+
+      struct tm tm_frame = tm_date;
+      time_t drift = mktime(&tm_frame) - time(nullptr);
+
+      if (drift >= kMaxDriftSeconds || drift <= -kMaxDriftSeconds)
+      {
+        updateRtcFromTm(tm_date);
+      }
+    }
   }
 
   /**
    * @brief    Synchronizes ESP32-RTC with Computer clock
-   * @details  Wait for StreamDeco StreamDecoMonitor application response to synchronizes ESP32 RTC clock
+   * @details  Wait for StreamDeco StreamDecoMonitor application first time message to synchronizes ESP32 RTC clock
    * @param    max_attempts - number of attempts to synchronize clock with computer
+   * @note     Used on init only, after that handleClock keeps RTC synchronized
    */
   void sync_clock(int max_attempts)
   {
 
     int attempts = 0;
     struct tm tm_date = {0};
+    frame::slot_t slot;
 
     while (true)
     {
 
-      mutex_serial.take();
-
-      if (Serial.available())
+      if (time_queue.receive(slot, 1s))
       {
-        String frame = Serial.readStringUntil('/');
-        frame.trim();
-
-        if (frame.length() > 0 && readClockFromFrame(frame, tm_date))
+        if (readClockFromFrame(slot.metrics, tm_date))
         {
           updateRtcFromTm(tm_date);
         }
 
-        mutex_serial.give();
-
         return;
 
-      } // Serial.avaliable
-
-      mutex_serial.give();
+      } // time_queue.receive
 
       ++attempts;
       if (max_attempts != -1 && attempts > max_attempts)
@@ -143,44 +122,29 @@ namespace streamDeco
         return;
       }
 
-      rtos::sleep(1s);
-
     } // loop check time
 
   }
 
-  /* Handle the clock streamDecoTasks,
-   * update clock time on Monitor streamDecoCanvas */
-  void handleClock(taskArg_t task_arg)
+  /* Handle tick_message,
+   * update clock time on Monitor streamDecoCanvas
+   * and ESP32 RTC from any frame with date */
+  void handleClock(const executor::message_t &message)
   {
 
+    (void)message;
     struct tm tm_date = {0};
+    frame::slot_t slot;
 
-    while (true)
-    {
-
-      getLocalTime(&tm_date);
-      streamDecoMonitor::clock.set_time(tm_date);
-
-      rtos::sleep(500ms);
-    }
-  }
-
-  /* Handle the clock sync streamDecoTasks,
-   * synchronize clock time with streamDeco monitor application */
-  void handleClockSync(taskArg_t task_arg)
-  {
-
-    (void)task_arg;
-
-    while (true)
+    /* posted by the clock refresh timer or by a frame with date */
+    if (time_queue.receive(slot, 0ms))
     {
-
-      sync_clock(40);
-      rtos::sleep(5min);
-
+      syncRtcFromFrame(slot.metrics);
     }
 
+    /* the worker must not wait for a valid RTC */
+    getLocalTime(&tm_date, 0);
+    streamDecoMonitor::clock.set_time(tm_date);
   }
 
 } // namespace streamDeco
\ No newline at end of file
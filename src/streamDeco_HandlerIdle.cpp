@@ -22,7 +22,7 @@
  * @file    streamDeco_HandlerIdle.cpp
  * @brief   Hide canvas
  * @details This handler hides canvas or sets backlight brightness to minimum
- * @details if buttons are not pinned after receiving a notification from a timer
+ * @details if buttons are not pinned after receiving a message from a timer
  */
 
 #include "streamDeco_objects.hpp"
@@ -30,41 +30,46 @@
 namespace streamDeco
 {
 
-  /* Handler of UI reset task,
+  /* Handler of idle_message,
     * hide canvas if they are not pinned or
    * put backlight on rest mode reducing the bright to minimum. */
-  void handleIdle(taskArg_t task_arg)
+  void handleIdle(const executor::message_t &message)
   {
-    while (1)
+    switch (message.value)
     {
-      uint32_t e = streamDecoTasks::idle.takeNotify();
-      switch (e)
+    case hidden_canvas_event:
+      if (!streamDecoButtons::applications_canvas.pinned())
       {
-      case hidden_canvas_event:
-        if (!streamDecoButtons::applications_canvas.pinned())
-        {
-          streamDecoCanvas::applications.hidden();
-        }
-        if (!streamDecoButtons::multimedia_canvas.pinned())
-        {
-          streamDecoCanvas::multimedia.hidden();
-        }
-        /* Always hide Configurations canvas
-         * and never hide Monitor canvas */
-        streamDecoCanvas::configurations.hidden();
+        streamDecoCanvas::applications.hidden();
+      }
+      if (!streamDecoButtons::multimedia_canvas.pinned())
+      {
+        streamDecoCanvas::multimedia.hidden();
+      }
+      /* Always hide Configurations canvas
+       * and never hide Monitor canvas */
+      streamDecoCanvas::configurations.hidden();
+      break;
+    case rest_backlight_event:
+      // nobody is pressing buttons, relax BLE connection interval
+      bleKeyboard.setIdle();
+      // only change backlight bright if are no pinned canvas
+      if (streamDecoButtons::applications_canvas.pinned())
         break;
-      case rest_backlight_event:
-        // only change backlight bright if are no pinned canvas
-        if (streamDecoButtons::applications_canvas.pinned())
-          break;
-        if (streamDecoButtons::multimedia_canvas.pinned())
-          break;
-        if (streamDecoButtons::configurations_canvas.pinned())
-          break;
-        lvgl::port::backlight_set(.1);
+      if (streamDecoButtons::multimedia_canvas.pinned())
         break;
-      }
+      if (streamDecoButtons::configurations_canvas.pinned())
+        break;
+      lvgl::port::backlight_set(.1);
+      break;
     }
   }
 
+  /* Handler of memory_message, memory telemetry is owned by the worker */
+  void handleMemory(const executor::message_t &message)
+  {
+    (void)message;
+    telemetry::sample();
+  }
+
 } // namespace streamDeco
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @file     streamDeco_HandlerIngest.cpp
+ * @brief    Handler of serial and BLE ingest
+ * @details  Wake on UART receive event or BLE data write, reassemble
+ *           StreamDecoMonitor frames and publish them through frameRouter
+ */
+
+#include "streamDeco_objects.hpp"
+
+namespace streamDeco
+{
+
+  namespace
+  {
+    /* Non blocking Serial reader used by frame assembler */
+    class SerialSource : public frame::Source
+    {
+    public:
+      size_t read(uint8_t *data, size_t size) override
+      {
+        int available = Serial.available();
+        if (available <= 0)
+          return 0;
+
+        if (size > static_cast<size_t>(available))
+          size = available;
+
+        return Serial.read(data, size);
+      }
+    }; // class SerialSource
+
+    SerialSource serial_source;
+    frame::Assembler assembler(frame::transport_serial);
+
+    /* Filled by the BLE host task, each link and each bonded host has its
+     * own assembler so a frame split on one is never mixed with bytes of
+     * another */
+    struct ble_link_t
+    {
+      frame::Channel channel;
+      frame::Assembler assembler{frame::transport_ble};
+    };
+
+    ble_link_t ble_links[BLE_KEYBOARD_MAX_HOSTS];
+
+    /* Control frames refused because their host was not the active one */
+    uint32_t ble_refused = 0;
+
+    /* Called from UART driver event task on RX FIFO full or RX timeout */
+    void serial_receive_callback()
+    {
+      events::post(executor::ingest_message);
+    }
+
+    /* Called from BLE host task on each data write, at most MTU - 3 bytes */
+    void ble_receive_callback(uint8_t host, const uint8_t *data, size_t size)
+    {
+      if (host >= BLE_KEYBOARD_MAX_HOSTS)
+        return;
+
+      ble_links[host].channel.write(data, size);
+      events::post(executor::ingest_message);
+    }
+  }
+
+  void initIngest()
+  {
+    mutex_serial.take();
+    Serial.onReceive(serial_receive_callback);
+    mutex_serial.give();
+
+    bleKeyboard.onData(ble_receive_callback);
+  }
+
+  uint32_t ingestDropped()
+  {
+    uint32_t dropped = 0;
+    for (auto &link : ble_links)
+      dropped += link.channel.dropped();
+    return dropped;
+  }
+
+  uint32_t ingestRefused()
+  {
+    return ble_refused;
+  }
+
+  /* Handle ingest_message,
+   * reassemble frames received from StreamDecoMonitor application */
+  void handleIngest(const executor::message_t &message)
+  {
+
+    (void)message;
+
+    frame::slot_t slot;
+
+    /* both links are drained, the monitor application picks one at runtime */
+    while (true)
+    {
+      mutex_serial.take();
+      size_t received = assembler.fill(serial_source, rtos::time<microseconds>().count());
+      mutex_serial.give();
+
+      while (assembler.next(slot))
+      {
+        frameRouter::publish(slot);
+      }
+
+      /* shortcuts and requests change the deck, only the active host may
+       * send them, metrics of the others still feed monitor and clock */
+      uint8_t active = bleKeyboard.getActiveHost();
+
+      for (uint8_t host = 0; host < BLE_KEYBOARD_MAX_HOSTS; host++)
+      {
+        ble_link_t &link = ble_links[host];
+        received += link.assembler.fill(link.channel, rtos::time<microseconds>().count());
+
+        while (link.assembler.next(slot))
+        {
+          if (host == active || slot.type == frame::metrics_type)
+            frameRouter::publish(slot);
+          else
+            ble_refused++;
+        }
+      }
+
+      if (received == 0)
+        break;
+    }
+  }
+
+} // namespace streamDeco
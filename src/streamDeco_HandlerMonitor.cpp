@@ -20,7 +20,7 @@
  * SOFTWARE.
  *
  * @file     streamDeco_HandlerMonitor.cpp
- * @brief    Handler of streamDecoTasks StreamDecoMonitor
+ * @brief    Handler of StreamDecoMonitor metrics frames
  */
 
 #include "streamDeco_objects.hpp"
@@ -29,161 +29,32 @@
 namespace streamDeco
 {
 
-  static String cpu_load;
-  static String cpu_temp;
-  static String cpu_freq;
-
-  static String gpu_load;
-  static String gpu_temp;
-  static String gpu_freq;
-
-  static String mem_used;
-  static String mem_max;
-  static String disk_used;
-  static String disk_max;
-
-  static String sec;
-  static String min;
-  static String hour;
-  static String day;
-  static String month;
-  static String year;
-
-  namespace
+  /* Handle frame_message,
+   * show computer metrics on configure pinned streamDecoCanvas */
+  void handleFrame(const executor::message_t &message)
   {
-    String nextFrameToken(const String &frame, int &start)
-    {
-      if (start < 0 || start >= frame.length())
-      {
-        return "";
-      }
-
-      int sep = frame.indexOf(',', start);
-      String token;
-
-      if (sep < 0)
-      {
-        token = frame.substring(start);
-        start = frame.length();
-      }
-      else
-      {
-        token = frame.substring(start, sep);
-        start = sep + 1;
-      }
 
-      token.trim();
-      return token;
-    }
+    (void)message;
+    frame::slot_t slot;
 
-    bool parseMonitorFrame(const String &frame)
+    /* frameRouter posts one message for the frames waiting on metrics_queue */
+    while (metrics_queue.receive(slot, 0ms))
     {
-      int start = 0;
-
-      String token = nextFrameToken(frame, start);
-      if (token.length())
-        cpu_load = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        cpu_temp = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        cpu_freq = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        gpu_load = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        gpu_temp = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        gpu_freq = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        mem_used = token;
 
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        mem_max = token;
+      const frame::metrics_t &metrics = slot.metrics;
 
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        disk_used = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        disk_max = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        sec = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        min = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        hour = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        day = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        month = token;
-
-      token = nextFrameToken(frame, start);
-      if (token.length())
-        year = token;
-
-      return true;
-    }
-  }
-
-  /* Handle the StreamDecoMonitor streamDecoTasks,
-   * show computer metrics on configure pinned streamDecoCanvas */
-  void handleMonitor(taskArg_t task_arg)
-  {
-
-    while (1)
-    {
-
-      mutex_serial.take();
-      if (Serial.available())
+      /* apply the whole frame under one LVGL lock, so it is refreshed at once */
+      const uint32_t acquisitions = lvgl::port::get_lock_stats().acquisitions;
       {
-        String frame = Serial.readStringUntil('/');
-        frame.trim();
-
-        if (frame.length() > 0)
-        {
-          parseMonitorFrame(frame);
-
-          streamDecoMonitor::cpu.arc_set_value(cpu_load.toInt());
-          streamDecoMonitor::cpu.bar1_set_value(cpu_temp.toInt(), "", " °C");
-          streamDecoMonitor::cpu.bar2_set_value(cpu_freq.toInt(), "", " MHz");
-
-          streamDecoMonitor::gpu.arc_set_value(gpu_load.toInt());
-          streamDecoMonitor::gpu.bar1_set_value(gpu_temp.toInt(), "", " °C");
-          streamDecoMonitor::gpu.bar2_set_value(gpu_freq.toInt(), "", " MHz");
-
-          streamDecoMonitor::system.bar1_set_range(0, mem_max.toInt());
-          streamDecoMonitor::system.bar2_set_range(0, disk_max.toInt());
-
-          streamDecoMonitor::system.bar1_set_value(mem_used.toInt(), "RAM: ", " MB");
-          streamDecoMonitor::system.bar2_set_value(disk_used.toInt(), disk_max.toInt(), "C: ", " GB");
-        }
+        lvgl::port::Batch batch;
+        streamDecoMonitor::update(metrics);
+        monitor_lock_takes = batch.takes();
       }
-      mutex_serial.give();
+      monitor_lock_acquisitions = lvgl::port::get_lock_stats().acquisitions - acquisitions;
 
-      rtos::sleep(1s);
+      int64_t latency = rtos::time<microseconds>().count() - slot.arrival_us;
+      monitor_latency.record(latency);
+      transport_latency[slot.transport].record(latency);
     }
   }
 
@@ -0,0 +1,218 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file    streamDeco_events.cpp
+ * @brief   Event loop of streamDecoTasks worker
+ * @details Messages of buttons, frames, BLE and timers are dispatched by one
+ *          worker, posts are serialized by a spinlock, handlers run outside of it
+ */
+
+#include "streamDeco_objects.hpp"
+#include "streamDeco_handlers.hpp"
+#include "streamDeco_init.hpp"
+
+#include "esp_log.h"
+
+namespace streamDeco
+{
+
+  extern const char *log_tag;
+
+  namespace
+  {
+    constexpr microseconds clock_period = 500ms;
+    constexpr microseconds cache_period = 10min;
+    constexpr microseconds ingest_guard_period = 1s; /* a lost receive callback is not fatal */
+
+    int64_t now_us()
+    {
+      return rtos::time<microseconds>().count();
+    }
+
+    executor::Executor loop(now_us);
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    /* Called by BleKeyboard sender task, value is the sent count */
+    void sent_callback()
+    {
+      events::post(executor::sent_message, bleKeyboard.getSentCount());
+    }
+
+    /* Worker, sleep until a post or the next timer */
+    void handleWorker(taskArg_t task_arg)
+    {
+      (void)task_arg;
+      executor::message_t message;
+
+      while (true)
+      {
+        portENTER_CRITICAL(&lock);
+        const bool ready = loop.next(message);
+        const int64_t wait = ready ? 0 : loop.wait_us();
+        portEXIT_CRITICAL(&lock);
+
+        if (ready)
+        {
+          loop.dispatch(message);
+          continue;
+        }
+
+        /* a post between the lock and the wait leaves the notification pending */
+        if (wait < 0)
+          streamDecoTasks::worker.takeNotify();
+        else
+          streamDecoTasks::worker.takeNotify(milliseconds((wait + 999) / 1000));
+      }
+    }
+  }
+
+  namespace events
+  {
+
+    bool post(executor::message_e type, uint32_t value, uint32_t tap)
+    {
+      portENTER_CRITICAL(&lock);
+      const bool posted = loop.post(type, value, tap);
+      portEXIT_CRITICAL(&lock);
+
+      if (posted)
+        streamDecoTasks::worker.sendNotify(1);
+      return posted;
+    }
+
+    executor::timer_id_t schedule(executor::message_e type, uint32_t value, microseconds delay, microseconds period)
+    {
+      portENTER_CRITICAL(&lock);
+      const executor::timer_id_t timer = loop.schedule(type, value, delay.count(), period.count());
+      portEXIT_CRITICAL(&lock);
+
+      /* the worker may sleep past the new timer */
+      streamDecoTasks::worker.sendNotify(1);
+      return timer;
+    }
+
+    void restart(executor::timer_id_t timer)
+    {
+      portENTER_CRITICAL(&lock);
+      loop.restart(timer);
+      portEXIT_CRITICAL(&lock);
+    }
+
+    void period(executor::timer_id_t timer, microseconds period)
+    {
+      portENTER_CRITICAL(&lock);
+      loop.period(timer, period.count());
+      portEXIT_CRITICAL(&lock);
+      streamDecoTasks::worker.sendNotify(1);
+    }
+
+    void init()
+    {
+      /* buttons and the computer state first, macros do not wait for metrics */
+      loop.on(executor::button_message, handleButton, executor::high_priority);
+      loop.on(executor::sent_message, handleSent, executor::high_priority);
+      loop.on(executor::feedback_message, handleFeedback, executor::high_priority, true);
+      loop.on(executor::ingest_message, handleIngest, executor::normal_priority, true);
+      loop.on(executor::memory_message, handleMemory, executor::low_priority, true);
+      loop.on(executor::dump_message, handleDump, executor::low_priority, true);
+      loop.on(executor::save_message, handleUpdateCache, executor::low_priority, true);
+
+      bleKeyboard.onSent(sent_callback);
+      schedule(executor::ingest_message, 0, ingest_guard_period, ingest_guard_period);
+      schedule(executor::save_message, nothing_event, cache_period, cache_period);
+#if RTOS_PROFILER
+      /* started by StreamDecoMonitor top_request */
+      timers_profiler::top = schedule(executor::dump_message, top_dump, 1s, 1s);
+      period(timers_profiler::top, 0us);
+#endif
+
+      streamDecoTasks::worker.attach(handleWorker);
+    }
+
+    void start()
+    {
+      /* the worker is running, routes are read by post */
+      portENTER_CRITICAL(&lock);
+      loop.on(executor::frame_message, handleFrame, executor::normal_priority, true);
+      loop.on(executor::tick_message, handleClock, executor::normal_priority, true);
+      loop.on(executor::idle_message, handleIdle, executor::normal_priority, true);
+      portEXIT_CRITICAL(&lock);
+
+      schedule(executor::tick_message, 0, clock_period, clock_period);
+      timers_idle::canvas_idle = schedule(executor::idle_message, hidden_canvas_event,
+                                          timers_idle::canvas_idle_period, timers_idle::canvas_idle_period);
+      timers_idle::backlight_idle = schedule(executor::idle_message, rest_backlight_event,
+                                             timers_idle::backlight_idle_period, timers_idle::backlight_idle_period);
+    }
+
+    void print()
+    {
+      portENTER_CRITICAL(&lock);
+      const executor::queue_stats_t queue = loop.queue_stats();
+      portEXIT_CRITICAL(&lock);
+
+      ESP_LOGI(log_tag, "Executor queue depth %lu, max %lu, posted %lu, coalesced %lu, dropped %lu\n",
+               static_cast<unsigned long>(queue.depth), static_cast<unsigned long>(queue.max_depth),
+               static_cast<unsigned long>(queue.posted), static_cast<unsigned long>(queue.coalesced),
+               static_cast<unsigned long>(queue.dropped));
+      for (uint8_t type = 0; type < executor::message_count; type++)
+      {
+        const executor::handler_stats_t &stats = loop.stats(static_cast<executor::message_e>(type));
+        if (stats.count == 0)
+          continue;
+        ESP_LOGI(log_tag, "Executor %-8s count %lu, avg %lld us, max %lld us, wait max %lld us\n",
+                 executor::name(static_cast<executor::message_e>(type)), static_cast<unsigned long>(stats.count),
+                 static_cast<long long>(stats.total_us / stats.count), static_cast<long long>(stats.max_us),
+                 static_cast<long long>(stats.wait_max_us));
+      }
+
+      portENTER_CRITICAL(&lock);
+      loop.reset_stats();
+      portEXIT_CRITICAL(&lock);
+    }
+
+  } // namespace events
+
+  /* Handle dump_message, tables requested by StreamDecoMonitor or the top timer */
+  void handleDump(const executor::message_t &message)
+  {
+    streamDeco::mutex_serial.take();
+    switch (message.value)
+    {
+    case trace_dump:
+      print_trace();
+      break;
+#if RTOS_PROFILER
+    case top_dump:
+      print_top();
+      break;
+#endif
+    case memory_dump:
+      telemetry::print();
+      break;
+    case executor_dump:
+      events::print();
+      break;
+    }
+    streamDeco::mutex_serial.give();
+  }
+
+} // namespace streamDeco
@@ -0,0 +1,120 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @file     streamDeco_frameRouter.cpp
+ * @brief    Demultiplex StreamDecoMonitor frames to subscribers
+ */
+
+#include "streamDeco_objects.hpp"
+
+namespace streamDeco
+{
+
+  namespace frameRouter
+  {
+
+    namespace
+    {
+      subscriber_t subscribers[topic_count][frameRouter_max_subscribers] = {};
+
+      /* Post the newest message, drop the oldest one if consumer is late */
+      template <typename Queue>
+      void post_latest(Queue &queue, const frame::slot_t &slot)
+      {
+        frame::slot_t message = slot;
+        if (queue.send(message, 0ms))
+          return;
+
+        frame::slot_t dropped;
+        queue.receive(dropped, 0ms);
+        queue.send(message, 0ms);
+      }
+
+      /* the queues carry the frames, the message wakes the handler that drains them */
+      void post_metrics(const frame::slot_t &slot)
+      {
+        post_latest(metrics_queue, slot);
+        events::post(executor::frame_message);
+      }
+
+      void post_time(const frame::slot_t &slot)
+      {
+        post_latest(time_queue, slot);
+        events::post(executor::tick_message);
+      }
+
+      void notify(topic_e topic, const frame::slot_t &slot)
+      {
+        for (subscriber_t subscriber : subscribers[topic])
+        {
+          if (subscriber == nullptr)
+            break;
+          subscriber(slot);
+        }
+      }
+    }
+
+    bool subscribe(topic_e topic, subscriber_t subscriber)
+    {
+      if (topic >= topic_count || subscriber == nullptr)
+        return false;
+
+      for (subscriber_t &slot : subscribers[topic])
+      {
+        if (slot == nullptr || slot == subscriber)
+        {
+          slot = subscriber;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void publish(const frame::slot_t &slot)
+    {
+      if (slot.type == frame::shortcuts_type)
+      {
+        notify(shortcuts_topic, slot);
+        return;
+      }
+
+      if (slot.type == frame::request_type)
+      {
+        notify(request_topic, slot);
+        return;
+      }
+
+      notify(metrics_topic, slot);
+
+      if (slot.metrics.clock_valid)
+        notify(time_topic, slot);
+    }
+
+    void init()
+    {
+      subscribe(metrics_topic, post_metrics);
+      subscribe(time_topic, post_time);
+    }
+
+  } // namespace frameRouter
+
+} // namespace streamDeco
@@ -25,9 +25,10 @@
 
 #include "streamDeco_objects.hpp"
 #include "streamDeco_handlers.hpp"
-#include "streamDeco_timerCallback.hpp"
 
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+
 
 /**
  * @brief 0 Disable StreamDeco StreamDecoMonitor first sync
@@ -55,6 +56,19 @@ namespace streamDeco
    */
   void sync_clock(int max_attempts);
 
+  /**
+   * @brief    Print internal SRAM taken by bluetooth host
+   * @details  Free internal heap and largest free block before and after bleKeyboard.begin(),
+   *           compare a build with NIMBLE_HID_PERIPHERAL_ONLY to one without it
+   */
+  void print_ble_memory(size_t free_before, size_t largest_before);
+
+  /**
+   * @brief    Answer requests of StreamDecoMonitor
+   * @details  Subscribed to request_topic, run by the ingest handler of streamDecoTasks worker
+   */
+  void request_received(const frame::slot_t &slot);
+
   /**
    * @brief   Init StreamDeco
    * @details Attach StreamDeco's tasks and made buttons configurations, layers and timers
@@ -64,8 +78,19 @@ namespace streamDeco
   void init()
   {
 
+#if RTOS_PROFILER
+    /* LVGL port tasks are already added, the hooks count them from now */
+    rtos::profiler::start();
+#endif
+
     /** init settings cache and update with flash */
     settings::initCache();
+
+    /* load shortcut table from flash, keep it updated by StreamDecoMonitor */
+    shortcuts::init();
+
+    /* toggle buttons show the state sent by the computer */
+    feedback::init();
     
     /* set initial screen rotation and color */
     lvgl::screen::set_rotation(settings::cache.rotation);
@@ -95,7 +120,17 @@ namespace streamDeco
     rtos::sleep(1s); /* see my icon =) */
 
     /* start bluetooth keyboard interface */
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t largest_before = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    initIngest(); /* metrics can come on BLE data service too */
     bleKeyboard.begin();
+    print_ble_memory(free_before, largest_before);
+
+#if RTOS_PROFILER
+    /* tasks not created by rtos::Task or rtos::TaskStatic */
+    rtos::profiler::add(xTaskGetHandle("nimble_host"), "nimble_host");
+    rtos::profiler::add(xTaskGetHandle("loopTask"), "loopTask");
+#endif
 
     /* change icon to show connecting */
     startScreen_label.set_text("Connecting...");
@@ -119,6 +154,12 @@ namespace streamDeco
     startScreen_icon.set_src(&keyboard_simp);
     lvgl::screen::refresh();
 
+    /* frames are reassembled by the worker and routed to
+     * metrics and time queues, start it before first sync */
+    frameRouter::init();
+    frameRouter::subscribe(frameRouter::request_topic, request_received);
+    events::init();
+
 #if DEVOSO_TESTING == 0
     /* make 40 attempts to sync clock with StreamDeco StreamDecoMonitor application */
     sync_clock(40);
@@ -133,67 +174,59 @@ namespace streamDeco
 
     lvgl::port::mutex_take();
 
-    /* --- MAIN BUTTONS --- */
-    streamDecoButtons::createMain(settings::cache);
-
-    /* --- INIT CANVAS --- */
-
-    streamDecoCanvas::init(settings::cache.rotation);
-
-    /* --- APPLICATIONS CANVAS BUTTONS --- */
+    /* --- MAIN BUTTONS, CANVAS, SLIDER AND MONITOR --- */
+    streamDecoScreen::init(settings::cache);
 
-    /* apps buttons is created on Applications canvas */
-    streamDecoButtons::createApplication(streamDecoCanvas::applications, settings::cache);
+    lvgl::port::mutex_give();
 
-    /* --- MULTIMEDIA CANVAS BUTTONS --- */
+    /* widgets exist, route frames, clock and idle timers to the worker */
+    events::start();
 
-    /* multimedia buttons is created on Multimedia canvas */
-    streamDecoButtons::createMultimedia(streamDecoCanvas::multimedia, settings::cache);
+    /* LVGL pool already holds every widget, growth from here is churn or leak */
+    telemetry::init();
 
-    /* --- CONFIGURATIONS --- */
+  } // function init end
 
-    /* configurations buttons is created on Configured canvas */
-    streamDecoButtons::createConfiguration(streamDecoCanvas::configurations, settings::cache);
+  void request_received(const frame::slot_t &slot)
+  {
+    if (slot.payload.size == 0)
+      return;
 
-    /* configure slider bright */
-    streamDecoBrightSlider::init(streamDecoCanvas::configurations, settings::cache);
+    /* printed on dump_message after the frames of this batch, subscribers must not block */
+    if (slot.payload.data[0] == frame::trace_request)
+      events::post(executor::dump_message, trace_dump);
 
-    /* --- MONITOR --- */
+    if (slot.payload.data[0] == frame::memory_request)
+      events::post(executor::dump_message, memory_dump);
 
-    streamDecoMonitor::init(streamDecoCanvas::monitor, settings::cache.color_buttons);
+    if (slot.payload.data[0] == frame::executor_request)
+      events::post(executor::dump_message, executor_dump);
 
-    if (settings::cache.rotation == lvgl::screen::LANDSCAPE)
-    {
-      streamDecoCanvas::landscape();
-      streamDecoBrightSlider::landscape();
-      streamDecoButtons::landscape();
-    }
-    else
+    /* ignored when built without RTOS_PROFILER */
+#if RTOS_PROFILER
+    if (slot.payload.data[0] == frame::top_request)
     {
-      streamDecoCanvas::portrait();
-      streamDecoBrightSlider::portrait();
-      streamDecoButtons::portrait();
+      const uint8_t interval = slot.payload.size > 1 ? slot.payload.data[1] : 0;
+      events::period(timers_profiler::top, seconds(interval));
+      events::post(executor::dump_message, top_dump);
     }
+#endif
+  }
 
-    lvgl::port::mutex_give();
-
-    /* register ISR to handle with timers_idle::backlight_idle and canvas_idle event */
-    timers_idle::backlight_idle.attach(timer_callback);
-    timers_idle::canvas_idle.attach(timer_callback);
-
-    /* start timers_idle::backlight_idle and canvas_idle */
-    timers_idle::backlight_idle.start();
-    timers_idle::canvas_idle.start();
-
-    /* attach tasks handlers and start them */
-    streamDecoTasks::buttons.attach(handleButtons);
-    streamDecoTasks::idle.attach(handleIdle);
-    streamDecoTasks::monitor.attach(handleMonitor);
-    streamDecoTasks::clock.attach(handleClock);
-    streamDecoTasks::clockSync.attach(handleClockSync);
-    streamDecoTasks::updateCache.attach(handleUpdateCache);
+  void print_ble_memory(size_t free_before, size_t largest_before)
+  {
+    size_t free_after = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t largest_after = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
 
-  } // function init end
+#ifdef NIMBLE_HID_PERIPHERAL_ONLY
+    const char *profile = "HID peripheral only";
+#else
+    const char *profile = "default";
+#endif
+    ESP_LOGI(log_tag, "BLE %s profile, internal heap free %u -> %u bytes (%d), largest block %u -> %u bytes\n",
+             profile, free_before, free_after, static_cast<int>(free_after - free_before),
+             largest_before, largest_after);
+  }
 
   /**
    * @brief   Print tasks memory usage
@@ -202,12 +235,171 @@ namespace streamDeco
    */
   void print_task_memory_usage()
   {
-    ESP_LOGI(log_tag, "Task Buttons mem usage %d kB\n", streamDecoTasks::buttons.memUsage());
-    ESP_LOGI(log_tag, "Task UI Reset mem usage %d kB\n", streamDecoTasks::idle.memUsage());
-    ESP_LOGI(log_tag, "Task Monitor mem usage %d kB\n", streamDecoTasks::monitor.memUsage());
-    ESP_LOGI(log_tag, "Task Clock mem usage %d kB\n", streamDecoTasks::clock.memUsage());
-    ESP_LOGI(log_tag, "Task Clock sync mem usage %d kB\n", streamDecoTasks::clockSync.memUsage());
-    ESP_LOGI(log_tag, "Task Cache update mem usage %d kB\n", streamDecoTasks::updateCache.memUsage());
+    ESP_LOGI(log_tag, "Task Worker mem usage %d kB\n", streamDecoTasks::worker.memUsage());
+
+    TaskHandle_t nimble_host = xTaskGetHandle("nimble_host");
+    if (nimble_host)
+      ESP_LOGI(log_tag, "Task NimBLE host stack free %u bytes\n", uxTaskGetStackHighWaterMark(nimble_host));
+  }
+
+  /**
+   * @brief   Print StreamDecoMonitor frames latency
+   * @details Time from first byte arrival to monitor widgets update
+   */
+  void print_frame_latency()
+  {
+    ESP_LOGI(log_tag, "Frame latency last %lld us, avg %lld us, max %lld us, frames %lu\n",
+             monitor_latency.last(), monitor_latency.average(), monitor_latency.max(),
+             static_cast<unsigned long>(monitor_latency.count()));
+    ESP_LOGI(log_tag, "Serial frames %lu, avg %lld us, BLE frames %lu, avg %lld us, MTU %u, dropped %lu bytes, refused %lu frames\n",
+             static_cast<unsigned long>(transport_latency[frame::transport_serial].count()),
+             transport_latency[frame::transport_serial].average(),
+             static_cast<unsigned long>(transport_latency[frame::transport_ble].count()),
+             transport_latency[frame::transport_ble].average(),
+             bleKeyboard.getMtu(), static_cast<unsigned long>(ingestDropped()),
+             static_cast<unsigned long>(ingestRefused()));
+    ESP_LOGI(log_tag, "Monitor frame LVGL lock takes %lu, acquisitions %lu\n",
+             static_cast<unsigned long>(monitor_lock_takes),
+             static_cast<unsigned long>(monitor_lock_acquisitions));
+  }
+
+  /**
+   * @brief   Print keyboard shortcuts latency
+   * @details Time from button event to the last HID report notified
+   */
+  void print_shortcut_latency()
+  {
+    ESP_LOGI(log_tag, "Shortcut latency last %lld us, avg %lld us, max %lld us, shortcuts %lu\n",
+             shortcut_latency.last(), shortcut_latency.average(), shortcut_latency.max(),
+             static_cast<unsigned long>(shortcut_latency.count()));
+    ESP_LOGI(log_tag, "HID reports dropped %lu, congestions %lu\n",
+             static_cast<unsigned long>(bleKeyboard.getDroppedCount()),
+             static_cast<unsigned long>(bleKeyboard.getCongestionCount()));
+    ESP_LOGI(log_tag, "BLE interval %u.%02u ms, latency %u, %s, requests %lu, rejected %lu\n",
+             bleKeyboard.getConnInterval() * 125 / 100, bleKeyboard.getConnInterval() * 125 % 100,
+             bleKeyboard.getConnLatency(),
+             bleKeyboard.getConnMode() == BleConnectionPolicy::ACTIVE ? "active" : "idle",
+             static_cast<unsigned long>(bleKeyboard.getConnRequests()),
+             static_cast<unsigned long>(bleKeyboard.getConnRejected()));
+
+    ESP_LOGI(log_tag, "BLE host %u, %u of %u connected, switch last %lld us, max %lld us\n",
+             bleKeyboard.getActiveHost(), bleKeyboard.getHostCount(), BLE_KEYBOARD_MAX_HOSTS,
+             bleKeyboard.getLastSwitchLatency(), bleKeyboard.getMaxSwitchLatency());
+
+    int64_t play_us = bleKeyboard.getLastPlayTime();
+    uint32_t characters = shortcuts::characters();
+    ESP_LOGI(log_tag, "Last macro %lu chars in %lld us, %lu chars/s\n",
+             static_cast<unsigned long>(characters), play_us,
+             static_cast<unsigned long>(play_us > 0 ? characters * 1000000LL / play_us : 0));
+
+    uint32_t buckets[BLE_LATENCY_BUCKETS];
+    bleKeyboard.getLatencyHistogram(buckets);
+    for (uint8_t bucket = 0; bucket < BLE_LATENCY_BUCKETS; bucket++)
+    {
+      if (bucket < BLE_LATENCY_BUCKETS - 1)
+        ESP_LOGI(log_tag, "HID report latency < %lu ms: %lu\n",
+                 static_cast<unsigned long>(BleKeyboard::LATENCY_LIMITS_US[bucket] / 1000),
+                 static_cast<unsigned long>(buckets[bucket]));
+      else
+        ESP_LOGI(log_tag, "HID report latency longer: %lu\n", static_cast<unsigned long>(buckets[bucket]));
+    }
+  }
+
+  /**
+   * @brief   Print tap to keystroke trace
+   * @details Each stage is measured from the previous stage of the same tap,
+   *          handlers running on the worker before the tap show up on wake stage
+   */
+  void print_trace()
+  {
+    trace::stats_t stages[trace::stage_count];
+    trace::stats_t total;
+    tracer.summary(stages, total);
+
+    ESP_LOGI(log_tag, "Trace taps %lu, tap to key p50 %lu us, p99 %lu us, max %lu us\n",
+             static_cast<unsigned long>(stages[trace::touch_stage].count),
+             static_cast<unsigned long>(total.p50), static_cast<unsigned long>(total.p99),
+             static_cast<unsigned long>(total.max));
+    for (uint8_t stage = trace::input_stage; stage < trace::stage_count; stage++)
+      ESP_LOGI(log_tag, "Trace %-6s p50 %lu us, p99 %lu us, max %lu us, samples %lu\n",
+               trace::name(static_cast<trace::stage_e>(stage)),
+               static_cast<unsigned long>(stages[stage].p50), static_cast<unsigned long>(stages[stage].p99),
+               static_cast<unsigned long>(stages[stage].max), static_cast<unsigned long>(stages[stage].count));
+
+    /* stage times of the last taps, from its touch interrupt */
+    constexpr uint32_t last_taps = 8;
+    trace::record_t records[trace::ring_size];
+    size_t count = tracer.snapshot(records, trace::ring_size);
+    uint32_t last = tracer.current();
+    for (uint32_t tap = last > last_taps ? last - last_taps + 1 : 1; tap <= last; tap++)
+    {
+      int64_t times[trace::stage_count];
+      for (int64_t &time : times)
+        time = -1;
+      for (size_t i = 0; i < count; i++)
+        if (records[i].tap == tap)
+          times[records[i].stage] = records[i].us;
+      if (times[trace::touch_stage] < 0)
+        continue;
+
+      char line[96];
+      int length = 0;
+      for (uint8_t stage = trace::input_stage; stage < trace::stage_count; stage++)
+      {
+        if (times[stage] < 0)
+          length += snprintf(&line[length], sizeof(line) - length, " %s -", trace::name(static_cast<trace::stage_e>(stage)));
+        else
+          length += snprintf(&line[length], sizeof(line) - length, " %s %lu", trace::name(static_cast<trace::stage_e>(stage)),
+                             static_cast<unsigned long>(static_cast<uint32_t>(times[stage] - times[trace::touch_stage])));
+      }
+      ESP_LOGI(log_tag, "Trace tap %lu:%s us\n", static_cast<unsigned long>(tap), line);
+    }
+  }
+
+#if RTOS_PROFILER
+  /**
+   * @brief   Print task profiler table
+   * @details CPU of a task is the percentage of one core, tasks not pinned
+   *          are shown on the last core they were found running
+   */
+  void print_top()
+  {
+    static rtos::profiler::report_t report;
+    rtos::profiler::sample(report);
+
+    uint32_t ticks = 0;
+    uint32_t hook_cycles = 0;
+    for (const rtos::profiler::core_stats_t &core : report.cores)
+    {
+      ticks += core.ticks;
+      hook_cycles += core.hook_cycles;
+    }
+    if (ticks == 0)
+      return;
+
+    ESP_LOGI(log_tag, "Top window %lu ticks, %u tasks, hook %lu cycles, overhead %.3f %%\n",
+             static_cast<unsigned long>(ticks / rtos::profiler::core_count), static_cast<unsigned>(report.count),
+             static_cast<unsigned long>(hook_cycles / ticks),
+             100.0f * hook_cycles / (static_cast<float>(ticks) * report.cycles_per_tick));
+    for (uint8_t core = 0; core < rtos::profiler::core_count; core++)
+    {
+      const rtos::profiler::core_stats_t &stats = report.cores[core];
+      if (stats.ticks == 0)
+        continue;
+      ESP_LOGI(log_tag, "Top core %u load %.1f %%, switches %lu, unregistered %.1f %%\n", core,
+               100.0f * (stats.ticks - stats.idle_ticks) / stats.ticks, static_cast<unsigned long>(stats.switches),
+               100.0f * stats.other_ticks / stats.ticks);
+    }
+
+    const float core_ticks = static_cast<float>(ticks) / rtos::profiler::core_count;
+    for (size_t index = 0; index < report.count; index++)
+    {
+      const rtos::profiler::task_stats_t &task = report.tasks[index];
+      ESP_LOGI(log_tag, "Top task %.1f %%, core %c, runs %lu, stack %lu, %s\n", 100.0f * task.ticks / core_ticks,
+               task.core == rtos::profiler::no_core ? '-' : '0' + task.core, static_cast<unsigned long>(task.runs),
+               static_cast<unsigned long>(task.stack_free), task.name);
+    }
   }
+#endif
 
 } // namespace streamDeco
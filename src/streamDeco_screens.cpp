@@ -0,0 +1,780 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file    streamDeco_screens.cpp
+ * @brief   Declare StreamDeco's screen objects
+ * @details Icons and text of buttons can be change in this file, it only
+ *          needs LVGL so the native render benchmark draws the same screen
+ */
+
+#include "streamDeco_screens.hpp"
+
+namespace streamDeco
+{
+
+  /**
+   * @namespace  streamDecoCanvas
+   * @brief Canvas to hold additional buttons
+   */
+  namespace streamDecoCanvas
+  {
+    
+      void setup_canvas_style(lvgl::Style &style, int x, int y, int width, int height)
+      {
+        style.set_pad_all(0);
+        style.set_bg_color(lvgl::color::make(41, 45, 50));
+        style.align(lvgl::alignment::CENTER, x, y);
+        style.set_size(width, height);
+      }
+
+      void apply_canvas_style(lvgl::Style &style)
+      {
+        lvgl::port::mutex_take();
+        applications.add_style(style, lvgl::part::MAIN);
+        multimedia.add_style(style, lvgl::part::MAIN);
+        configurations.add_style(style, lvgl::part::MAIN);
+        monitor.add_style(style, lvgl::part::MAIN);
+        lvgl::port::mutex_give();
+      }
+
+    /**
+     * @var     applications
+     * @brief   Applications Canvas
+     * @details Canvas to hold addtional apps shortcuts
+     **/
+    lvgl::Canvas applications;
+
+    /**
+     * @var     multimedia
+     * @brief   Multimedia Canvas
+     * @details Canvas to hold multimedia apps shortcuts
+     **/
+    lvgl::Canvas multimedia;
+
+    /**
+     * @var     Configutations
+     * @brief   Configurations Canvas
+     * @details Canvas to hold configurations shortcuts
+     **/
+    lvgl::Canvas configurations;
+
+    /**
+     * @var     monitor
+     * @brief   Monitor Canvas
+     * @details Canvas to monitor computer stats
+     **/
+    lvgl::Canvas monitor;
+
+    /**
+     * @var     style_landscape
+     * @brief   Style Canvas in landscape
+     * @details Style for streamDecoCanvas in landscape */
+    lvgl::Style style_landscape;
+
+    /**
+     * @var     style_portrait
+     * @brief   Style Canvas in portrait
+     * @details Style for streamDecoCanvas in portrait */
+    lvgl::Style style_portrait;
+
+    void init(lvgl::screen::rotation_t rotation)
+    {
+      /* configure style of streamDecoCanvas */
+      setup_canvas_style(style_landscape, -74, 0, 582, 470);
+      setup_canvas_style(style_portrait, 0, -74, 470, 582);
+
+      /* configure Applications streamDecoCanvas */
+      applications.create();
+      applications.hidden();
+
+      /* configure Multimedia streamDecoCanvas */
+      multimedia.create();
+      multimedia.hidden();
+
+      /* Configurations streamDecoCanvas */
+      configurations.create();
+      configurations.hidden();
+
+      /* Monitor streamDecoCanvas */
+      monitor.create();
+      monitor.hidden();
+
+      rotation == lvgl::screen::LANDSCAPE ? landscape() : portrait();
+    }
+
+    void portrait()
+    {
+      apply_canvas_style(style_portrait);
+    }
+
+    void landscape()
+    {
+      apply_canvas_style(style_landscape);
+    }
+  } // namespace streamDecoCanvas
+
+  /**
+   * @namespace  streamDecoButtons
+   * @brief      Buttons of StreamDeco
+    * @details    Button icons can be changed here
+   *
+   * @note    The difference between mainIcon, CanvasButton and ConfigButton
+   *          is position map
+   * @code
+   * streamDeco::MainButton(
+   *          "Terminal",     // name, show name if icon not used
+   *          &terminal_simp, // first icon
+   *          nullptr            // second icon, if used the icons can be swaped using swap_icon
+   * ),
+   **/
+  namespace streamDecoButtons
+  {
+
+    /**
+      * @brief   Callback registered on buttons
+      * @details Post button_message with event code to the worker
+     * @param   lvglEvent  Event received by the callback
+      * @note    This callback is registered on buttons and streamDecoBrightSlider objects
+     * @note    Each streamDecoButtons and streamDecoBrightSlider send a different event
+     **/
+    void buttons_callback(lvgl::event::event_t lvglEvent);
+
+    /* ---   Main screen buttons   --- */
+
+    /* Applications line, first line of buttons */
+    streamDeco::MainButton terminal("Terminal", &terminal_simp, nullptr);
+    streamDeco::MainButton files("Files", &files_simp, nullptr);
+    streamDeco::MainButton web("Web", &web_simp, nullptr);
+    streamDeco::MainButton search("Search", &search_simp, nullptr);
+    streamDeco::MainButton applications_canvas("Application", &applications_simp, nullptr);
+
+    /* Multimedia line, second line of buttons */
+    streamDeco::MainButton multimedia_prev("Prev", &backward_simp, nullptr);
+    streamDeco::MainButton multimedia_play("Play/Pause", &play_simp, &pause_simp);
+    streamDeco::MainButton multimedia_next("Next", &forward_simp, nullptr);
+    streamDeco::MainButton multimedia_mic("Mic", &mic_on_simp, &mic_off_simp);
+    streamDeco::MainButton multimedia_canvas("Multimedia", &multimedia_simp, nullptr);
+
+    /* Configurations line, third line of buttons */
+    streamDeco::MainButton left_workspace("Left Workspace", &previous_workspace_simp, nullptr);
+    streamDeco::MainButton right_workspace("Right Workspace", &next_workspace_simp, nullptr);
+    streamDeco::MainButton pin("Pin", &pin_simp, &unpin_simp);
+    streamDeco::MainButton ruler("Ruler", &ruler_simp, nullptr);
+    streamDeco::MainButton configurations_canvas("Config", &config_simp, nullptr);
+
+    /* ---   Applications canvas buttons   --- */
+
+    /* First line */
+    streamDeco::CanvasButton app1("app1", &gogcom_simp, nullptr);
+    streamDeco::CanvasButton app2("app2", &discord_simp, nullptr);
+    streamDeco::CanvasButton app3("app3", &fps_simp, nullptr);
+
+    /* Second line */
+    streamDeco::CanvasButton app4("app4", &code_simp, nullptr);
+    streamDeco::CanvasButton app5("app5", &texcompiler_simp, nullptr);
+    streamDeco::CanvasButton app6("app6", &calculator_simp, nullptr);
+
+    /* Third line */
+    streamDeco::CanvasButton app7("app7", &build_simp, nullptr);
+    streamDeco::CanvasButton app8("app8", &download_simp, nullptr);
+    streamDeco::CanvasButton app9("app9", &serialport_simp, nullptr);
+
+    /* ---   Multimedia canvas buttons   --- */
+
+    /* First line */
+    streamDeco::CanvasButton mult1("mult 1", &video_stop_capt_simp, &video_start_capt_simp);
+    streamDeco::CanvasButton mult2("mult 2", &mic_off_simp, &mic_on_simp);
+    streamDeco::CanvasButton mult3("mult 3", &screen_capt_simp, nullptr);
+
+    /* Second line */
+    streamDeco::CanvasButton mult4("mult 4", &add_clip_simp, nullptr);
+    streamDeco::CanvasButton mult5("mult 5", &ripple_simp, nullptr);
+    streamDeco::CanvasButton mult6("mult 6", &rolling_simp, nullptr);
+
+    /* Third line */
+    streamDeco::CanvasButton mult7("mult 7", &seek_backward_simp, nullptr);
+    streamDeco::CanvasButton mult8("mult 8", &play_simp, nullptr);
+    streamDeco::CanvasButton mult9("mult 9", &seek_forward_simp, nullptr);
+
+    /* ---   Configurations canvas buttons   --- */
+
+    /* First line */
+    streamDeco::ConfigButton volmut("Vol Mute", &volume_mute_simp, nullptr);
+    streamDeco::ConfigButton voldown("Vol Down", &volume_low_simp, nullptr);
+    streamDeco::ConfigButton volup("Vol Up", &volume_high_simp, nullptr);
+
+    /* Second line */
+    streamDeco::ConfigButton color_background("Color BG", &bgtheme_simp, nullptr);
+    streamDeco::ConfigButton color_button("Color Buttons", &btntheme_simp, nullptr);
+    streamDeco::ConfigButton rotation("Rotation", &rotation_simp, nullptr);
+
+    /* Third line */
+    streamDeco::ConfigButton sysmonitor("System Monitor", &sysmon_simp, nullptr);
+    streamDeco::ConfigButton sysconfig("System Config", &config_simp, nullptr);
+    streamDeco::ConfigButton reboot("Reboot", &reboot_simp, nullptr);
+
+    /**
+     * @brief  Create the main canva buttons
+     * @param  settings  Settings configuration
+     */
+    void createMain(settings::settings_t settings)
+    {
+      /* the class MainButton deal with position buttons,
+       * is only necessary pass the order */
+      terminal.create(0, settings.color_buttons);
+      files.create(1, settings.color_buttons);
+      web.create(2, settings.color_buttons);
+      search.create(3, settings.color_buttons);
+      applications_canvas.create(4, settings.color_buttons);
+
+      multimedia_prev.create(5, settings.color_buttons);
+      multimedia_play.create(6, settings.color_buttons);
+      multimedia_next.create(7, settings.color_buttons);
+      multimedia_mic.create(8, settings.color_buttons);
+      multimedia_canvas.create(9, settings.color_buttons);
+
+      left_workspace.create(10, settings.color_buttons);
+      right_workspace.create(11, settings.color_buttons);
+      pin.create(12, settings.color_buttons);
+      ruler.create(13, settings.color_buttons);
+      configurations_canvas.create(14, settings.color_buttons);
+
+      /* register buttons event */
+      terminal.callback(buttons_callback, lvgl::event::PRESSED, terminal_event);
+      files.callback(buttons_callback, lvgl::event::PRESSED, files_event);
+      web.callback(buttons_callback, lvgl::event::PRESSED, web_event);
+      search.callback(buttons_callback, lvgl::event::PRESSED, search_event);
+      applications_canvas.callback(buttons_callback, lvgl::event::SHORT_CLICKED, applications_canvas_event);
+      applications_canvas.callback(buttons_callback, lvgl::event::LONG_PRESSED, applications_canvas_fix_event);
+
+      multimedia_prev.callback(buttons_callback, lvgl::event::PRESSED, multimedia_prev_event);
+      multimedia_play.callback(buttons_callback, lvgl::event::PRESSED, multimedia_play_event);
+      multimedia_next.callback(buttons_callback, lvgl::event::PRESSED, multimedia_next_event);
+      multimedia_mic.callback(buttons_callback, lvgl::event::PRESSED, multimedia_mic_event);
+      multimedia_canvas.callback(buttons_callback, lvgl::event::SHORT_CLICKED, multimedia_canvas_event);
+      multimedia_canvas.callback(buttons_callback, lvgl::event::LONG_PRESSED, multimedia_canvas_fix_event);
+
+      left_workspace.callback(buttons_callback, lvgl::event::PRESSED, left_workspace_event);
+      right_workspace.callback(buttons_callback, lvgl::event::PRESSED, right_workspace_event);
+      pin.callback(buttons_callback, lvgl::event::PRESSED, pin_window_event);
+      ruler.callback(buttons_callback, lvgl::event::PRESSED, ruler_event);
+      configurations_canvas.callback(buttons_callback, lvgl::event::SHORT_CLICKED, configurations_canvas_event);
+      configurations_canvas.callback(buttons_callback, lvgl::event::LONG_PRESSED, configurations_canvas_fix_event);
+    }
+
+    /**
+     * @brief  Create the applications canva buttons
+     * @param  parent    Object parent of the new slider
+     * @param  settings  Settings configuration
+     */
+    void createApplication(lvgl::Object &parent, settings::settings_t settings)
+    {
+      app1.create(parent, 0, settings.color_buttons);
+      app2.create(parent, 1, settings.color_buttons);
+      app3.create(parent, 2, settings.color_buttons);
+
+      app4.create(parent, 3, settings.color_buttons);
+      app5.create(parent, 4, settings.color_buttons);
+      app6.create(parent, 5, settings.color_buttons);
+
+      app7.create(parent, 6, settings.color_buttons);
+      app8.create(parent, 7, settings.color_buttons);
+      app9.create(parent, 8, settings.color_buttons);
+
+      /* register the events of buttons */
+      app1.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app1_event);
+      app2.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app2_event);
+      app3.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app3_event);
+
+      app4.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app4_event);
+      app5.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app5_event);
+      app6.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app6_event);
+
+      app7.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app7_event);
+      app8.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app8_event);
+      app9.callback(buttons_callback, lvgl::event::PRESSED, applications_canvas_app9_event);
+    }
+
+    /**
+     * @brief  Create the multimedia canva buttons
+     * @param  parent    Object parent of the new slider
+     * @param  settings  Settings configuration
+     */
+    void createMultimedia(lvgl::Object &parent, settings::settings_t settings)
+    {
+      mult1.create(parent, 0, settings.color_buttons);
+      mult2.create(parent, 1, settings.color_buttons);
+      mult3.create(parent, 2, settings.color_buttons);
+
+      mult4.create(parent, 3, settings.color_buttons);
+      mult5.create(parent, 4, settings.color_buttons);
+      mult6.create(parent, 5, settings.color_buttons);
+
+      mult7.create(parent, 6, settings.color_buttons);
+      mult8.create(parent, 7, settings.color_buttons);
+      mult9.create(parent, 8, settings.color_buttons);
+
+      /* register the events of buttons */
+      mult1.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult1_event);
+      mult2.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult2_event);
+      mult3.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult3_event);
+
+      mult4.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult4_event);
+      mult5.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult5_event);
+      mult6.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult6_event);
+
+      mult7.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult7_event);
+      mult8.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult8_event);
+      mult9.callback(buttons_callback, lvgl::event::PRESSED, multimedia_canvas_mult9_event);
+
+      /* change pinned color of some buttons */
+      mult1.iconPinnedColor(lvgl::color::make(255, 0, 0));
+      mult1.buttonPinnedColor(lvgl::palette::CYAN);
+      mult2.iconPinnedColor(lvgl::color::make(255, 0, 0));
+      mult2.buttonPinnedColor(lvgl::palette::CYAN);
+    }
+
+    /**
+     * @brief  Create the configuration canva buttons
+     * @param  parent    Object parent of the new slider
+     * @param  settings  Settings configuration
+     */
+    void createConfiguration(lvgl::Object &parent, settings::settings_t settings)
+    {
+      volmut.create(parent, 0, settings.color_buttons);
+      voldown.create(parent, 1, settings.color_buttons);
+      volup.create(parent, 2, settings.color_buttons);
+
+      color_background.create(parent, 3, settings.color_buttons);
+      color_button.create(parent, 4, settings.color_buttons);
+      rotation.create(parent, 5, settings.color_buttons);
+
+      sysmonitor.create(parent, 6, settings.color_buttons);
+      sysconfig.create(parent, 7, settings.color_buttons);
+      reboot.create(parent, 8, settings.color_buttons);
+
+      /* register the events of buttons */
+      volmut.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_volmut_event);
+      voldown.callback(buttons_callback, lvgl::event::PRESSING, configuration_canvas_voldown_event);
+      volup.callback(buttons_callback, lvgl::event::PRESSING, configuration_canvas_volup_event);
+
+      color_background.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_colorbackground_event);
+      color_button.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_colorbutton_event);
+      rotation.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_rotate_screen_event);
+
+      sysmonitor.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_sysmonitor_event);
+      sysconfig.callback(buttons_callback, lvgl::event::SHORT_CLICKED, configuration_canvas_sysconfig_event);
+      sysconfig.callback(buttons_callback, lvgl::event::LONG_PRESSED, configuration_canvas_switch_host_event);
+      reboot.callback(buttons_callback, lvgl::event::PRESSED, configuration_canvas_reboot_event);
+    }
+
+    /**
+     * @brief  Change color of Buttons
+     * @param  color  New button color
+     * @note   Called in color_button event
+     **/
+    void color(lvgl::palette::palette_t color)
+    {
+      terminal.buttonColor(color);
+      files.buttonColor(color);
+      web.buttonColor(color);
+      search.buttonColor(color);
+      applications_canvas.buttonColor(color);
+      multimedia_prev.buttonColor(color);
+      multimedia_play.buttonColor(color);
+      multimedia_next.buttonColor(color);
+      multimedia_mic.buttonColor(color);
+      multimedia_canvas.buttonColor(color);
+      left_workspace.buttonColor(color);
+      right_workspace.buttonColor(color);
+      pin.buttonColor(color);
+      ruler.buttonColor(color);
+      configurations_canvas.buttonColor(color);
+      app1.buttonColor(color);
+      app2.buttonColor(color);
+      app3.buttonColor(color);
+      app4.buttonColor(color);
+      app5.buttonColor(color);
+      app6.buttonColor(color);
+      app7.buttonColor(color);
+      app8.buttonColor(color);
+      app9.buttonColor(color);
+      mult1.buttonColor(color);
+      mult2.buttonColor(color);
+      mult3.buttonColor(color);
+      mult4.buttonColor(color);
+      mult5.buttonColor(color);
+      mult6.buttonColor(color);
+      mult7.buttonColor(color);
+      mult8.buttonColor(color);
+      mult9.buttonColor(color);
+      volmut.buttonColor(color);
+      voldown.buttonColor(color);
+      volup.buttonColor(color);
+      color_background.buttonColor(color);
+      color_button.buttonColor(color);
+      rotation.buttonColor(color);
+      sysmonitor.buttonColor(color);
+      sysconfig.buttonColor(color);
+      reboot.buttonColor(color);
+    } // function color
+
+    /**
+     * @brief  Sort buttons in portrait order
+     **/
+    void portrait()
+    {
+      terminal.position(0);
+      files.position(3);
+      web.position(6);
+      search.position(9);
+      applications_canvas.position(12);
+      multimedia_prev.position(1);
+      multimedia_play.position(4);
+      multimedia_next.position(7);
+      multimedia_mic.position(10);
+      multimedia_canvas.position(13);
+      left_workspace.position(2);
+      right_workspace.position(5);
+      pin.position(8);
+      ruler.position(11);
+      configurations_canvas.position(14);
+      volmut.position(0);
+      voldown.position(1);
+      volup.position(2);
+      color_background.position(3);
+      color_button.position(4);
+      rotation.position(5);
+      sysmonitor.position(6);
+      sysconfig.position(7);
+      reboot.position(8);
+    } // function portrait
+
+    /**
+     * @brief  Sort buttons in landscape order
+     **/
+    void landscape()
+    {
+      terminal.position(0);
+      files.position(1);
+      web.position(2);
+      search.position(3);
+      applications_canvas.position(4);
+      multimedia_prev.position(5);
+      multimedia_play.position(6);
+      multimedia_next.position(7);
+      multimedia_mic.position(8);
+      multimedia_canvas.position(9);
+      left_workspace.position(10);
+      right_workspace.position(11);
+      pin.position(12);
+      ruler.position(13);
+      configurations_canvas.position(14);
+      volmut.position(0);
+      voldown.position(1);
+      volup.position(2);
+      color_background.position(3);
+      color_button.position(4);
+      rotation.position(5);
+      sysmonitor.position(6);
+      sysconfig.position(7);
+      reboot.position(8);
+    } // function landscape
+
+  } // namespace streamDecoButtons
+
+  /**
+   * @namespace  streamDecoBrightSlider
+   * @brief      Bright control Slider
+   * @details    Organize streamDecoBrightSlider bight backlight
+   **/
+  namespace streamDecoBrightSlider
+  {
+    /**
+     * @var    slider
+     * @brief  Backlight bright control streamDecoBrightSlider
+     **/
+    lvgl::Slider slider;
+
+    /**
+     * @var    styler
+     * @brief  Backlight bright control streamDecoBrightSlider style
+     **/
+    lvgl::Style slider_style;
+
+    /**
+     * @var    icon
+     * @brief  Backlight bright control icon
+     **/
+    lvgl::Image icon;
+
+    /**
+     * @var    icon
+     * @brief  Backlight bright control icon style
+     **/
+    lvgl::Style icon_style;
+
+    /**
+     * @brief  Init backlight streamDecoBrightSlider
+     * @param  parent    Object parent of the new slider
+     * @param  callback  The new event function
+     * @param  icon      Pointer to an lvgl::lv_img_dsc_t to be streamDecoBrightSlider icon
+     * @param  settings  Settings configuration
+     **/
+    void init(lvgl::Object &parent, settings::settings_t &settings)
+    {
+      /* configure streamDecoBrightSlider bright */
+      slider.create(parent);
+      slider.set_range(lvgl::port::backlight_max() * .1, lvgl::port::backlight_max());
+      slider.set_ext_click_area(30);
+      slider.set_value(settings.lcd_bright);
+      slider_style.set_bg_color(settings.color_buttons);
+      slider.add_style(slider_style, lvgl::part::INDICATOR);
+      slider.add_style(slider_style, lvgl::part::KNOB);
+      slider.add_event_cb(streamDecoButtons::buttons_callback, lvgl::event::VALUE_CHANGED, slider_backlight_bright_value_change_event);
+      icon.create(parent);
+      icon_style.set_img_recolor(settings.color_buttons);
+      icon_style.set_img_recolor_opa(lvgl::opacity::OPA_COVER);
+      icon.add_style(icon_style, lvgl::part::MAIN);
+      icon.set_src(&brightness_simp);
+      lvgl::port::backlight_setRaw(settings.lcd_bright);
+      settings.rotation == lvgl::screen::LANDSCAPE ? landscape() : portrait();
+    }
+
+    /**
+     * @brief  Put slider in landscape format
+     */
+    void landscape()
+    {
+      slider.set_pos(494 + 10, 92);
+      slider.set_size(20, 240);
+      icon.set_pos(484 + 10, 345);
+    }
+
+    /**
+     * @brief  Put slider in portrait format
+     */
+    void portrait()
+    {
+      slider.set_pos(92, 494 + 10);
+      slider.set_size(240, 20);
+      icon.set_pos(345, 484 + 10);
+    }
+
+    /**
+     * @brief  Return slider bright value
+     * @note   Same as slider.get_value
+     */
+    int read()
+    {
+      return slider.get_value();
+    }
+
+    /**
+     * @brief  Change color of slider
+     * @param  color  New slider color
+     * @note   Called in color_button event
+     **/
+    void color(lvgl::palette::palette_t color)
+    {
+      lvgl::port::mutex_take();
+      slider_style.set_bg_color(color);
+      icon_style.set_img_recolor(color);
+      lvgl::port::mutex_give();
+    }
+
+  } // namespace streamDecoBrightSlider
+
+  /**
+   * @namespace  streamDecoMonitor
+   * @brief      Monitor computer metrics
+   * @details    Organize monitor metrics
+   **/
+  namespace streamDecoMonitor
+  {
+    /**
+     * @var      cpu
+     * @brief    Metric CPU
+     * @details  Show CPU load, temperature and frequency metrics in complete metric
+     **/
+    metric::Complete cpu("CPU", &processor_22_simp);
+
+    /**
+     * @var      gpu
+     * @brief    Metric GPU
+     * @details  Show GPU load, temperature and frequency metrics in complete metric
+     **/
+    metric::Complete gpu("GPU", &gpu_22_simp);
+
+    /**
+     * @var      system
+     * @brief    Metric system
+     * @details  Show RAM and Disk usage metrics in basic metric
+     **/
+    metric::Basic system("MEM", &ram_22_simp);
+
+    /**
+     * @var      clock
+     * @brief    Clock metric
+     * @details  Show clock with time and data
+     **/
+    metric::Clock clock("Clock", &clock_22_simp);
+
+    /**
+     * @brief  Init system monitor applet
+     * @param  parent  Object parent of the new slider
+     * @param  color   Monitor applet color
+     */
+    void init(lvgl::Object &parent, lvgl::palette::palette_t color)
+    {
+      cpu.create(parent, color);
+      cpu.set_size(280, 200);
+      cpu.set_pos(14, 25);
+
+      cpu.bar1_set_range(0, 100);
+      cpu.bar2_set_range(0, 3600);
+      cpu.set_deadband(1, 1, 25); // load ±1 %, temperature ±1 °C, frequency ±25 MHz jitter
+
+      gpu.create(parent, color);
+      gpu.set_size(280, 200);
+      gpu.set_pos(14, 25 + 200 + 20);
+
+      gpu.bar1_set_range(0, 100);
+      gpu.bar2_set_range(0, 3300);
+      gpu.set_deadband(1, 1, 25);
+
+      system.create(parent, color);
+      system.set_size(250, 200);
+      system.set_pos(14 + 280 + 14, 25);
+      system.set_deadband(16, 0); // RAM ±16 MB jitter
+
+      clock.create(parent, color);
+      clock.set_size(250, 200);
+      clock.set_pos(14 + 280 + 14, 25 + 200 + 20);
+    } // end init
+
+    /**
+     * @brief  Show the metrics of a StreamDecoMonitor frame
+     * @param  metrics  Decoded frame
+     * @note   Widgets skip the values inside their deadband, nothing is redrawn for them
+     */
+    void update(const frame::metrics_t &metrics)
+    {
+      cpu.arc_set_value(metrics.cpu_load);
+      cpu.bar1_set_value(metrics.cpu_temp, "", " °C");
+      cpu.bar2_set_value(metrics.cpu_freq, "", " MHz");
+
+      gpu.arc_set_value(metrics.gpu_load);
+      gpu.bar1_set_value(metrics.gpu_temp, "", " °C");
+      gpu.bar2_set_value(metrics.gpu_freq, "", " MHz");
+
+      system.bar1_set_range(0, metrics.mem_max);
+      system.bar2_set_range(0, metrics.disk_max);
+
+      system.bar1_set_value(metrics.mem_used, "RAM: ", " MB");
+      system.bar2_set_value(metrics.disk_used, metrics.disk_max, "C: ", " GB");
+    } // end update
+
+    /**
+     * @brief  Change color of Monitor
+     * @param  color  New monitor color
+     * @note   Called in color_button event
+     **/
+    void color(lvgl::palette::palette_t color)
+    {
+      lvgl::port::mutex_take();
+      cpu.color(color);
+      gpu.color(color);
+      system.color(color);
+      clock.color(color);
+      lvgl::port::mutex_give();
+    }
+
+  } // namespace streamDecoMonitor
+
+  /**
+   * @namespace  streamDecoScreen
+   * @brief      Whole StreamDeco screen
+   **/
+  namespace streamDecoScreen
+  {
+    /**
+     * @brief  Create every object of the screen in the settings rotation
+     * @param  settings  Settings configuration
+     */
+    void init(settings::settings_t &settings)
+    {
+      /* --- MAIN BUTTONS --- */
+      streamDecoButtons::createMain(settings);
+
+      /* --- INIT CANVAS --- */
+
+      streamDecoCanvas::init(settings.rotation);
+
+      /* --- APPLICATIONS CANVAS BUTTONS --- */
+
+      /* apps buttons is created on Applications canvas */
+      streamDecoButtons::createApplication(streamDecoCanvas::applications, settings);
+
+      /* --- MULTIMEDIA CANVAS BUTTONS --- */
+
+      /* multimedia buttons is created on Multimedia canvas */
+      streamDecoButtons::createMultimedia(streamDecoCanvas::multimedia, settings);
+
+      /* --- CONFIGURATIONS --- */
+
+      /* configurations buttons is created on Configured canvas */
+      streamDecoButtons::createConfiguration(streamDecoCanvas::configurations, settings);
+
+      /* configure slider bright */
+      streamDecoBrightSlider::init(streamDecoCanvas::configurations, settings);
+
+      /* --- MONITOR --- */
+
+      streamDecoMonitor::init(streamDecoCanvas::monitor, settings.color_buttons);
+
+      rotate(settings.rotation);
+    } // end init
+
+    /**
+     * @brief  Rotate the screen and place every object for the new rotation
+     * @param  rotation  New screen rotation
+     */
+    void rotate(lvgl::screen::rotation_t rotation)
+    {
+      lvgl::screen::set_rotation(rotation);
+      if (rotation == lvgl::screen::LANDSCAPE)
+      {
+        streamDecoCanvas::landscape();
+        streamDecoBrightSlider::landscape();
+        streamDecoButtons::landscape();
+      }
+      else
+      {
+        streamDecoCanvas::portrait();
+        streamDecoBrightSlider::portrait();
+        streamDecoButtons::portrait();
+      }
+    } // end rotate
+
+  } // namespace streamDecoScreen
+
+} // namespace streamDeco
@@ -106,21 +106,16 @@ namespace streamDeco
 
     } // namespace settings
 
-    /* Handle the update cache streamDecoTasks,
+    /* Handle save_message, posted on event or every 10 minutes,
      * update and save the settings cache with flash */
-    void handleUpdateCache(taskArg_t task_arg)
+    void handleUpdateCache(const executor::message_t &message)
     {
 
-        while (1)
+        settings::saveCache();
+        shortcuts::save();
+        if (message.value == update_settings_cache_with_reset_event)
         {
-
-            /* wait for event or for timeout */
-            uint32_t event = streamDecoTasks::updateCache.takeNotify(10min);
-            settings::saveCache();
-            if (event == update_settings_cache_with_reset_event)
-            {
-                esp::system::reset();
-            }
+            esp::system::reset();
         }
     }
 
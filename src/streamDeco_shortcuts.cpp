@@ -21,22 +21,426 @@
  */
 
 #include "streamDeco_objects.hpp"
+#include "streamDeco_chord.hpp"
+#include "streamDeco_macro.hpp"
+
+#include "esp_log.h"
+
+#include <array>
+#include <atomic>
+#include <string.h>
 
 namespace streamDeco
 {
 
+    extern const char *log_tag;
+
+    namespace
+    {
+        static_assert(sizeof(KeyReport) == sizeof(chord::report_t), "KeyReport layout changed");
+
+        /**
+         * @brief    Built in keyboard and media shortcuts indexed by event
+         * @details  Reports are composed at compile time, events without
+         *           shortcut keep no_action
+         */
+        constexpr std::array<chord::shortcut_t, event_count> make_shortcuts()
+        {
+            std::array<chord::shortcut_t, event_count> table = {};
+
+            /* --- MAIN CANVAS --- */
+            /* Open a terminal */
+            table[terminal_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, KEY_RETURN);
+            /* Open file manager */
+            table[files_event] = chord::keys(KEY_LEFT_GUI, 'e');
+            /* Open web browser */
+            table[web_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 'w');
+            /* Open search feature */
+            table[search_event] = chord::keys(KEY_LEFT_ALT, ' ');
+            /* Backward media on player */
+            table[multimedia_prev_event] = chord::media(KEY_MEDIA_PREVIOUS_TRACK);
+            /* Play or pause media on player */
+            table[multimedia_play_event] = chord::media(KEY_MEDIA_PLAY_PAUSE);
+            /* Forward media on player */
+            table[multimedia_next_event] = chord::media(KEY_MEDIA_NEXT_TRACK);
+            /* Mute and unmute the microphone */
+            table[multimedia_mic_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, KEY_F2);
+            /* Go to left workspace if it exists */
+            table[left_workspace_event] = chord::keys(KEY_LEFT_GUI, KEY_LEFT_ARROW);
+            /* Go to right workspace if it exists */
+            table[right_workspace_event] = chord::keys(KEY_LEFT_GUI, KEY_RIGHT_ARROW);
+            /* Pin the active window on canvas */
+            table[pin_window_event] = chord::keys(KEY_LEFT_ALT, KEY_LEFT_CTRL, 't');
+            /* Lock the computer */
+            table[lock_computer_event] = chord::keys(KEY_LEFT_GUI, 'l');
+            /* Change desktop mode between multi windows and single window (macos stage manager) */
+            table[ruler_event] = chord::keys(KEY_LEFT_GUI, KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 'm');
+
+            /* --- APPLICATIONS CANVAS --- */
+            /* GOG.com Icon to launch GOG Galaxy desktop application */
+            table[applications_canvas_app1_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, '9');
+            /* Discord Icon to launch Discord desktop application */
+            table[applications_canvas_app2_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, '0');
+            /* FPS Icon to show metrics */
+            table[applications_canvas_app3_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 'o');
+            /* VSCode Icon to launch VSCode desktop application */
+            table[applications_canvas_app4_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 'c');
+            /* Tex Icon to launch LaTeX IDE desktop application */
+            table[applications_canvas_app5_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 't');
+            /* Calculator Icon to launch calculator desktop application */
+            table[applications_canvas_app6_event] = chord::media(KEY_MEDIA_CALCULATOR);
+            /* In VScode build PlatformIO project */
+            table[applications_canvas_app7_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 'b');
+            /* In VScode upload PlatformIO project to microcontroler or SoC */
+            table[applications_canvas_app8_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 'u');
+            /* In VScode open serial monitor on PlatformIO */
+            table[applications_canvas_app9_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 's');
+
+            /* --- MULTIMEDIA CANVAS --- */
+            /* Start or pause a record screen */
+            table[multimedia_canvas_mult1_event] = chord::keys(KEY_LEFT_GUI, KEY_LEFT_ALT, 'r');
+            /* Mute mic on record */
+            table[multimedia_canvas_mult2_event] = chord::keys(KEY_LEFT_GUI, KEY_LEFT_ALT, 'm');
+            /* Enable or disable webcam */
+            table[multimedia_canvas_mult3_event] = chord::keys(KEY_LEFT_GUI, KEY_LEFT_ALT, KEY_PRTSC);
+            /* Add clip */
+            table[multimedia_canvas_mult4_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 'r');
+            /* Ripple track */
+            table[multimedia_canvas_mult5_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 't');
+            /* Roll track */
+            table[multimedia_canvas_mult6_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 'y');
+            /* Backward track */
+            table[multimedia_canvas_mult7_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 't');
+            /* Play/Pause track */
+            table[multimedia_canvas_mult8_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, '1');
+            /* Forward track */
+            table[multimedia_canvas_mult9_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, 'p');
+
+            /* --- CONFIGURATIONS CANVAS --- */
+            /* Mute sound volume */
+            table[configuration_canvas_volmut_event] = chord::media(KEY_MEDIA_MUTE);
+            /* Lower the sound volume */
+            table[configuration_canvas_voldown_event] = chord::media(KEY_MEDIA_VOLUME_DOWN);
+            /* Rise sound volume */
+            table[configuration_canvas_volup_event] = chord::media(KEY_MEDIA_VOLUME_UP);
+            /* Launch system monitor */
+            table[configuration_canvas_sysmonitor_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_SHIFT, KEY_ESC);
+            /* Launch system configuration panel */
+            table[configuration_canvas_sysconfig_event] = chord::keys(KEY_LEFT_GUI, 'i');
+            /* Shutdown the computer */
+            table[configuration_canvas_shutdown_event] = chord::keys(KEY_LEFT_CTRL, KEY_LEFT_ALT, 'k');
+
+            return table;
+        }
+
+        constexpr std::array<chord::shortcut_t, event_count> shortcuts = make_shortcuts();
+
+        static_assert(shortcuts[nothing_event].action == chord::no_action);
+        static_assert(shortcuts[terminal_event].report.modifiers == 0x05 && shortcuts[terminal_event].report.keys[0] == 0x28);
+        static_assert(shortcuts[search_event].report.modifiers == 0x04 && shortcuts[search_event].report.keys[0] == 0x2c);
+        static_assert(shortcuts[ruler_event].report.modifiers == 0x0b && shortcuts[ruler_event].report.keys[0] == 0x10);
+        static_assert(shortcuts[applications_canvas_app1_event].report.keys[0] == 0x26 && shortcuts[applications_canvas_app1_event].report.keys[1] == 0);
+        static_assert(shortcuts[multimedia_canvas_mult3_event].report.modifiers == 0x0c && shortcuts[multimedia_canvas_mult3_event].report.keys[0] == 0x46);
+        static_assert(shortcuts[applications_canvas_app6_event].action == chord::media_action && shortcuts[applications_canvas_app6_event].media[1] == 2);
+
+        /**
+         * @brief  Built in table, used while flash has no valid table
+         */
+        size_t build_default_table(uint8_t *image, size_t size)
+        {
+            keymap::Builder builder(image, size, event_count);
+
+            for (uint8_t event = 0; event < event_count; event++)
+            {
+                const chord::shortcut_t &shortcut = shortcuts[event];
+                if (shortcut.action == chord::no_action)
+                    continue;
+                builder.event(event);
+                if (shortcut.action == chord::key_action)
+                    builder.chord(shortcut.report);
+                else
+                    builder.media(shortcut.media);
+            }
+            return builder.finish();
+        }
+
+        keymap::Table table(event_count);
+        rtos::MutexStatic table_mutex;
+        keymap::image_t image; /* flash file buffer, too big for task stacks */
+        uint32_t saved_generation = 0;
+        bool receiving = false; /* upload begun and not failed yet, logs one failure per upload */
+
+        uint16_t get_u16(const uint8_t *data)
+        {
+            return data[0] | (static_cast<uint16_t>(data[1]) << 8);
+        }
+
+        /**
+         * @brief  Receive shortcut table from StreamDecoMonitor
+         * @note   Run by the ingest handler, flash is written later on save_message
+         */
+        void receive(const frame::slot_t &slot)
+        {
+            const frame::payload_t &payload = slot.payload;
+            if (payload.size == 0)
+                return;
+
+            table_mutex.take();
+            switch (payload.data[0])
+            {
+            case frame::begin_command:
+                receiving = payload.size >= 3 && table.begin(get_u16(&payload.data[1]));
+                if (!receiving)
+                    ESP_LOGW(log_tag, "Shortcut table upload refused, size %u\n",
+                             payload.size >= 3 ? get_u16(&payload.data[1]) : 0);
+                break;
+
+            case frame::data_command:
+                if (payload.size >= 3 && table.write(get_u16(&payload.data[1]), &payload.data[3], payload.size - 3))
+                    break;
+                if (receiving)
+                    ESP_LOGW(log_tag, "Shortcut table chunk refused at %u, upload aborted\n",
+                             payload.size >= 3 ? get_u16(&payload.data[1]) : 0);
+                receiving = false;
+                break;
+
+            case frame::commit_command:
+                receiving = false;
+                if (table.commit())
+                {
+                    table.stamp(saved_generation + 1);
+                    events::post(executor::save_message, update_shortcuts_event);
+                }
+                else
+                    ESP_LOGW(log_tag, "Shortcut table upload invalid, generation %lu kept\n",
+                             static_cast<unsigned long>(table.generation()));
+                break;
+            }
+            table_mutex.give();
+        }
+
+        /**
+         * @brief  Macro player read by bleKeyboard sender task
+         * @note   Text is typed at link pace, the button task does not wait
+         */
+        class MacroSource : public BleReportSource
+        {
+        public:
+            bool next(BleSourceReport &report) override
+            {
+                macro::report_t next;
+                if (!player.next(next))
+                    return false;
+                report.media = next.media;
+                memcpy(report.data, next.data, sizeof(report.data));
+                report.delay_ms = next.delay_ms;
+                return true;
+            }
+
+            macro::Player player;
+        };
+
+        MacroSource macro_source;
+
+        /* macro event waiting for the previous macro to end, replayed by shortcuts::resume */
+        uint32_t deferred_event = nothing_event;
+        uint32_t deferred_tap = 0;
+
+        /* volume buttons send an event on each PRESSING while held */
+        constexpr int64_t volume_repeat_us = 200000;
+        int64_t volume_step_us = 0;
+
+        /* computer state waiting for the worker, mask << 8 | state */
+        std::atomic<uint16_t> feedback_pending{0};
+
+        /**
+         * @brief  Merge the state written by the computer and post feedback_message
+         * @note   Run on bluetooth host task
+         */
+        void receive_feedback(uint8_t state, uint8_t mask)
+        {
+            uint16_t pending = feedback_pending.load();
+            uint16_t merged;
+            do
+            {
+                uint8_t pending_mask = (pending >> 8) | mask;
+                uint8_t pending_state = (pending & ~mask & 0xFF) | (state & mask);
+                merged = (pending_mask << 8) | pending_state;
+            } while (!feedback_pending.compare_exchange_weak(pending, merged));
+
+            events::post(executor::feedback_message);
+        }
+
+        /* canvas event of the page in use, cached for each host */
+        uint32_t last_page = nothing_event;
+        uint32_t host_page[BLE_KEYBOARD_MAX_HOSTS] = {};
+
+        /**
+         * @brief  Send next shortcuts to the next connected host
+         * @note   The host links stay open, only the page used on the new host
+         *         is restored on screen
+         */
+        void switch_host()
+        {
+            uint8_t previous = bleKeyboard.getActiveHost();
+            if (!bleKeyboard.nextHost())
+                return;
+
+            host_page[previous] = last_page;
+            last_page = host_page[bleKeyboard.getActiveHost()];
+            if (streamDecoButtons::configurations_canvas.pinned())
+                return;
+
+            lvgl::port::mutex_take();
+            streamDecoCanvas::configurations.hidden();
+            if (last_page == applications_canvas_event)
+                streamDecoCanvas::applications.unhidden();
+            else if (last_page == multimedia_canvas_event)
+                streamDecoCanvas::multimedia.unhidden();
+            lvgl::port::mutex_give();
+        }
+    }
+
+    namespace shortcuts
+    {
+
+        void init()
+        {
+            uint32_t newest = 0;
+            bool found = false;
+
+            for (marcelino::File<keymap::image_t> &file : flash)
+            {
+                image = file.read();
+                if (!keymap::validate(image.data, sizeof(image.data), event_count))
+                    continue;
+                if (found && keymap::generation(image.data) <= newest)
+                    continue;
+                if (table.load(image.data, sizeof(image.data)))
+                {
+                    newest = keymap::generation(image.data);
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                size_t size = build_default_table(image.data, sizeof(image.data));
+                table.load(image.data, size);
+            }
+
+            saved_generation = table.generation();
+            frameRouter::subscribe(frameRouter::shortcuts_topic, receive);
+        }
+
+        void save()
+        {
+            table_mutex.take();
+            uint32_t generation = table.generation();
+            bool changed = table.loaded() && generation != saved_generation;
+            if (changed)
+                memcpy(image.data, table.image(), table.size());
+            table_mutex.give();
+
+            if (!changed)
+                return;
+
+            flash[generation % 2] = image;
+            saved_generation = generation;
+        }
+
+        uint32_t characters()
+        {
+            return macro_source.player.characters();
+        }
+
+        void resume()
+        {
+            if (deferred_event == nothing_event || !bleKeyboard.waitSent(0))
+                return;
+
+            events::post(executor::button_message, deferred_event, deferred_tap);
+            deferred_event = nothing_event;
+        }
+
+    } // namespace shortcuts
+
+    namespace feedback
+    {
+
+        void init()
+        {
+            bleKeyboard.onFeedback(receive_feedback);
+        }
+
+        void process()
+        {
+            uint16_t pending = feedback_pending.exchange(0);
+            uint8_t mask = pending >> 8;
+            uint8_t state = pending & 0xFF;
+            if (mask == 0)
+                return;
+
+            lvgl::port::mutex_take();
+            if (mask & mic_muted)
+                streamDecoButtons::multimedia_mic.setToggled(state & mic_muted);
+            if (mask & media_playing)
+                streamDecoButtons::multimedia_play.setToggled(state & media_playing);
+            if (mask & window_pinned)
+                streamDecoButtons::pin.setToggled(state & window_pinned);
+            lvgl::port::mutex_give();
+        }
+
+    } // namespace feedback
+
     /**
      * @brief  Process event generated by buttons and send keyboard shortcuts to PC
      * @param  button_event  Each button send a different event
+     * @param  tap           Trace id of the touch, posted again with a deferred event
      * @param  settings      Reference to settings variables
      * @note   This function is called by button handler on file streamDeco_HandlerButtons.cpp
      */
-    void process_event(uint32_t button_event)
+    void process_event(uint32_t button_event, uint32_t tap)
     {
         lvgl::screen::rotation_t rotation;
 
+        /* one volume step each volume_repeat_us while the button is held */
+        if (button_event == configuration_canvas_voldown_event || button_event == configuration_canvas_volup_event)
+        {
+            const int64_t now = rtos::time<microseconds>().count();
+            if (now - volume_step_us < volume_repeat_us)
+                return;
+            volume_step_us = now;
+        }
+
+        if (button_event < event_count)
+        {
+            uint8_t steps[keymap::max_sequence_size];
+            table_mutex.take();
+            size_t size = table.sequence(button_event, steps, sizeof(steps));
+            table_mutex.give();
+
+            /* the player is owned by bleKeyboard until the previous macro ends,
+             * the worker does not wait, one event is kept until sent_message */
+            if (size && !bleKeyboard.waitSent(0))
+            {
+                if (deferred_event == nothing_event)
+                {
+                    deferred_event = button_event;
+                    deferred_tap = tap;
+                }
+                return;
+            }
+
+            if (size)
+            {
+                macro_source.player.load(steps, size);
+                bleKeyboard.play(&macro_source);
+            }
+        }
+
         /** @brief  Each code does different things in this switch case
-         *          the keyboard code sent by bleKeyboard is configured here
+         *          the keyboard code sent by bleKeyboard is configured on shortcuts table
          **/
         switch (button_event)
         {
@@ -56,54 +460,6 @@ namespace streamDeco
 
             /* First row buttons */
 
-            /**
-             * @brief    Terminal button is pressed
-             * @details  Open a terminal
-             * @note     Need configuration on application or system
-             **/
-        case terminal_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press(KEY_RETURN);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Files button is pressed
-         *  @details  Open file manager
-         *  @note     This media shortcut may work by default on Windows and Linux
-         **/
-        case files_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press('e');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Web button is pressed
-         *  @details  Open web browser
-         *  @note     This media shortcut may work by default on Windows
-         *            On Linux need configuration on system
-         **/
-        case web_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('w');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Search button is pressed
-         *  @details  Open search feature
-         *  @note     This media shortcut may work by default on Windows 11 and Linux KDE Plasma
-         **/
-        case search_event:
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press(' ');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /** @brief    Applications button receive a short click
          *  @details  This event will:
          *              Unpin the Applications canvas
@@ -124,6 +480,7 @@ namespace streamDeco
             streamDecoCanvas::configurations.hidden();
             streamDecoCanvas::monitor.hidden();
             streamDecoCanvas::applications.change_hidden();
+            last_page = streamDecoCanvas::applications.is_hidden() ? nothing_event : applications_canvas_event;
             lvgl::port::mutex_give();
             break;
 
@@ -150,24 +507,15 @@ namespace streamDeco
 
         /* Second row buttons */
 
-        /** @brief    Multimedia_prev button is pressed
-         *  @details  Backward media on pcanvas
-         *  @note     This media shortcut may work by default on Windows and Linux
-         **/
-        case multimedia_prev_event:
-            bleKeyboard.write(KEY_MEDIA_PREVIOUS_TRACK);
-            break;
-
         /** @brief    Multimedia_play button is pressed
          *  @details  Play or pause media on player
          *  @note     This media shortcut may work by default on Windows and Linux
          *            This button have two icons, play_simp and pause_simp
          *            SwapIcon method change between this two icons
          *            Also the button is highlighted when pressed,
-         *            but has no feedback from computer music player to identify if media is playing or paused
+         *            the player state sent by the computer on feedback report replaces the guess
          */
         case multimedia_play_event:
-            bleKeyboard.write(KEY_MEDIA_PLAY_PAUSE);
             lvgl::port::mutex_take();
             streamDecoButtons::multimedia_play.iconSwap();
             if (streamDecoButtons::multimedia_play.pinned())
@@ -177,28 +525,15 @@ namespace streamDeco
             lvgl::port::mutex_give();
             break;
 
-        /** @brief    Multimedia_next button is pressed
-         *  @details  Forward media on player
-         *  @note     This media shortcut may work by default on Windows and Linux
-         **/
-        case multimedia_next_event:
-            bleKeyboard.write(KEY_MEDIA_NEXT_TRACK);
-            break;
-
         /** @brief    Multimedia_mic button is pressed
          *  @details  Mute and unmute the microphone
          *  @note     This media shortcut need be configured in application or system
          *            This button have two icons, mic_on_simp and mic_off_simp
          *            SwapIcon method change between this two icons
          *            Also the button is highlighted when pressed,
-         *            but has no feedback from computer to identify the microphone state
+         *            the microphone state sent by the computer on feedback report replaces the guess
          */
         case multimedia_mic_event: /*  */
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press(KEY_F2);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
             lvgl::port::mutex_take();
             streamDecoButtons::multimedia_mic.iconSwap();
             if (streamDecoButtons::multimedia_mic.pinned())
@@ -228,6 +563,7 @@ namespace streamDeco
             streamDecoCanvas::configurations.hidden();
             streamDecoCanvas::monitor.hidden();
             streamDecoCanvas::multimedia.change_hidden();
+            last_page = streamDecoCanvas::multimedia.is_hidden() ? nothing_event : multimedia_canvas_event;
             lvgl::port::mutex_give();
             break;
 
@@ -254,76 +590,19 @@ namespace streamDeco
 
         /* Third row buttons */
 
-        /** @brief    Prev_workspace button is pressed
-         *  @details  Go to left workspace if it exists
-         *  @note     This shortcut may work by default on Windows 11
-         *            On Linux need configuration on system
-         **/
-        case left_workspace_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_LEFT_ARROW);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Next_workspace button is pressed
-         *  @details  Go to right workspace if it exists
-         *  @note     This shortcut may work by default on Windows 11
-         *            On Linux need configuration on system
-         **/
-        case right_workspace_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_RIGHT_ARROW);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /** @brief    Pin_window button is pressed
          *  @details  Pin the active window on canvas
          *  @note     Need configuration on application or system
          *            The button is highlighted when pressed,
-         *            but has no feedback from computer to identify a pinned window
+         *            the window state sent by the computer on feedback report replaces the guess
          **/
         case pin_window_event:
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press('t');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
             lvgl::port::mutex_take();
             streamDecoButtons::pin.iconSwap();
             streamDecoButtons::pin.pinned() ? streamDecoButtons::pin.unpin() : streamDecoButtons::pin.pin();
             lvgl::port::mutex_give();
             break;
 
-        /** @brief    Lock_computer button is pressed
-         *  @details  Lock the computer
-         *  @note     This shortcut may work by default on Windows and Linux
-         **/
-        case lock_computer_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press('l');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    desktop_mode button is pressed
-         *  @details  Change desktop mode between multi windows and single window (macos stage manager)
-         *  @note     This media shortcut need be configured in application or system
-         *            This button have two icons, mult_window_simp and single_window_simp
-         *            SwapIcon method change between this two icons
-         *            Also this button is highlighted when pressed,
-         *            but has no feedback from computer to identify the desktop state
-         */
-        case ruler_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('m');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /** @brief    Configurations button receive a short click
          *  @details  This event will:
          *              Hide Applications and Multimedia canvas
@@ -375,112 +654,6 @@ namespace streamDeco
             lvgl::port::mutex_give();
             break;
 
-            /* --- APPLICATIONS CANVAS --- */
-
-        /** @brief    App1 button is pressed
-         *  @details  GOG.com Icon to launch GOG Galaxy desktop application
-         *  @note     Need configuration on application or system
-         **/
-        case applications_canvas_app1_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('9');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App2 button is pressed
-         *  @details  Discord Icon to launch Discord desktop application
-         *  @note     Need configuration on application or system
-         **/
-        case applications_canvas_app2_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('0');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App3 button is pressed
-         *  @details  FPS Icon to show metrics
-         *  @note     Need configuration on application or system
-         **/
-        case applications_canvas_app3_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('o');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App4 button is pressed
-         *  @details  VSCode Icon to launch VSCode desktop application
-         *  @note     Need configuration on application or system
-         **/
-        case applications_canvas_app4_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('c');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App5 button is pressed
-         *  @details  Tex Icon to launch LaTeX IDE desktop application
-         *  @note     Need configuration on application or system
-         **/
-        case applications_canvas_app5_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('t');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App6 button is pressed
-         *  @details  Calculator Icon to launch calculator desktop application
-         *  @note     This shortcut may work by default on Windows and Linux
-         **/
-        case applications_canvas_app6_event:
-            bleKeyboard.write(KEY_MEDIA_CALCULATOR);
-            break;
-
-        /** @brief    App7 button is pressed
-         *  @details  In VScode build PlatformIO project
-         *  @note     This shortcut may work by default on VSCode PlatformIO extension
-         **/
-        case applications_canvas_app7_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('b');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App8 button is pressed
-         *  @details  In VScode upload PlatformIO project to microcontroler or SoC
-         *  @note     This shortcut may work by default on VSCode PlatformIO extension
-         **/
-        case applications_canvas_app8_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('u');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    App9 button is pressed
-         *  @details  In VScode open serial monitor on PlatformIO
-         *  @note     This shortcut may work by default on VSCode PlatformIO extension
-         **/
-        case applications_canvas_app9_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('s');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /* --- MULTIMEDIA CANVAS --- */
 
         /** @brief    Mult1 button is pressed
@@ -488,11 +661,6 @@ namespace streamDeco
          *  @note     Need configuration on application or system
          **/
         case multimedia_canvas_mult1_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('r');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
             lvgl::port::mutex_take();
             streamDecoButtons::mult1.iconSwap();
             streamDecoButtons::mult1.pinned() ? streamDecoButtons::mult1.unpin() : streamDecoButtons::mult1.pin();
@@ -504,118 +672,19 @@ namespace streamDeco
          *  @note     Need configuration on application or system
          **/
         case multimedia_canvas_mult2_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('m');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
             lvgl::port::mutex_take();
             streamDecoButtons::mult2.iconSwap();
             streamDecoButtons::mult2.pinned() ? streamDecoButtons::mult2.unpin() : streamDecoButtons::mult2.pin();
             lvgl::port::mutex_give();
             break;
 
-        /** @brief    Mult3 button is pressed
-         *  @details  Enable or disable webcam
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult3_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press(KEY_PRTSC);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult4 button is pressed
-         *  @details  Add clip
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult4_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('r');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult5 button is pressed
-         *  @details  Ripple track
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult5_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('t');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult6 button is pressed
-         *  @details  Roll track
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult6_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('y');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult7 button is pressed
-         *  @details  Backward track
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult7_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('t');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult8 button is pressed
-         *  @details  Play/Pause track
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult8_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('1');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Mult9 button is pressed
-         *  @details  Forward track
-         *  @note     Need configuration on application or system
-         **/
-        case multimedia_canvas_mult9_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press('p');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /* --- CONFIGURATIONS CANVAS --- */
 
-        /** @brief    Volmut button is pressed
-         *  @details  Mute sound volume
-         *  @note     This media shortcut may work by default on Windows and Linux
-         **/
-        case configuration_canvas_volmut_event:
-            bleKeyboard.write(KEY_MEDIA_MUTE);
-            break;
-
         /** @brief    Voldown button is pressed
          *  @details  Lower the sound volume
          *  @note     This media shortcut may work by default on Windows and Linux
          **/
         case configuration_canvas_voldown_event:
-            bleKeyboard.write(KEY_MEDIA_VOLUME_DOWN);
-            streamDecoTasks::buttons.takeNotify();
             break;
 
         /** @brief    Volup button is pressed
@@ -623,8 +692,6 @@ namespace streamDeco
          *  @note     This media shortcut may work by default on Windows and Linux
          **/
         case configuration_canvas_volup_event:
-            bleKeyboard.write(KEY_MEDIA_VOLUME_UP);
-            streamDecoTasks::buttons.takeNotify();
             break;
 
         /** @brief    Colorbackground button is pressed
@@ -659,50 +726,12 @@ namespace streamDeco
         case configuration_canvas_rotate_screen_event:
             lvgl::port::mutex_take();
             rotation = lvgl::screen::get_rotation();
-            if (rotation == lvgl::screen::LANDSCAPE)
-            {
-                settings::cache.rotation = lvgl::screen::PORTRAIT;
-                lvgl::screen::set_rotation(lvgl::screen::PORTRAIT);
-                streamDecoCanvas::portrait();
-                streamDecoBrightSlider::portrait();
-                streamDecoButtons::portrait();
-            }
-            else
-            {
-                settings::cache.rotation = lvgl::screen::LANDSCAPE;
-                lvgl::screen::set_rotation(lvgl::screen::LANDSCAPE);
-                streamDecoCanvas::landscape();
-                streamDecoBrightSlider::landscape();
-                streamDecoButtons::landscape();
-            }
+            settings::cache.rotation = rotation == lvgl::screen::LANDSCAPE ? lvgl::screen::PORTRAIT
+                                                                           : lvgl::screen::LANDSCAPE;
+            streamDecoScreen::rotate(settings::cache.rotation);
             lvgl::port::mutex_give();
             break;
 
-        /** @brief    Sysmon button is pressed
-         *  @details  Launch system monitor
-         *  @note     This shortcut may work by default on Windows 10 or 11
-         *            On Linux need configuration on system
-         **/
-        case configuration_canvas_sysmonitor_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_SHIFT);
-            bleKeyboard.press(KEY_ESC);
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
-        /** @brief    Sysconf button is pressed
-         *  @details  Launch system configuration panel
-         *  @note     This shortcut may work by default on Windows 10 or 11
-         *            On Linux need configuration on system
-         **/
-        case configuration_canvas_sysconfig_event:
-            bleKeyboard.press(KEY_LEFT_GUI);
-            bleKeyboard.press('i');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
-            break;
-
         /** @brief    Logout button is pressed
          *  @details  Logout of the computer
          *  @note     Need configuration on system or application
@@ -715,19 +744,15 @@ namespace streamDeco
          *  @note     Need configuration on system or application
          **/
         case configuration_canvas_reboot_event:
-            streamDecoTasks::updateCache.sendNotify(update_settings_cache_with_reset_event);
+            events::post(executor::save_message, update_settings_cache_with_reset_event);
             break;
 
-        /** @brief    Shuntdown button is pressed
-         *  @details  Shuntdown the computer
-         *  @note     Need configuration on system or application
+        /** @brief    System config button is long pressed
+         *  @details  Send next shortcuts to the next connected computer
+         *  @note     Pair each computer once, StreamDeco keeps all links open
          **/
-        case configuration_canvas_shutdown_event:
-            bleKeyboard.press(KEY_LEFT_CTRL);
-            bleKeyboard.press(KEY_LEFT_ALT);
-            bleKeyboard.press('k');
-            rtos::sleep(10ms);
-            bleKeyboard.releaseAll();
+        case configuration_canvas_switch_host_event:
+            switch_host();
             break;
 
         /** @brief    Backlight bright control slider change value
@@ -0,0 +1,152 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file    streamDeco_telemetry.cpp
+ * @brief   Memory telemetry of internal RAM, PSRAM and LVGL pool
+ * @details Pools are read with heap_caps and lv_mem_monitor, the history
+ *          and the fragmentation events are kept by memory::Telemetry
+ */
+
+#include "streamDeco_objects.hpp"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+namespace streamDeco
+{
+
+  extern const char *log_tag;
+
+  namespace
+  {
+    /**
+     * @class    TargetProbe
+     * @brief    memory::Probe of the board
+     */
+    class TargetProbe : public memory::Probe
+    {
+    public:
+      bool read(memory::pool_e pool, memory::usage_t &usage) override
+      {
+        switch (pool)
+        {
+        case memory::internal_pool:
+          return read_caps(MALLOC_CAP_INTERNAL, usage);
+        case memory::psram_pool:
+          return read_caps(MALLOC_CAP_SPIRAM, usage);
+        case memory::lvgl_pool:
+          return read_lvgl(usage);
+        default:
+          return false;
+        }
+      }
+
+    private:
+      static bool read_caps(uint32_t caps, memory::usage_t &usage)
+      {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, caps);
+        usage.total = info.total_free_bytes + info.total_allocated_bytes;
+        usage.free = info.total_free_bytes;
+        usage.largest = info.largest_free_block;
+        usage.min_free = info.minimum_free_bytes;
+        return usage.total > 0;
+      }
+
+      static bool read_lvgl(memory::usage_t &usage)
+      {
+#if LV_MEM_CUSTOM == 0
+        lv_mem_monitor_t monitor;
+        lvgl::port::mutex_take();
+        lv_mem_monitor(&monitor);
+        lvgl::port::mutex_give();
+        usage.total = monitor.total_size;
+        usage.free = monitor.free_size;
+        usage.largest = monitor.free_biggest_size;
+        usage.min_free = monitor.total_size - monitor.max_used;
+        return true;
+#else
+        return false; /* LVGL allocates from heap_caps */
+#endif
+      }
+    }; // class TargetProbe
+
+    TargetProbe probe;
+
+    void fragmentation_event(memory::pool_e pool, const memory::usage_t &usage, uint8_t fragmentation)
+    {
+      streamDeco::mutex_serial.take();
+      ESP_LOGW(log_tag, "Memory %s fragmentation %u %%, free %lu, largest block %lu\n", memory::name(pool),
+               fragmentation, static_cast<unsigned long>(usage.free), static_cast<unsigned long>(usage.largest));
+      streamDeco::mutex_serial.give();
+    }
+  }
+
+  namespace telemetry
+  {
+
+    void init()
+    {
+      memory.set_listener(fragmentation_event);
+      timers_idle::memory_sample = events::schedule(executor::memory_message, 0, timers_idle::memory_sample_period,
+                                                    timers_idle::memory_sample_period);
+    }
+
+    void sample()
+    {
+      memory.sample(probe, rtos::time<microseconds>().count());
+    }
+
+    void print()
+    {
+      static memory::sample_t samples[memory::history_size];
+      size_t count = memory.history(samples, memory::history_size);
+      if (count == 0)
+        return;
+
+      streamDeco::mutex_serial.take();
+      const memory::sample_t &last = samples[count - 1];
+      for (uint8_t pool = 0; pool < memory::pool_count; pool++)
+      {
+        const memory::usage_t &usage = last.pools[pool];
+        if (usage.total == 0)
+          continue;
+        ESP_LOGI(log_tag, "Memory %-8s total %lu, free %lu, largest %lu, min free %lu, fragmentation %u %%, growth %lld\n",
+                 memory::name(static_cast<memory::pool_e>(pool)), static_cast<unsigned long>(usage.total),
+                 static_cast<unsigned long>(usage.free), static_cast<unsigned long>(usage.largest),
+                 static_cast<unsigned long>(usage.min_free), memory::fragmentation(usage),
+                 memory.growth(static_cast<memory::pool_e>(pool)));
+      }
+
+      /* fragmentation of each pool on the history, oldest first */
+      for (size_t i = 0; i < count; i++)
+        ESP_LOGI(log_tag, "Memory at %lld s, fragmentation internal %u %%, psram %u %%, lvgl %u %%\n",
+                 samples[i].us / 1000000, memory::fragmentation(samples[i].pools[memory::internal_pool]),
+                 memory::fragmentation(samples[i].pools[memory::psram_pool]),
+                 memory::fragmentation(samples[i].pools[memory::lvgl_pool]));
+      ESP_LOGI(log_tag, "Memory threshold %u %%, events %lu\n", memory.threshold(),
+               static_cast<unsigned long>(memory.events()));
+      streamDeco::mutex_serial.give();
+    }
+
+  } // namespace telemetry
+
+} // namespace streamDeco
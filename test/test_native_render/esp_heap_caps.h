@@ -0,0 +1,27 @@
+/* heap_caps stand-in for the native render benchmark, used by lvgl_label.hpp */
+
+#ifndef _ESP_HEAP_CAPS_H_
+#define _ESP_HEAP_CAPS_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+/* allocations made through heap_caps_malloc, read by the label benchmark */
+inline uint32_t heap_caps_malloc_calls = 0;
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    heap_caps_malloc_calls++;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+#endif
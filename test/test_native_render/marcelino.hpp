@@ -0,0 +1,11 @@
+/* marcelino stand-in for the native render benchmark, the widgets of
+ * lib/streamDeco only need lvgl::port from the target */
+
+#ifndef _MARCELINO_HPP_
+#define _MARCELINO_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#endif
@@ -0,0 +1,335 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "render_target.hpp"
+#include "streamDeco_screens.hpp"
+#include "src/draw/sw/lv_draw_sw.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+namespace
+{
+    /* lvgl::port stand-in state, one thread so the mutex is only counted */
+    uint32_t lock_depth = 0;
+    lvgl::port::lock_stats_t lock_stats = {};
+
+    lv_disp_drv_t display_driver;
+    lv_disp_draw_buf_t draw_buffer;
+    lv_color_t stripe1[streamDeco::render::display_width * streamDeco::render::stripe_lines];
+    lv_color_t stripe2[streamDeco::render::display_width * streamDeco::render::stripe_lines];
+    lv_color_t partial1[streamDeco::render::display_width * streamDeco::render::display_height];
+    lv_color_t partial2[streamDeco::render::display_width * streamDeco::render::display_height];
+    lv_color_t framebuffer[streamDeco::render::display_width * streamDeco::render::display_height];
+
+    streamDeco::render::stats_t stats = {};
+    uint32_t primitive_depth = 0;
+
+    /* LVGL tick, only run_task moves it so the frames stay reproducible */
+    uint32_t tick_ms = 0;
+
+    /* software renderer callbacks, called by the wrappers */
+    void (*sw_draw_rect)(lv_draw_ctx_t *, const lv_draw_rect_dsc_t *, const lv_area_t *);
+    void (*sw_draw_arc)(lv_draw_ctx_t *, const lv_draw_arc_dsc_t *, const lv_point_t *, uint16_t, uint16_t, uint16_t);
+    void (*sw_draw_letter)(lv_draw_ctx_t *, const lv_draw_label_dsc_t *, const lv_point_t *, uint32_t);
+
+    uint64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @class    Measure
+     * @brief    Time a primitive for the scope, only the outermost one counts
+     */
+    class Measure
+    {
+    public:
+        explicit Measure(streamDeco::render::primitive_e primitive)
+            : _primitive(primitive), _outer(primitive_depth++ == 0), _start_ns(_outer ? now_ns() : 0) {}
+
+        ~Measure()
+        {
+            primitive_depth--;
+            if (_outer == false)
+                return;
+            stats.primitives[_primitive].count++;
+            stats.primitives[_primitive].ns += now_ns() - _start_ns;
+        }
+
+    private:
+        streamDeco::render::primitive_e _primitive;
+        bool _outer;
+        uint64_t _start_ns;
+    }; // class Measure
+
+    void draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+    {
+        const bool shadow = dsc->shadow_width > 0 && dsc->shadow_opa > LV_OPA_MIN;
+        Measure measure(shadow ? streamDeco::render::shadow_primitive : streamDeco::render::rect_primitive);
+        sw_draw_rect(draw_ctx, dsc, coords);
+    }
+
+    void draw_arc(lv_draw_ctx_t *draw_ctx, const lv_draw_arc_dsc_t *dsc, const lv_point_t *center,
+                  uint16_t radius, uint16_t start_angle, uint16_t end_angle)
+    {
+        Measure measure(streamDeco::render::arc_primitive);
+        sw_draw_arc(draw_ctx, dsc, center, radius, start_angle, end_angle);
+    }
+
+    void draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos, uint32_t letter)
+    {
+        Measure measure(streamDeco::render::label_primitive);
+        sw_draw_letter(draw_ctx, dsc, pos, letter);
+    }
+
+    /* decoding and blending of a whole image, the software renderer has no draw_img */
+    lv_res_t draw_img(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords, const void *src)
+    {
+        const bool icon = lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE &&
+                          static_cast<const lv_img_dsc_t *>(src)->header.cf == LV_IMG_CF_ALPHA_1BIT;
+        Measure measure(icon ? streamDeco::render::icon_primitive : streamDeco::render::image_primitive);
+        draw_ctx->draw_img = nullptr;
+        lv_draw_img(draw_ctx, dsc, coords, src);
+        draw_ctx->draw_img = draw_img;
+        return LV_RES_OK;
+    }
+
+    void draw_ctx_init(lv_disp_drv_t *driver, lv_draw_ctx_t *draw_ctx)
+    {
+        lv_draw_sw_init_ctx(driver, draw_ctx);
+        sw_draw_rect = draw_ctx->draw_rect;
+        sw_draw_arc = draw_ctx->draw_arc;
+        sw_draw_letter = draw_ctx->draw_letter;
+        draw_ctx->draw_rect = draw_rect;
+        draw_ctx->draw_arc = draw_arc;
+        draw_ctx->draw_letter = draw_letter;
+        draw_ctx->draw_img = draw_img;
+    }
+
+    /* RGB panel stand-in, areas are already rotated by LVGL */
+    void display_flush(lv_disp_drv_t *driver, const lv_area_t *area, lv_color_t *color)
+    {
+        const uint64_t start_ns = now_ns();
+        const lv_coord_t width = lv_area_get_width(area);
+        for (lv_coord_t y = area->y1; y <= area->y2; y++)
+        {
+            memcpy(&framebuffer[y * streamDeco::render::display_width + area->x1], color, width * sizeof(lv_color_t));
+            color += width;
+        }
+        stats.flushes++;
+        stats.flush_ns += now_ns() - start_ns;
+        lv_disp_flush_ready(driver);
+    }
+
+    /* called by LVGL after a refresh that rendered invalidated areas */
+    void display_monitor(lv_disp_drv_t *driver, uint32_t time, uint32_t px)
+    {
+        (void)driver;
+        (void)time;
+        stats.refreshed_px += px;
+    }
+}
+
+extern "C" unsigned long lvgl_tick_millis()
+{
+    return tick_ms;
+}
+
+namespace lvgl
+{
+
+    namespace port
+    {
+
+        void mutex_take()
+        {
+            if (lock_depth++ == 0)
+                lock_stats.acquisitions++;
+            lock_stats.takes++;
+        }
+
+        void mutex_give()
+        {
+            lock_depth--;
+        }
+
+        lock_stats_t get_lock_stats()
+        {
+            return lock_stats;
+        }
+
+        void wake() {}
+
+        uint32_t backlight_max()
+        {
+            return 4095; /* 12-bit PWM */
+        }
+
+        void backlight_setRaw(int bright)
+        {
+            (void)bright;
+        }
+
+        void set_screen_rotation(lv_disp_rot_t rotation)
+        {
+            lv_disp_set_rotation(lv_disp_get_default(), rotation);
+        }
+
+        lv_disp_rot_t get_screen_rotation()
+        {
+            return lv_disp_get_rotation(lv_disp_get_default());
+        }
+
+    } // namespace port
+
+} // namespace lvgl
+
+namespace streamDeco
+{
+
+    namespace streamDecoButtons
+    {
+
+        /* no worker on the host, touches are not replayed */
+        void buttons_callback(lvgl::event::event_t lvglEvent)
+        {
+            (void)lvglEvent;
+        }
+
+    } // namespace streamDecoButtons
+
+    namespace render
+    {
+
+        void init()
+        {
+            lv_init();
+            lv_disp_draw_buf_init(&draw_buffer, stripe1, stripe2, display_width * stripe_lines);
+            lv_disp_drv_init(&display_driver);
+            display_driver.hor_res = display_width;
+            display_driver.ver_res = display_height;
+            display_driver.flush_cb = display_flush;
+            display_driver.monitor_cb = display_monitor;
+            display_driver.draw_buf = &draw_buffer;
+            display_driver.draw_ctx_init = draw_ctx_init;
+            display_driver.sw_rotate = true;
+            lv_disp_drv_register(&display_driver);
+        } // render::init
+
+        void set_mode(mode_e mode)
+        {
+            if (mode == partial_mode)
+                lv_disp_draw_buf_init(&draw_buffer, partial1, partial2, display_width * display_height);
+            else
+                lv_disp_draw_buf_init(&draw_buffer, stripe1, stripe2, display_width * stripe_lines);
+        } // render::set_mode
+
+        uint64_t redraw()
+        {
+            lv_obj_invalidate(lv_scr_act());
+            const uint64_t start_ns = now_ns();
+            lv_refr_now(lv_disp_get_default());
+            return now_ns() - start_ns;
+        } // render::redraw
+
+        uint32_t refresh()
+        {
+            const uint32_t before = stats.refreshed_px;
+            lv_refr_now(lv_disp_get_default());
+            return stats.refreshed_px - before;
+        } // render::refresh
+
+        lvgl::port::task_stats_t run_task(uint32_t ms)
+        {
+            lvgl::port::task_stats_t task_stats = {};
+            uint64_t busy_ns = 0;
+            const uint32_t end_ms = tick_ms + ms;
+            while (tick_ms < end_ms)
+            {
+                const uint64_t start_ns = now_ns();
+                const uint32_t next_ms = lv_timer_handler();
+                task_stats.wakeups++;
+                busy_ns += now_ns() - start_ns;
+                tick_ms += std::clamp(next_ms, lvgl::port::task_period_min_ms, lvgl::port::task_period_max_ms);
+            }
+            task_stats.busy_us = busy_ns / 1000;
+            task_stats.elapsed_us = static_cast<int64_t>(ms) * 1000;
+            return task_stats;
+        } // render::run_task
+
+        uint32_t framebuffer_crc()
+        {
+            const uint8_t *data = reinterpret_cast<const uint8_t *>(framebuffer);
+            uint32_t crc = 0xFFFFFFFF;
+            for (size_t i = 0; i < sizeof(framebuffer); i++)
+            {
+                crc ^= data[i];
+                for (uint8_t bit = 0; bit < 8; bit++)
+                    crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+            return ~crc;
+        } // render::framebuffer_crc
+
+        stats_t get_stats()
+        {
+            return stats;
+        }
+
+        void reset_stats()
+        {
+            stats = {};
+        }
+
+        const char *name(primitive_e primitive)
+        {
+            switch (primitive)
+            {
+            case rect_primitive:
+                return "rect";
+            case shadow_primitive:
+                return "rect_shadow";
+            case arc_primitive:
+                return "arc";
+            case label_primitive:
+                return "label";
+            case icon_primitive:
+                return "icon_recolor";
+            case image_primitive:
+                return "image";
+            default:
+                return "unknown";
+            }
+        } // render::name
+
+        const char *name(mode_e mode)
+        {
+            return mode == partial_mode ? "partial" : "stripe";
+        } // render::name
+
+    } // namespace render
+
+} // namespace streamDeco
@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _STREAMDECO_RENDER_TARGET_HPP_
+#define _STREAMDECO_RENDER_TARGET_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lvgl.hpp"
+
+namespace streamDeco
+{
+
+    /**
+     * Headless display for the native render benchmark.
+     *
+     * LVGL software renderer draws on the draw buffers of a render mode of
+     * the ESP32-8048S043C board (sw_rotate), stripes of LVGL_STRIPE_LINES 20
+     * or full-size LVGL_BUFFER_PIXELS buffers, the flush copies each area to
+     * a panel framebuffer in memory instead of the RGB panel. The draw context
+     * is wrapped so the time of each primitive is accumulated, nested
+     * primitives are counted on the outermost one.
+     */
+    namespace render
+    {
+
+        constexpr lv_coord_t display_width = 800;
+        constexpr lv_coord_t display_height = 480;
+        constexpr lv_coord_t stripe_lines = 20;
+
+        /**
+         * @enum     mode_e
+         * @brief    Draw buffers of the LVGL_RENDER_MODE of lvgl_port.hpp
+         */
+        enum mode_e : uint8_t
+        {
+            stripe_mode,  /* LVGL_RENDER_MODE_STRIPE, two display_width * stripe_lines buffers */
+            partial_mode, /* LVGL_RENDER_MODE_PARTIAL, two display_width * display_height buffers */
+            mode_count,
+        };
+
+        /**
+         * @enum     primitive_e
+         * @brief    Draw primitives timed on a redraw
+         */
+        enum primitive_e : uint8_t
+        {
+            rect_primitive,   /* rectangle without shadow, screen and canvas backgrounds */
+            shadow_primitive, /* rectangle with shadow, MainButton style */
+            arc_primitive,
+            label_primitive,  /* one glyph of a label */
+            icon_primitive,   /* LV_IMG_CF_ALPHA_1BIT image, recolored by style */
+            image_primitive,  /* other images */
+            primitive_count,
+        };
+
+        /**
+         * @struct   primitive_stats_s
+         * @typedef  primitive_stats_t
+         * @brief    Calls and time of a primitive
+         */
+        typedef struct primitive_stats_s
+        {
+            uint32_t count;
+            uint64_t ns;
+        } primitive_stats_t;
+
+        /**
+         * @struct   stats_s
+         * @typedef  stats_t
+         * @brief    Counters since the last reset_stats()
+         */
+        typedef struct stats_s
+        {
+            primitive_stats_t primitives[primitive_count];
+            uint32_t flushes;
+            uint64_t flush_ns; /* stripe copies to the panel framebuffer */
+            uint32_t refreshed_px; /* invalidated pixels rendered, from monitor_cb */
+        } stats_t;
+
+        /**
+         * @brief   lv_init and register the memory display
+         */
+        void init();
+
+        /**
+         * @brief   Swap the draw buffers of the display, stripe_mode after init
+         */
+        void set_mode(mode_e mode);
+
+        /**
+         * @brief   Invalidate the active screen and render it at once
+         * @return  Time of the redraw in nanoseconds, flushes included
+         */
+        uint64_t redraw();
+
+        /**
+         * @brief   Render only what the widgets invalidated since the last refresh
+         * @return  Invalidated pixels rendered, 0 when nothing was invalidated
+         */
+        uint32_t refresh();
+
+        /**
+         * @brief   Run the LVGL task loop of lvgl_port.cpp for a simulated period
+         * @details Each lv_timer_handler call is followed by a sleep of its
+         *          next timer period clamped like the port task, the tick moves
+         *          by the sleep and the busy time is measured on the host
+         * @return  Task counters of the period, like lvgl::port::get_task_stats
+         */
+        lvgl::port::task_stats_t run_task(uint32_t ms);
+
+        /**
+         * @brief   CRC-32 of the panel framebuffer, RGB565 in panel orientation
+         */
+        uint32_t framebuffer_crc();
+
+        stats_t get_stats();
+        void reset_stats();
+
+        /**
+         * @brief   Name of a primitive on the report
+         */
+        const char *name(primitive_e primitive);
+
+        /**
+         * @brief   Name of a render mode on the report
+         */
+        const char *name(mode_e mode);
+
+    } // namespace render
+
+} // namespace streamDeco
+
+#endif
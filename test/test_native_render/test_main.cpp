@@ -0,0 +1,501 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <initializer_list>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "render_target.hpp"
+#include "streamDeco_screens.hpp"
+
+using namespace streamDeco;
+
+namespace
+{
+    constexpr uint32_t redraws = 10;
+
+    enum screen_e : uint8_t
+    {
+        main_screen,
+        pinned_screen, /* toggle buttons on, host feedback */
+        applications_screen,
+        multimedia_screen,
+        configurations_screen,
+        monitor_screen,
+        screen_count,
+    };
+
+    const char *const screen_names[screen_count] = {
+        "main", "main_pinned", "applications", "multimedia", "configurations", "monitor",
+    };
+
+    enum rotation_e : uint8_t
+    {
+        landscape_rotation,
+        portrait_rotation,
+        rotation_count,
+    };
+
+    const char *const rotation_names[rotation_count] = {"landscape", "portrait"};
+
+    /**
+     * Framebuffer CRC of each screen, rendered by LVGL 8.4 with lv_conf.h of
+     * lib/lvglClass. A change of layout, style or icon changes it, update the
+     * table with the crc values of render_report.json once the new look is checked.
+     */
+    constexpr uint32_t golden_crc[rotation_count][screen_count] = {
+        {0x307ECC1A, 0xEC9F5DA9, 0xEB669AE1, 0x1B892864, 0x481C48F0, 0x4838F369},
+        {0xEC3E4B63, 0xE46F6CA5, 0x374FBB79, 0xE53615D4, 0xDD3E56D2, 0x4B5A98D5},
+    };
+
+    typedef struct result_s
+    {
+        uint64_t min_ns;
+        uint64_t mean_ns;
+        render::stats_t stats; /* sum of all redraws */
+        uint32_t crc;
+    } result_t;
+
+    /**
+     * Screen of the firmware, src/streamDeco_screens.cpp built like
+     * streamDeco::init with fixed settings, show() leaves the canvas and
+     * toggle state of the button events of each screen
+     */
+    namespace screens
+    {
+        frame::metrics_t sample_metrics()
+        {
+            frame::metrics_t metrics = {};
+            metrics.cpu_load = 37;
+            metrics.cpu_temp = 54;
+            metrics.cpu_freq = 3600;
+            metrics.gpu_load = 12;
+            metrics.gpu_temp = 48;
+            metrics.gpu_freq = 1750;
+            metrics.mem_used = 9120;
+            metrics.mem_max = 32680;
+            metrics.disk_used = 412;
+            metrics.disk_max = 931;
+            return metrics;
+        }
+
+        void create()
+        {
+            settings::settings_t settings = {};
+            settings.rotation = lvgl::screen::LANDSCAPE;
+            settings.color_background = lvgl::palette::main(lvgl::palette::DEEP_ORANGE);
+            settings.color_buttons = lvgl::palette::PURPLE;
+            settings.lcd_bright = lvgl::port::backlight_max() / 2;
+
+            lvgl::screen::set_rotation(settings.rotation);
+            lvgl::screen::set_bg_color(settings.color_background);
+            streamDecoScreen::init(settings);
+
+            /* values of a StreamDecoMonitor frame, see handleFrame and handleClock */
+            streamDecoMonitor::update(sample_metrics());
+            struct tm date = {};
+            date.tm_sec = 15;
+            date.tm_min = 42;
+            date.tm_hour = 21;
+            date.tm_mday = 16;
+            date.tm_mon = 9;
+            date.tm_year = 126;
+            date.tm_wday = 5;
+            streamDecoMonitor::clock.set_time(date);
+        }
+
+        void landscape()
+        {
+            streamDecoScreen::rotate(lvgl::screen::LANDSCAPE);
+        }
+
+        void portrait()
+        {
+            streamDecoScreen::rotate(lvgl::screen::PORTRAIT);
+        }
+
+        /* canvas and pin state left by the button events of each screen */
+        void show(screen_e screen)
+        {
+            using namespace streamDecoCanvas;
+            screen == applications_screen ? applications.unhidden() : applications.hidden();
+            screen == multimedia_screen ? multimedia.unhidden() : multimedia.hidden();
+            screen == configurations_screen ? configurations.unhidden() : configurations.hidden();
+            screen == monitor_screen ? monitor.unhidden() : monitor.hidden();
+
+            const bool pinned = screen == pinned_screen;
+            streamDecoButtons::multimedia_play.setToggled(pinned);
+            streamDecoButtons::multimedia_mic.setToggled(pinned);
+            streamDecoButtons::pin.setToggled(pinned);
+            screen == multimedia_screen ? streamDecoButtons::mult1.pin() : streamDecoButtons::mult1.unpin();
+        }
+
+    } // namespace screens
+
+    result_t measure()
+    {
+        result_t result = {};
+        render::redraw(); /* layout and style caches */
+        render::reset_stats();
+        result.min_ns = UINT64_MAX;
+        uint64_t total_ns = 0;
+        for (uint32_t i = 0; i < redraws; i++)
+        {
+            const uint64_t ns = render::redraw();
+            total_ns += ns;
+            if (ns < result.min_ns)
+                result.min_ns = ns;
+        }
+        result.mean_ns = total_ns / redraws;
+        result.stats = render::get_stats();
+        result.crc = render::framebuffer_crc();
+        return result;
+    }
+
+    /**
+     * Label text benchmark, ns and heap allocations per call of each way
+     * to set a metric label text
+     */
+    namespace label
+    {
+        constexpr uint32_t calls = 100000;
+
+        enum method_e : uint8_t
+        {
+            heap_fmt_method,  /* set_text_fmt before stack formatting, reference */
+            stack_fmt_method, /* set_text_fmt */
+            int_method,       /* set_text_int */
+            buffer_method,    /* text::Buffer alone, no label */
+            method_count,
+        };
+
+        const char *const method_names[method_count] = {"heap_fmt", "stack_fmt", "int", "buffer"};
+
+        typedef struct result_s
+        {
+            uint64_t ns;
+            uint32_t allocations;
+        } result_t;
+
+        uint64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /* Label::set_text_fmt as it was, two vsnprintf and one heap buffer per call */
+        void set_text_fmt_heap(lvgl::Label &label, const char *fmt, ...)
+        {
+            va_list args;
+            va_start(args, fmt);
+            int size = vsnprintf(nullptr, 0, fmt, args);
+            va_end(args);
+            char *buffer = (char *)heap_caps_malloc(size + 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            va_start(args, fmt);
+            vsnprintf(buffer, size + 1, fmt, args);
+            va_end(args);
+            lvgl::port::mutex_take();
+            lv_label_set_text(label.get_object(), buffer);
+            heap_caps_free(buffer);
+            lvgl::port::mutex_give();
+        }
+
+        /**
+         * Set the text of a bar label like bar2_set_value, with a new value on
+         * each call when changing, else with the same value
+         */
+        result_t measure(lvgl::Label &label, method_e method, bool changing)
+        {
+            size_t length = 0;
+            const uint32_t allocations = heap_caps_malloc_calls;
+            const uint64_t start_ns = now_ns();
+            for (uint32_t i = 0; i < calls; i++)
+            {
+                const int32_t value = changing ? 1000 + static_cast<int32_t>(i % 2600) : 3600;
+                switch (method)
+                {
+                case heap_fmt_method:
+                    set_text_fmt_heap(label, "%d%s", value, " MHz");
+                    break;
+                case stack_fmt_method:
+                    label.set_text_fmt("%d%s", value, " MHz");
+                    break;
+                case int_method:
+                    label.set_text_int("", value, " MHz");
+                    break;
+                default:
+                {
+                    lvgl::text::Buffer<64> text;
+                    text.append("").append(value).append(" MHz");
+                    length += text.size(); /* keeps the loop from being optimized out */
+                    break;
+                }
+                }
+            }
+            result_t result = {};
+            result.ns = (now_ns() - start_ns) / calls;
+            result.allocations = heap_caps_malloc_calls - allocations;
+            TEST_ASSERT_TRUE(method != buffer_method || length > 0);
+            return result;
+        }
+
+    } // namespace label
+
+    typedef result_t results_t[render::mode_count][rotation_count][screen_count];
+
+    void print_report(FILE *file, const results_t &results)
+    {
+        lv_mem_monitor_t memory;
+        lv_mem_monitor(&memory);
+
+        fprintf(file, "{\n  \"display\": {\"width\": %d, \"height\": %d, \"stripe_lines\": %d},\n",
+                render::display_width, render::display_height, render::stripe_lines);
+        fprintf(file, "  \"redraws\": %u,\n", redraws);
+        fprintf(file, "  \"lvgl_pool\": {\"size\": %u, \"used\": %u, \"frag_pct\": %u},\n",
+                static_cast<unsigned>(memory.total_size), static_cast<unsigned>(memory.total_size - memory.free_size),
+                memory.frag_pct);
+        fprintf(file, "  \"screens\": [\n");
+        for (uint8_t mode = 0; mode < render::mode_count; mode++)
+        {
+            for (uint8_t rotation = 0; rotation < rotation_count; rotation++)
+            {
+                for (uint8_t screen = 0; screen < screen_count; screen++)
+                {
+                    const result_t &result = results[mode][rotation][screen];
+                    uint64_t primitives_ns = 0;
+                    fprintf(file, "    {\"screen\": \"%s\", \"rotation\": \"%s\", \"mode\": \"%s\", \"crc\": \"0x%08X\",\n",
+                            screen_names[screen], rotation_names[rotation],
+                            render::name(static_cast<render::mode_e>(mode)), result.crc);
+                    fprintf(file, "     \"redraw_ms\": {\"mean\": %.3f, \"min\": %.3f},\n",
+                            result.mean_ns / 1e6, result.min_ns / 1e6);
+                    fprintf(file, "     \"primitives\": {");
+                    for (uint8_t primitive = 0; primitive < render::primitive_count; primitive++)
+                    {
+                        const render::primitive_stats_t &stats = result.stats.primitives[primitive];
+                        primitives_ns += stats.ns;
+                        fprintf(file, "%s\"%s\": {\"count\": %u, \"ms\": %.3f}", primitive ? ", " : "",
+                                render::name(static_cast<render::primitive_e>(primitive)),
+                                stats.count / redraws, stats.ns / 1e6 / redraws);
+                    }
+                    const uint64_t total_ns = result.mean_ns * redraws;
+                    const uint64_t other_ns = total_ns > primitives_ns + result.stats.flush_ns
+                                                  ? total_ns - primitives_ns - result.stats.flush_ns
+                                                  : 0;
+                    fprintf(file, "},\n     \"flush_ms\": %.3f, \"other_ms\": %.3f}%s\n",
+                            result.stats.flush_ns / 1e6 / redraws, other_ns / 1e6 / redraws,
+                            mode == render::mode_count - 1 && rotation == rotation_count - 1 && screen == screen_count - 1
+                                ? ""
+                                : ",");
+                }
+            }
+        }
+        fprintf(file, "  ]\n}\n");
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* Render each screen in both rotations and render modes, write the JSON report and check the framebuffers */
+void test_screen_benchmark(void)
+{
+    static results_t results;
+
+    for (uint8_t mode = 0; mode < render::mode_count; mode++)
+    {
+        render::set_mode(static_cast<render::mode_e>(mode));
+        for (uint8_t rotation = 0; rotation < rotation_count; rotation++)
+        {
+            rotation == landscape_rotation ? screens::landscape() : screens::portrait();
+            for (uint8_t screen = 0; screen < screen_count; screen++)
+            {
+                screens::show(static_cast<screen_e>(screen));
+                results[mode][rotation][screen] = measure();
+            }
+        }
+    }
+    render::set_mode(render::stripe_mode);
+    screens::landscape();
+    screens::show(main_screen);
+
+    const char *path = getenv("STREAMDECO_RENDER_REPORT");
+    FILE *file = fopen(path ? path : "render_report.json", "w");
+    if (file != nullptr)
+    {
+        print_report(file, results);
+        fclose(file);
+    }
+    print_report(stdout, results);
+
+    /* both modes must draw the same frame, partial in one flush per landscape
+       redraw, sw_rotate splits portrait in LV_DISP_ROT_MAX_BUF chunks anyway */
+    for (uint8_t mode = 0; mode < render::mode_count; mode++)
+    {
+        for (uint8_t rotation = 0; rotation < rotation_count; rotation++)
+        {
+            for (uint8_t screen = 0; screen < screen_count; screen++)
+            {
+                const result_t &result = results[mode][rotation][screen];
+                TEST_ASSERT_EQUAL_HEX32_MESSAGE(golden_crc[rotation][screen], result.crc, screen_names[screen]);
+                TEST_ASSERT_TRUE(result.stats.primitives[render::shadow_primitive].count > 0);
+                TEST_ASSERT_TRUE(result.stats.primitives[render::icon_primitive].count > 0);
+                if (mode == render::partial_mode && rotation == landscape_rotation)
+                    TEST_ASSERT_EQUAL_UINT32(redraws, result.stats.flushes);
+            }
+            TEST_ASSERT_TRUE(results[mode][rotation][monitor_screen].stats.primitives[render::arc_primitive].count > 0);
+            TEST_ASSERT_TRUE(results[mode][rotation][monitor_screen].stats.primitives[render::label_primitive].count > 0);
+        }
+    }
+}
+
+/* Rotating and coming back must leave the same frame, positions are not accumulated */
+void test_rotation_round_trip(void)
+{
+    screens::landscape();
+    screens::show(main_screen);
+    render::redraw();
+    const uint32_t before = render::framebuffer_crc();
+
+    screens::portrait();
+    render::redraw();
+    TEST_ASSERT_TRUE(render::framebuffer_crc() != before);
+
+    screens::landscape();
+    render::redraw();
+    TEST_ASSERT_EQUAL_HEX32(before, render::framebuffer_crc());
+}
+
+/* Repeated and ±1 jittered monitor frames must not invalidate anything, see set_deadband */
+void test_monitor_deadband(void)
+{
+    screens::landscape();
+    screens::show(monitor_screen);
+    render::redraw();
+
+    frame::metrics_t metrics = screens::sample_metrics();
+    metrics.cpu_load += 10;
+    metrics.gpu_temp += 5;
+    metrics.mem_used += 512;
+    streamDecoMonitor::update(metrics);
+    const uint32_t changed_px = render::refresh();
+
+    streamDecoMonitor::update(metrics);
+    const uint32_t repeated_px = render::refresh();
+
+    uint32_t jittered_px = 0;
+    for (int8_t jitter : {1, -1})
+    {
+        frame::metrics_t jittered = metrics;
+        jittered.cpu_load += jitter;
+        jittered.cpu_temp += jitter;
+        jittered.cpu_freq += jitter;
+        jittered.gpu_load += jitter;
+        jittered.gpu_temp += jitter;
+        jittered.gpu_freq += jitter;
+        jittered.mem_used += jitter;
+        streamDecoMonitor::update(jittered);
+        jittered_px += render::refresh();
+    }
+
+    streamDecoMonitor::update(screens::sample_metrics());
+    render::refresh();
+    screens::show(main_screen);
+
+    printf("{\"monitor_px\": {\"changed\": %u, \"repeated\": %u, \"jittered\": %u}}\n",
+           changed_px, repeated_px, jittered_px);
+    TEST_ASSERT_TRUE(changed_px > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, repeated_px);
+    TEST_ASSERT_EQUAL_UINT32(0, jittered_px);
+}
+
+/* Label text setters against the heap-allocating set_text_fmt they replaced */
+void test_label_text_benchmark(void)
+{
+    lvgl::Label text;
+    text.create();
+    text.hidden();
+
+    label::result_t results[label::method_count][2];
+    for (uint8_t method = 0; method < label::method_count; method++)
+        for (bool changing : {true, false})
+            results[method][changing] = label::measure(text, static_cast<label::method_e>(method), changing);
+
+    printf("{\"label_calls\": %u, \"methods\": [\n", label::calls);
+    for (uint8_t method = 0; method < label::method_count; method++)
+    {
+        printf("  {\"method\": \"%s\", \"changing\": {\"ns\": %llu, \"allocations\": %u}, "
+               "\"unchanged\": {\"ns\": %llu, \"allocations\": %u}}%s\n",
+               label::method_names[method],
+               static_cast<unsigned long long>(results[method][1].ns), results[method][1].allocations,
+               static_cast<unsigned long long>(results[method][0].ns), results[method][0].allocations,
+               method == label::method_count - 1 ? "" : ",");
+    }
+    printf("]}\n");
+
+    /* one heap buffer per call before, none now as metric texts fit the stack buffer */
+    TEST_ASSERT_EQUAL_UINT32(label::calls, results[label::heap_fmt_method][1].allocations);
+    for (uint8_t method = label::stack_fmt_method; method < label::method_count; method++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(0, results[method][0].allocations);
+        TEST_ASSERT_EQUAL_UINT32(0, results[method][1].allocations);
+    }
+    TEST_ASSERT_EQUAL_STRING("3600 MHz", lv_label_get_text(text.get_object()));
+}
+
+/* With no input and no frame the LVGL task must sleep up to task_period_max_ms */
+void test_idle_task_wakeups(void)
+{
+    constexpr uint32_t idle_ms = 60000;
+    screens::show(main_screen);
+    render::run_task(1000); /* pending refresh and timers of the tests before */
+
+    const lvgl::port::task_stats_t task_stats = render::run_task(idle_ms);
+    printf("{\"idle_task\": {\"ms\": %u, \"wakeups\": %u, \"wakeups_per_s\": %.2f, \"busy_us\": %llu, \"duty_pct\": %.4f}}\n",
+           idle_ms, task_stats.wakeups, lvgl::port::task_wakeups_rate(task_stats),
+           static_cast<unsigned long long>(task_stats.busy_us), lvgl::port::task_duty(task_stats) * 100.0f);
+    TEST_ASSERT_TRUE(lvgl::port::task_wakeups_rate(task_stats) <= 1000.0f / lvgl::port::task_period_max_ms + 0.1f);
+    TEST_ASSERT_TRUE(lvgl::port::task_duty(task_stats) < 0.001f);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    render::init();
+    screens::create();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_screen_benchmark);
+    RUN_TEST(test_rotation_round_trip);
+    RUN_TEST(test_monitor_deadband);
+    RUN_TEST(test_label_text_benchmark);
+    RUN_TEST(test_idle_task_wakeups); /* last, it moves the LVGL tick */
+    return UNITY_END();
+}
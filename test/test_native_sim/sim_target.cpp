@@ -0,0 +1,231 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "sim_target.hpp"
+#include <string.h>
+
+namespace streamDeco
+{
+
+    namespace sim
+    {
+
+        bool ScriptedSerial::send(int64_t start_us, const uint8_t *data, size_t size)
+        {
+            if (size > capacity - _size)
+                return false;
+            for (size_t i = 0; i < size; i++)
+            {
+                _bytes[_size] = data[i];
+                _arrival_us[_size] = start_us + static_cast<int64_t>(i + 1) * uart_byte_us;
+                _size++;
+            }
+            return true;
+        } // ScriptedSerial::send
+
+        int64_t ScriptedSerial::next_callback(int64_t now_us) const
+        {
+            if (_read == _size)
+                return -1;
+
+            // burst of back to back bytes, up to a full FIFO
+            size_t last = _read;
+            while (last + 1 < _size && last + 1 - _read < uart_fifo_full &&
+                   _arrival_us[last + 1] - _arrival_us[last] <= uart_byte_us)
+                last++;
+
+            int64_t callback_us = _arrival_us[last];
+            if (last + 1 - _read < uart_fifo_full)
+                callback_us += uart_timeout_us;
+            return callback_us > now_us ? callback_us : now_us;
+        } // ScriptedSerial::next_callback
+
+        size_t ScriptedSerial::read(uint8_t *data, size_t size)
+        {
+            size_t count = 0;
+            while (count < size && _read < _size && _arrival_us[_read] <= _now_us)
+                data[count++] = _bytes[_read++];
+            return count;
+        } // ScriptedSerial::read
+
+        RecordingKeyboard::RecordingKeyboard()
+        {
+            _policy.onConnect(host_interval, 0);
+            _policy.idle();
+            BleConnParams params;
+            if (_policy.poll(0, params))
+                _policy.onParams(params.minInterval, params.latency);
+        } // RecordingKeyboard::RecordingKeyboard
+
+        void RecordingKeyboard::set_active(int64_t now_us)
+        {
+            update(now_us);
+            _last_activity_us = now_us;
+            _policy.activity();
+            request(now_us);
+        } // RecordingKeyboard::set_active
+
+        void RecordingKeyboard::update(int64_t now_us)
+        {
+            const int64_t idle_us = _last_activity_us + idle_after_us;
+            if (now_us >= idle_us && _policy.getTarget() == BleConnectionPolicy::ACTIVE)
+            {
+                _policy.idle();
+                request(idle_us);
+            }
+            if (_apply_us >= 0 && now_us >= _apply_us)
+            {
+                _policy.onParams(_requested.minInterval, _requested.latency);
+                _apply_us = -1;
+            }
+        } // RecordingKeyboard::update
+
+        void RecordingKeyboard::request(int64_t at_us)
+        {
+            BleConnParams params;
+            if (!_policy.poll(static_cast<uint32_t>(at_us / 1000), params))
+                return;
+            _requested = params;
+            _apply_us = event_at(at_us) + _policy.getInterval() * interval_unit_us;
+        } // RecordingKeyboard::request
+
+        int64_t RecordingKeyboard::event_at(int64_t now_us)
+        {
+            const int64_t interval = _policy.getInterval() * interval_unit_us;
+            if (now_us <= event_anchor_us)
+                return event_anchor_us;
+            return event_anchor_us + (now_us - event_anchor_us + interval - 1) / interval * interval;
+        } // RecordingKeyboard::event_at
+
+        int64_t RecordingKeyboard::next_event(int64_t now_us)
+        {
+            update(now_us);
+            return event_at(now_us);
+        } // RecordingKeyboard::next_event
+
+        int64_t RecordingKeyboard::play(macro::Player &player, int64_t now_us)
+        {
+            macro::report_t report;
+            int64_t ready_us = now_us > _busy_us ? now_us : _busy_us;
+            while (player.next(report) && _count < capacity)
+            {
+                ready_us += static_cast<int64_t>(report.delay_ms) * 1000;
+                ready_us = next_event(ready_us);
+                _records[_count].notify_us = ready_us;
+                _records[_count].report = report;
+                _count++;
+                // one notify per event, the sender waits its status
+                ready_us++;
+            }
+            _busy_us = ready_us;
+            return ready_us > now_us ? ready_us - 1 : now_us;
+        } // RecordingKeyboard::play
+
+        ModeledHeap::ModeledHeap(uint32_t size) : _size(size), _free(size), _min_free(size)
+        {
+            _blocks[0] = {0, size, false};
+            _count = 1;
+        } // ModeledHeap::ModeledHeap
+
+        int32_t ModeledHeap::alloc(uint32_t size)
+        {
+            const uint32_t needed = (size + heap_block_header + alignment - 1) / alignment * alignment;
+            for (size_t i = 0; i < _count; i++)
+            {
+                block_t &block = _blocks[i];
+                if (block.used || block.size < needed)
+                    continue;
+
+                // split, the remainder stays free after the new block
+                if (block.size - needed >= alignment + heap_block_header && _count < max_blocks)
+                {
+                    memmove(&_blocks[i + 2], &_blocks[i + 1], (_count - i - 1) * sizeof(block_t));
+                    _blocks[i + 1] = {block.offset + needed, block.size - needed, false};
+                    block.size = needed;
+                    _count++;
+                }
+                block.used = true;
+                _free -= block.size;
+                if (_free < _min_free)
+                    _min_free = _free;
+                return static_cast<int32_t>(block.offset);
+            }
+            return -1;
+        } // ModeledHeap::alloc
+
+        void ModeledHeap::free(int32_t offset)
+        {
+            size_t i = 0;
+            while (i < _count && _blocks[i].offset != static_cast<uint32_t>(offset))
+                i++;
+            if (i == _count || !_blocks[i].used)
+                return;
+
+            _blocks[i].used = false;
+            _free += _blocks[i].size;
+            if (i + 1 < _count && !_blocks[i + 1].used)
+            {
+                _blocks[i].size += _blocks[i + 1].size;
+                erase(i + 1);
+            }
+            if (i > 0 && !_blocks[i - 1].used)
+            {
+                _blocks[i - 1].size += _blocks[i].size;
+                erase(i);
+            }
+        } // ModeledHeap::free
+
+        void ModeledHeap::erase(size_t index)
+        {
+            memmove(&_blocks[index], &_blocks[index + 1], (_count - index - 1) * sizeof(block_t));
+            _count--;
+        } // ModeledHeap::erase
+
+        memory::usage_t ModeledHeap::usage() const
+        {
+            memory::usage_t usage = {_size, _free, 0, _min_free};
+            for (size_t i = 0; i < _count; i++)
+                if (!_blocks[i].used && _blocks[i].size > usage.largest)
+                    usage.largest = _blocks[i].size;
+            return usage;
+        } // ModeledHeap::usage
+
+        size_t ModeledHeap::used_blocks() const
+        {
+            size_t used = 0;
+            for (size_t i = 0; i < _count; i++)
+                used += _blocks[i].used;
+            return used;
+        } // ModeledHeap::used_blocks
+
+        bool HeapProbe::read(memory::pool_e pool, memory::usage_t &usage)
+        {
+            if (pool >= memory::pool_count || _heaps[pool] == nullptr)
+                return false;
+            usage = _heaps[pool]->usage();
+            return true;
+        } // HeapProbe::read
+
+    } // namespace sim
+
+} // namespace streamDeco
@@ -0,0 +1,239 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _STREAMDECO_SIM_TARGET_HPP_
+#define _STREAMDECO_SIM_TARGET_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "BleConnectionPolicy.h"
+#include "streamDeco_frame.hpp"
+#include "streamDeco_macro.hpp"
+#include "streamDeco_memory.hpp"
+
+namespace streamDeco
+{
+
+    /**
+     * Stand-ins of the target for the native simulator.
+     *
+     * Tasks are not run, the harness steps a virtual clock and each stand-in
+     * answers when its hardware would: UART bytes at 115200 baud, HID reports
+     * on BLE connection events. The constants are estimates taken from the
+     * firmware, change them together with the code they model. They only
+     * order the session, no latency is reported from them.
+     */
+    namespace sim
+    {
+
+        constexpr int64_t uart_byte_us = 87;          /* 10 bits at 115200 baud */
+        constexpr int64_t uart_timeout_us = 2 * 87;   /* HardwareSerial RX timeout, 2 symbols */
+        constexpr size_t uart_fifo_full = 120;        /* HardwareSerial RX FIFO full threshold */
+        constexpr int64_t task_switch_us = 50;
+        constexpr int64_t interval_unit_us = 1250;    /* BLE connection interval unit */
+        constexpr uint16_t host_interval = 24;        /* 30 ms, chosen by the host on connection */
+        constexpr int64_t idle_after_us = 30000000;   /* backlight_idle timer calls setIdle */
+        constexpr int64_t event_anchor_us = 3100;     /* first connection event, off the taps grid */
+        constexpr uint32_t lvgl_pool_size = 48 * 1024; /* LV_MEM_SIZE of the board */
+        constexpr uint32_t heap_block_header = 8;      /* TLSF and multi_heap block overhead */
+
+        /**
+         * @class    ScriptedSerial
+         * @brief    Serial stand-in, bytes written by the script are read
+         *           once the UART would have received them
+         */
+        class ScriptedSerial : public frame::Source
+        {
+        public:
+            static constexpr size_t capacity = 4096;
+
+            /**
+             * @brief   Queue bytes sent by the computer
+             * @param   start_us  Time of the start bit of the first byte
+             * @return  false if the script is longer than capacity
+             */
+            bool send(int64_t start_us, const uint8_t *data, size_t size);
+
+            /**
+             * @brief   Time of the next receive callback after now_us, -1 if none
+             * @details Fired on RX FIFO full or after RX timeout, like Serial.onReceive
+             */
+            int64_t next_callback(int64_t now_us) const;
+
+            /**
+             * @brief   Time the bytes are read by ingest
+             */
+            void set_time(int64_t now_us) { _now_us = now_us; }
+
+            size_t read(uint8_t *data, size_t size) override;
+
+            size_t pending() const { return _size - _read; }
+
+        private:
+            uint8_t _bytes[capacity];
+            int64_t _arrival_us[capacity];
+            size_t _size = 0;
+            size_t _read = 0;
+            int64_t _now_us = 0;
+        }; // class ScriptedSerial
+
+        /**
+         * @class    RecordingKeyboard
+         * @brief    BleKeyboard stand-in, reports are recorded with the time
+         *           of the connection event that carried them
+         * @details  The connection interval is negotiated by BleConnectionPolicy,
+         *           the host applies the lowest interval of each request one
+         *           connection event after it
+         */
+        class RecordingKeyboard
+        {
+        public:
+            static constexpr size_t capacity = 512;
+
+            /**
+             * @brief   Connected before the session, already on idle parameters
+             */
+            RecordingKeyboard();
+
+            typedef struct record_s
+            {
+                int64_t notify_us;
+                macro::report_t report;
+            } record_t;
+
+            /**
+             * @brief   BleKeyboard::setActive
+             * @details The policy asks the active parameters, after idle_after_us
+             *          without keys it asks the idle ones
+             */
+            void set_active(int64_t now_us);
+
+            /**
+             * @brief   Play reports like BleKeyboard sender task, one notify
+             *          per connection event, report delays waited before it
+             * @return  Time of the last notify, now_us if nothing was sent
+             */
+            int64_t play(macro::Player &player, int64_t now_us);
+
+            size_t count() const { return _count; }
+            const record_t &operator[](size_t index) const { return _records[index]; }
+            BleConnectionPolicy &policy() { return _policy; }
+
+        private:
+            /**
+             * @brief   Apply the host answer and the idle timeout up to now_us
+             */
+            void update(int64_t now_us);
+
+            /**
+             * @brief   Send the request of the policy, if any, at at_us
+             */
+            void request(int64_t at_us);
+
+            /**
+             * @brief   First connection event at or after now_us, current interval
+             */
+            int64_t event_at(int64_t now_us);
+
+            int64_t next_event(int64_t now_us);
+
+            record_t _records[capacity];
+            size_t _count = 0;
+            BleConnectionPolicy _policy;
+            BleConnParams _requested = {};
+            int64_t _apply_us = -1;      /* host applies _requested, -1 if nothing requested */
+            int64_t _last_activity_us = -idle_after_us;
+            int64_t _busy_us = 0;        /* sender task playing until */
+        }; // class RecordingKeyboard
+
+        /**
+         * @class    ModeledHeap
+         * @brief    First fit heap model, only offsets are kept
+         * @details  Blocks are split on allocation and merged with free
+         *           neighbours on release, like TLSF and multi_heap do,
+         *           so churn and leaks fragment it like the target pools
+         */
+        class ModeledHeap
+        {
+        public:
+            static constexpr size_t max_blocks = 1024;
+            static constexpr uint32_t alignment = 8;
+
+            explicit ModeledHeap(uint32_t size);
+
+            /**
+             * @brief   Allocate size bytes
+             * @return  Offset of the block, -1 if no free block is large enough
+             */
+            int32_t alloc(uint32_t size);
+
+            /**
+             * @brief   Release a block returned by alloc
+             */
+            void free(int32_t offset);
+
+            /**
+             * @brief   Usage like heap_caps_get_info and lv_mem_monitor
+             */
+            memory::usage_t usage() const;
+
+            size_t used_blocks() const;
+
+        private:
+            typedef struct block_s
+            {
+                uint32_t offset;
+                uint32_t size; /* header included */
+                bool used;
+            } block_t;
+
+            void erase(size_t index);
+
+            block_t _blocks[max_blocks];
+            size_t _count = 0;
+            uint32_t _size;
+            uint32_t _free;
+            uint32_t _min_free;
+        }; // class ModeledHeap
+
+        /**
+         * @class    HeapProbe
+         * @brief    memory::Probe of modeled heaps, pools without heap are not available
+         */
+        class HeapProbe : public memory::Probe
+        {
+        public:
+            void attach(memory::pool_e pool, const ModeledHeap *heap) { _heaps[pool] = heap; }
+
+            bool read(memory::pool_e pool, memory::usage_t &usage) override;
+
+        private:
+            const ModeledHeap *_heaps[memory::pool_count] = {};
+        }; // class HeapProbe
+
+    } // namespace sim
+
+} // namespace streamDeco
+
+#endif
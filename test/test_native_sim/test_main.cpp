@@ -0,0 +1,987 @@
+/**
+ * Copyright © 2024 Marcelo H Moraes
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_target.hpp"
+#include "streamDeco_executor.hpp"
+#include "streamDeco_keymap.hpp"
+#include "streamDeco_memory.hpp"
+#include "streamDeco_trace.hpp"
+
+using namespace streamDeco;
+
+namespace
+{
+    /* Allocations while the session runs, the firmware paths must not allocate */
+    bool counting = false;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+}
+
+void *operator new(size_t size)
+{
+    if (counting)
+    {
+        allocations++;
+        allocated_bytes += size;
+    }
+    void *memory = malloc(size ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+namespace
+{
+    uint64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    enum event_e : uint8_t
+    {
+        terminal_event, /* chord */
+        play_event,     /* media key */
+        hello_event,    /* typed text */
+        delayed_event,  /* delay then chord */
+        event_count,
+    };
+
+    typedef struct tap_s
+    {
+        int64_t at_ms;
+        uint8_t event;
+    } tap_t;
+
+    /* Scripted session */
+    constexpr tap_t taps[] = {
+        {500, terminal_event}, /* link still idle */
+        {1200, play_event},
+        {1900, hello_event},
+        {2600, delayed_event},
+        {3300, terminal_event},
+        {3360, terminal_event}, /* double tap, waits the buttons task pause */
+        {4000, hello_event},
+        {4700, play_event},
+        {5400, terminal_event},
+        {6100, delayed_event},
+        {6800, terminal_event},
+        {7500, play_event},
+        {8200, hello_event},
+        {8900, terminal_event},
+        {9600, play_event},
+        {40000, terminal_event}, /* after idle timeout */
+    };
+    constexpr size_t tap_count = sizeof(taps) / sizeof(taps[0]);
+
+    constexpr int64_t session_ms = 42000;
+    constexpr int64_t frame_period_ms = 1000;
+    constexpr int64_t frame_offset_ms = 250;
+    constexpr size_t text_frame_every = 5;
+    constexpr size_t max_frames = session_ms / frame_period_ms;
+
+    typedef struct stats_s
+    {
+        size_t count;
+        int64_t p50;
+        int64_t p99;
+        int64_t max;
+    } stats_t;
+
+    stats_t percentiles(int64_t *values, size_t count)
+    {
+        stats_t stats = {};
+        if (count == 0)
+            return stats;
+        std::sort(values, values + count);
+        stats.count = count;
+        stats.p50 = values[(count - 1) * 50 / 100];
+        stats.p99 = values[(count - 1) * 99 / 100];
+        stats.max = values[count - 1];
+        return stats;
+    }
+
+    typedef struct report_s
+    {
+        stats_t handler_ns; /* host time of each tap handler */
+        stats_t decode_ns;  /* host time of each frame decode */
+        size_t frames;
+        size_t frames_sent;
+        uint32_t parser_errors;
+        size_t hid_reports;
+        uint32_t characters;
+        size_t allocations;
+        size_t allocated_bytes;
+    } report_t;
+
+    /* Objects of the session, static like the firmware ones */
+    keymap::Table table(event_count);
+    macro::Player player;
+    sim::ScriptedSerial serial;
+    sim::RecordingKeyboard keyboard;
+    frame::Assembler assembler(frame::transport_serial);
+    int64_t handler_ns[tap_count];
+    int64_t decode_ns[max_frames];
+
+    void build_table()
+    {
+        static uint8_t image[keymap::max_image_size];
+        keymap::Builder builder(image, sizeof(image), event_count);
+        const uint8_t play[2] = {8, 0};
+        const char hello[] = "hello";
+
+        builder.event(terminal_event);
+        builder.chord(chord::keys(0x80, 0x82, 0xB0).report); /* ctrl alt return */
+        builder.event(play_event);
+        builder.media(play);
+        builder.event(hello_event);
+        builder.text(hello, sizeof(hello) - 1);
+        builder.event(delayed_event);
+        builder.delay(50);
+        builder.chord(chord::keys(0x83, 'd').report); /* gui d */
+        size_t size = builder.finish(1);
+        TEST_ASSERT_TRUE(table.load(image, size));
+    }
+
+    /* Metrics frames sent by StreamDecoMonitor, binary and legacy text */
+    size_t script_frames()
+    {
+        size_t count = 0;
+        for (int64_t at_ms = frame_offset_ms; at_ms < session_ms; at_ms += frame_period_ms)
+        {
+            frame::metrics_t metrics = {};
+            metrics.cpu_load = static_cast<int16_t>(count % 100);
+            metrics.cpu_temp = 48;
+            metrics.mem_used = 9120;
+            metrics.mem_max = 32680;
+            metrics.year = 2026;
+
+            uint8_t buffer[frame::max_text_size];
+            size_t size;
+            if (count % text_frame_every == text_frame_every - 1)
+                size = snprintf(reinterpret_cast<char *>(buffer), sizeof(buffer),
+                                "%d, 54, 3600, 12, 48, 1750, 9120, 32680, 412, 931/", metrics.cpu_load);
+            else
+                size = frame::encode(metrics, buffer, sizeof(buffer));
+
+            TEST_ASSERT_TRUE(serial.send(at_ms * 1000, buffer, size));
+            count++;
+        }
+        return count;
+    }
+
+    /* handleButton: the sequence of the event is loaded on the player and played on
+     * the keyboard stand-in, the host time of the real keymap and macro code is measured */
+    void run_taps(report_t &report)
+    {
+        uint8_t steps[keymap::max_sequence_size];
+        size_t count = 0;
+
+        for (const tap_t &tap : taps)
+        {
+            const int64_t touch_us = tap.at_ms * 1000;
+            keyboard.set_active(touch_us);
+
+            const uint64_t start_ns = now_ns();
+            const size_t size = table.sequence(tap.event, steps, sizeof(steps));
+            player.load(steps, size);
+            keyboard.play(player, touch_us);
+            handler_ns[count++] = now_ns() - start_ns;
+            report.characters += player.characters();
+        }
+        report.hid_reports = keyboard.count();
+        report.handler_ns = percentiles(handler_ns, count);
+    }
+
+    /* handleIngest and handleFrame: the worker wakes on receive callback, fills until empty,
+     * the host time of each frame decode is measured */
+    void run_frames(report_t &report)
+    {
+        frame::slot_t slot;
+        int64_t now_us = 0;
+        int64_t callback_us;
+
+        while ((callback_us = serial.next_callback(now_us)) >= 0)
+        {
+            now_us = callback_us + sim::task_switch_us;
+            serial.set_time(now_us);
+            while (true)
+            {
+                size_t received = assembler.fill(serial, now_us);
+                uint64_t start_ns = now_ns();
+                while (assembler.next(slot))
+                {
+                    const uint64_t done_ns = now_ns();
+                    if (report.frames < max_frames)
+                        decode_ns[report.frames++] = done_ns - start_ns;
+                    start_ns = done_ns;
+                }
+                if (received == 0)
+                    break;
+            }
+        }
+        report.parser_errors = assembler.parser().errors();
+        report.decode_ns = percentiles(decode_ns, report.frames);
+    }
+
+    void print_stats(FILE *file, const char *name, uint32_t count, int64_t p50, int64_t p99, int64_t max, bool last)
+    {
+        fprintf(file, "    \"%s\": {\"count\": %u, \"p50\": %lld, \"p99\": %lld, \"max\": %lld}%s\n",
+                name, count, static_cast<long long>(p50), static_cast<long long>(p99),
+                static_cast<long long>(max), last ? "" : ",");
+    }
+
+    void print_report(FILE *file, const report_t &report)
+    {
+        fprintf(file, "{\n  \"session_ms\": %lld,\n  \"taps\": %u,\n",
+                static_cast<long long>(session_ms), static_cast<unsigned>(tap_count));
+        fprintf(file, "  \"host_ns\": {\n");
+        print_stats(file, "handler", report.handler_ns.count, report.handler_ns.p50, report.handler_ns.p99,
+                    report.handler_ns.max, false);
+        print_stats(file, "decode", report.decode_ns.count, report.decode_ns.p50, report.decode_ns.p99,
+                    report.decode_ns.max, true);
+        fprintf(file, "  },\n  \"frames\": {\"sent\": %u, \"decoded\": %u, \"errors\": %u},\n",
+                static_cast<unsigned>(report.frames_sent), static_cast<unsigned>(report.frames), report.parser_errors);
+        fprintf(file, "  \"allocations\": {\"count\": %u, \"bytes\": %u},\n",
+                static_cast<unsigned>(report.allocations), static_cast<unsigned>(report.allocated_bytes));
+        fprintf(file, "  \"hid\": {\"reports\": %u, \"characters\": %u}\n}\n",
+                static_cast<unsigned>(report.hid_reports), report.characters);
+    }
+}
+
+namespace
+{
+    /* Memory soak, one monitor frame per second, sampled like the firmware */
+    constexpr int64_t soak_default_s = 3600;
+    constexpr int64_t memory_sample_s = 5;
+    constexpr size_t monitor_labels = 10;
+    constexpr size_t widget_count = 120;
+    constexpr uint32_t internal_pool_size = 96 * 1024;
+    constexpr int64_t leak_every_s = 10;
+    constexpr int64_t leak_budget = 256; /* text sizes change, free bytes move a little */
+
+    typedef struct soak_s
+    {
+        uint32_t events;
+        int64_t lvgl_growth;
+        int64_t internal_growth;
+        memory::usage_t lvgl;
+        memory::usage_t internal;
+    } soak_t;
+
+    /* Deterministic sizes, the same soak on every run */
+    uint32_t next_random(uint32_t &state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 16;
+    }
+
+    /* Label::set_text_fmt reallocates the text of each monitor label, the monitor
+     * parser builds Arduino Strings of the frame, a leak keeps one object every
+     * leak_every_s seconds */
+    soak_t run_soak(int64_t seconds, bool leak)
+    {
+        sim::ModeledHeap lvgl_heap(sim::lvgl_pool_size);
+        sim::ModeledHeap internal_heap(internal_pool_size);
+        sim::HeapProbe probe;
+        probe.attach(memory::lvgl_pool, &lvgl_heap);
+        probe.attach(memory::internal_pool, &internal_heap);
+        memory::Telemetry telemetry;
+
+        uint32_t random = 1;
+        for (size_t i = 0; i < widget_count; i++)
+            lvgl_heap.alloc(64 + next_random(random) % 256);
+        internal_heap.alloc(12 * 1024); /* new BLEHIDDevice and NimBLE host objects */
+
+        int32_t texts[monitor_labels];
+        for (int32_t &text : texts)
+            text = lvgl_heap.alloc(8);
+
+        for (int64_t second = 1; second <= seconds; second++)
+        {
+            const int32_t frame = internal_heap.alloc(48);
+            int32_t fields[4];
+            for (int32_t &field : fields)
+                field = internal_heap.alloc(4 + next_random(random) % 12);
+
+            for (int32_t &text : texts)
+            {
+                const int32_t replaced = lvgl_heap.alloc(4 + next_random(random) % 16);
+                lvgl_heap.free(text);
+                text = replaced;
+            }
+
+            for (int32_t field : fields)
+                internal_heap.free(field);
+            internal_heap.free(frame);
+
+            if (leak && second % leak_every_s == 0)
+                lvgl_heap.alloc(24);
+
+            if (second % memory_sample_s == 0)
+                telemetry.sample(probe, second * 1000000);
+        }
+
+        return {telemetry.events(), telemetry.growth(memory::lvgl_pool), telemetry.growth(memory::internal_pool),
+                telemetry.last().pools[memory::lvgl_pool], telemetry.last().pools[memory::internal_pool]};
+    }
+
+    void print_soak(const char *name, const soak_t &soak)
+    {
+        printf("Soak %s: lvgl free %u, largest %u, min %u, fragmentation %u %%, growth %lld; "
+               "internal free %u, growth %lld; events %u\n",
+               name, soak.lvgl.free, soak.lvgl.largest, soak.lvgl.min_free, memory::fragmentation(soak.lvgl),
+               static_cast<long long>(soak.lvgl_growth), soak.internal.free,
+               static_cast<long long>(soak.internal_growth), soak.events);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* Replay the scripted session through the real keymap, macro and frame code and write the JSON
+ * report, times are host nanoseconds to compare builds, not target latencies */
+void test_session_report(void)
+{
+    report_t report = {};
+    build_table();
+    report.frames_sent = script_frames();
+
+    allocations = 0;
+    allocated_bytes = 0;
+    counting = true;
+    run_taps(report);
+    run_frames(report);
+    counting = false;
+    report.allocations = allocations;
+    report.allocated_bytes = allocated_bytes;
+
+    const char *path = getenv("STREAMDECO_SIM_REPORT");
+    FILE *file = fopen(path ? path : "sim_report.json", "w");
+    if (file != nullptr)
+    {
+        print_report(file, report);
+        fclose(file);
+    }
+    print_report(stdout, report);
+
+    TEST_ASSERT_EQUAL(tap_count, report.handler_ns.count);
+    TEST_ASSERT_TRUE(report.hid_reports > 0);
+    TEST_ASSERT_EQUAL(report.frames_sent, report.frames);
+    TEST_ASSERT_EQUAL(0, report.parser_errors);
+    TEST_ASSERT_EQUAL(0, report.allocations);
+}
+
+/* Stage times of the tracer are taken from the previous stage of the same tap */
+void test_trace_summary(void)
+{
+    trace::Tracer tracer;
+    for (uint32_t tap = 0; tap < 3; tap++)
+    {
+        const uint32_t id = tracer.begin();
+        int64_t us = tap * 100000;
+        for (uint8_t stage = trace::touch_stage; stage < trace::stage_count; stage++)
+        {
+            us += stage * 100 + tap; /* 100 us more each stage, a little slower each tap */
+            tracer.record(id, static_cast<trace::stage_e>(stage), us);
+        }
+    }
+
+    trace::stats_t stages[trace::stage_count];
+    trace::stats_t total;
+    tracer.summary(stages, total);
+    TEST_ASSERT_EQUAL(3, stages[trace::touch_stage].count);
+    for (uint8_t stage = trace::input_stage; stage < trace::stage_count; stage++)
+    {
+        TEST_ASSERT_EQUAL(3, stages[stage].count);
+        TEST_ASSERT_EQUAL(stage * 100 + 1, stages[stage].p50);
+        TEST_ASSERT_EQUAL(stage * 100 + 2, stages[stage].max);
+    }
+    TEST_ASSERT_EQUAL(3, total.count);
+    TEST_ASSERT_EQUAL(1500 + 5 * 2, total.max);
+}
+
+/* Frames written back to back fill the UART FIFO before the RX timeout */
+void test_serial_burst(void)
+{
+    sim::ScriptedSerial burst;
+    frame::Assembler burst_assembler;
+    frame::metrics_t metrics = {};
+    uint8_t buffer[frame::max_binary_size];
+    size_t size = frame::encode(metrics, buffer, sizeof(buffer));
+
+    for (int i = 0; i < 4; i++)
+        TEST_ASSERT_TRUE(burst.send(i * static_cast<int64_t>(size) * sim::uart_byte_us, buffer, size));
+
+    const int64_t callback_us = burst.next_callback(0);
+    TEST_ASSERT_EQUAL(static_cast<int64_t>(sim::uart_fifo_full) * sim::uart_byte_us, callback_us);
+
+    frame::slot_t slot;
+    size_t frames = 0;
+    burst.set_time(callback_us);
+    burst_assembler.fill(burst, callback_us);
+    while (burst_assembler.next(slot))
+        frames++;
+    TEST_ASSERT_EQUAL(sim::uart_fifo_full / size, frames);
+}
+
+namespace
+{
+    constexpr size_t decode_iterations = 20000;
+
+    frame::metrics_t sample_metrics()
+    {
+        frame::metrics_t metrics = {};
+        metrics.cpu_load = 37;
+        metrics.cpu_temp = -4;
+        metrics.cpu_freq = 3600;
+        metrics.gpu_load = 12;
+        metrics.gpu_temp = 48;
+        metrics.gpu_freq = 1750;
+        metrics.mem_used = 9120;
+        metrics.mem_max = 32680;
+        metrics.disk_used = 412;
+        metrics.disk_max = 931;
+        metrics.sec = 15;
+        metrics.min = 42;
+        metrics.hour = 21;
+        metrics.wday = 3;
+        metrics.mday = 16;
+        metrics.month = 10;
+        metrics.year = 2026;
+        metrics.clock_valid = true;
+        return metrics;
+    }
+
+    frame::Parser::result_e push_text(frame::Parser &parser, const char *text)
+    {
+        frame::Parser::result_e result = frame::Parser::pending;
+        for (const char *byte = text; *byte; byte++)
+            result = parser.push(static_cast<uint8_t>(*byte));
+        return result;
+    }
+}
+
+/* Binary and text frames decode to the metrics they were made of */
+void test_frame_round_trip(void)
+{
+    const frame::metrics_t sent = sample_metrics();
+    uint8_t buffer[frame::max_binary_size];
+    const size_t size = frame::encode(sent, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(frame::header_size + frame::metrics_payload_size + frame::crc_size, size);
+
+    frame::metrics_t received = {};
+    TEST_ASSERT_TRUE(frame::decode(buffer, size, received));
+    TEST_ASSERT_EQUAL(0, memcmp(&sent, &received, offsetof(frame::metrics_t, clock_valid)));
+    TEST_ASSERT_TRUE(received.clock_valid);
+
+    buffer[frame::header_size] ^= 1;
+    TEST_ASSERT_FALSE(frame::decode(buffer, size, received));
+    TEST_ASSERT_EQUAL(0, frame::encode(sent, buffer, size - 1));
+
+    const char text[] = "37, -4, 3600, 12, 48, 1750, 9120, 32680, 412, 931, 15, 42, 21, 3, 16, 10, 2026";
+    received = {};
+    TEST_ASSERT_TRUE(frame::decode_text(text, strlen(text), received));
+    TEST_ASSERT_EQUAL(0, memcmp(&sent, &received, offsetof(frame::metrics_t, clock_valid)));
+    TEST_ASSERT_TRUE(received.clock_valid);
+    TEST_ASSERT_FALSE(frame::decode_text("37, 54/", 7, received));
+}
+
+/* The parser buffer is not cleared between frames, a shorter last field must not read the old digits */
+void test_frame_text_shorter_field(void)
+{
+    frame::Parser parser;
+    TEST_ASSERT_EQUAL(frame::Parser::complete, push_text(parser, "1, 2, 3, 4, 5, 6, 7, 8, 9, 1600/"));
+    TEST_ASSERT_EQUAL(1600, parser.metrics().disk_max);
+    TEST_ASSERT_EQUAL(frame::Parser::complete, push_text(parser, "1, 2, 3, 4, 5, 6, 7, 8, 9, 1/"));
+    TEST_ASSERT_EQUAL(1, parser.metrics().disk_max);
+
+    /* a field filling the whole buffer is read up to the buffer end, too long for a value */
+    char longest[frame::max_text_size + 2];
+    memset(longest, '9', frame::max_text_size);
+    longest[frame::max_text_size] = '/';
+    longest[frame::max_text_size + 1] = 0;
+    TEST_ASSERT_EQUAL(frame::Parser::error, push_text(parser, longest));
+    frame::metrics_t metrics = {};
+    TEST_ASSERT_FALSE(frame::decode_text(longest, frame::max_text_size, metrics));
+    TEST_ASSERT_EQUAL(frame::Parser::complete, push_text(parser, "1, 2, 3, 4, 5, 6, 7, 8, 9, 10/"));
+}
+
+/* BLE writes reach the assembler through the channel, a frame may span
+ * several writes, a write may carry several frames and a full ring drops */
+void test_ble_channel(void)
+{
+    constexpr size_t write_size = 20; /* default ATT MTU less the 3 byte header */
+    const frame::metrics_t sent = sample_metrics();
+    uint8_t buffer[frame::max_binary_size];
+    const size_t size = frame::encode(sent, buffer, sizeof(buffer));
+    TEST_ASSERT_GREATER_THAN(write_size, size);
+
+    frame::Channel channel;
+    frame::Assembler assembler(frame::transport_ble);
+    frame::slot_t slot;
+
+    /* split, the slot is stamped with the arrival of the first write */
+    int64_t now_us = 1000;
+    for (size_t offset = 0; offset < size; offset += write_size, now_us += 7500)
+    {
+        TEST_ASSERT_FALSE(assembler.next(slot));
+        const size_t chunk = std::min(write_size, size - offset);
+        TEST_ASSERT_EQUAL(chunk, channel.write(buffer + offset, chunk));
+        TEST_ASSERT_EQUAL(chunk, assembler.fill(channel, now_us));
+    }
+    TEST_ASSERT_TRUE(assembler.next(slot));
+    TEST_ASSERT_EQUAL(frame::metrics_type, slot.type);
+    TEST_ASSERT_EQUAL(frame::transport_ble, slot.transport);
+    TEST_ASSERT_EQUAL(1000, slot.arrival_us);
+    TEST_ASSERT_EQUAL(0, memcmp(&sent, &slot.metrics, offsetof(frame::metrics_t, clock_valid)));
+    TEST_ASSERT_FALSE(assembler.next(slot));
+
+    /* coalesced */
+    constexpr size_t coalesced = 3;
+    uint8_t burst[coalesced * frame::max_binary_size];
+    for (size_t i = 0; i < coalesced; i++)
+        memcpy(burst + i * size, buffer, size);
+    TEST_ASSERT_EQUAL(coalesced * size, channel.write(burst, coalesced * size));
+    assembler.fill(channel, now_us);
+    size_t frames = 0;
+    while (assembler.next(slot))
+        frames++;
+    TEST_ASSERT_EQUAL(coalesced, frames);
+    TEST_ASSERT_EQUAL(0, channel.dropped());
+
+    /* overflow, ingest is behind and the ring keeps the oldest bytes */
+    size_t accepted = 0;
+    size_t written = 0;
+    while (written < 2 * frame::ring_size)
+    {
+        accepted += channel.write(buffer, size);
+        written += size;
+    }
+    TEST_ASSERT_EQUAL(frame::ring_size - 1, accepted);
+    TEST_ASSERT_EQUAL(written - accepted, channel.dropped());
+
+    TEST_ASSERT_EQUAL(accepted, assembler.fill(channel, now_us));
+    frames = 0;
+    while (assembler.next(slot))
+        frames++;
+    TEST_ASSERT_EQUAL(accepted / size, frames);
+
+    /* the cut frame is lost, the parser resyncs on the frames after it */
+    for (size_t i = 0; i < coalesced; i++)
+        TEST_ASSERT_EQUAL(size, channel.write(buffer, size));
+    assembler.fill(channel, now_us);
+    frames = 0;
+    while (assembler.next(slot))
+        frames++;
+    TEST_ASSERT_GREATER_OR_EQUAL(coalesced - 1, frames);
+    TEST_ASSERT_EQUAL(0, memcmp(&sent, &slot.metrics, offsetof(frame::metrics_t, clock_valid)));
+}
+
+/* Decode cost of each format, printed per frame, the parser is fed byte by byte like the firmware */
+void test_frame_decode_cost(void)
+{
+    const frame::metrics_t sent = sample_metrics();
+    uint8_t binary[frame::max_binary_size];
+    const size_t binary_size = frame::encode(sent, binary, sizeof(binary));
+    const char text[] = "37, -4, 3600, 12, 48, 1750, 9120, 32680, 412, 931, 15, 42, 21, 3, 16, 10, 2026/";
+
+    frame::Parser parser;
+    size_t frames = 0;
+    uint64_t start_ns = now_ns();
+    for (size_t i = 0; i < decode_iterations; i++)
+        for (size_t byte = 0; byte < binary_size; byte++)
+            frames += parser.push(binary[byte]) == frame::Parser::complete;
+    const uint64_t binary_ns = (now_ns() - start_ns) / decode_iterations;
+    TEST_ASSERT_EQUAL(decode_iterations, frames);
+
+    frames = 0;
+    start_ns = now_ns();
+    for (size_t i = 0; i < decode_iterations; i++)
+        frames += push_text(parser, text) == frame::Parser::complete;
+    const uint64_t text_ns = (now_ns() - start_ns) / decode_iterations;
+    TEST_ASSERT_EQUAL(decode_iterations, frames);
+    TEST_ASSERT_EQUAL(0, parser.errors());
+
+    printf("Frame decode binary %u bytes %llu ns/frame, text %u bytes %llu ns/frame\n",
+           static_cast<unsigned>(binary_size), static_cast<unsigned long long>(binary_ns),
+           static_cast<unsigned>(sizeof(text) - 1), static_cast<unsigned long long>(text_ns));
+
+    /* binary replaced text to save decode time, the crc must not give it back */
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL(0x29B1, frame::crc16(check, sizeof(check) - 1));
+    TEST_ASSERT_LESS_THAN(text_ns, binary_ns);
+}
+
+namespace
+{
+    constexpr size_t upload_chunk = 16;
+
+    /* Table of one chord per event, key tells the images apart */
+    size_t build_keys(uint8_t *image, uint8_t events, uint8_t key)
+    {
+        keymap::Builder builder(image, keymap::max_image_size, events);
+        for (uint8_t event = 0; event < events; event++)
+        {
+            builder.event(event);
+            builder.chord(chord::keys(0x80, key + event).report);
+        }
+        return builder.finish();
+    }
+
+    /* Upload an image in chunks like shortcuts::receive, skip drops one chunk */
+    bool upload(keymap::Table &uploaded, const uint8_t *image, size_t size, size_t skip = SIZE_MAX)
+    {
+        bool written = uploaded.begin(size);
+        for (size_t offset = 0, chunk = 0; offset < size; offset += upload_chunk, chunk++)
+            if (chunk != skip)
+                written &= uploaded.write(offset, &image[offset], std::min(upload_chunk, size - offset));
+        return uploaded.commit() && written;
+    }
+}
+
+/* A failed upload keeps the previous table active. Failed uploads resend the image left on the
+ * inactive buffer by the first upload, so only the transfer checks can refuse them */
+void test_keymap_upload(void)
+{
+    static keymap::Table uploaded(event_count);
+    static uint8_t first[keymap::max_image_size];
+    static uint8_t active[keymap::max_image_size];
+    const size_t first_size = build_keys(first, event_count, 'a');
+    const size_t active_size = build_keys(active, event_count, 'k');
+    TEST_ASSERT_TRUE(uploaded.load(first, first_size));
+    TEST_ASSERT_TRUE(upload(uploaded, active, active_size));
+
+    auto kept = [&]() {
+        TEST_ASSERT_EQUAL(active_size, uploaded.size());
+        TEST_ASSERT_EQUAL(0, memcmp(uploaded.image(), active, active_size));
+    };
+    kept();
+
+    /* out of order chunks */
+    TEST_ASSERT_TRUE(uploaded.begin(first_size));
+    TEST_ASSERT_FALSE(uploaded.write(upload_chunk, &first[upload_chunk], upload_chunk));
+    TEST_ASSERT_FALSE(uploaded.write(0, first, upload_chunk));
+    TEST_ASSERT_FALSE(uploaded.commit());
+    kept();
+
+    /* missing chunk before commit, in the middle and at the end */
+    TEST_ASSERT_FALSE(upload(uploaded, first, first_size, 1));
+    kept();
+    TEST_ASSERT_FALSE(upload(uploaded, first, first_size, (first_size - 1) / upload_chunk));
+    kept();
+
+    /* bad crc */
+    static uint8_t corrupted[keymap::max_image_size];
+    memcpy(corrupted, first, first_size);
+    corrupted[first_size - 1] ^= 0x01;
+    TEST_ASSERT_FALSE(upload(uploaded, corrupted, first_size));
+    kept();
+
+    /* image made for another event count */
+    static uint8_t other[keymap::max_image_size];
+    const size_t other_size = build_keys(other, event_count + 1, 'a');
+    TEST_ASSERT_FALSE(upload(uploaded, other, other_size));
+    kept();
+
+    /* commit without a transfer */
+    TEST_ASSERT_FALSE(uploaded.commit());
+    kept();
+
+    TEST_ASSERT_TRUE(upload(uploaded, first, first_size));
+    TEST_ASSERT_EQUAL(first_size, uploaded.size());
+    TEST_ASSERT_EQUAL(0, memcmp(uploaded.image(), first, first_size));
+}
+
+/* Connection requests of BleConnectionPolicy: active on connect, retried while the host
+ * keeps other values, given up after CONN_MAX_ATTEMPTS, a new target starts again */
+void test_connection_policy(void)
+{
+    const BleConnParams active = {6, 12, 0, 400};
+    const BleConnParams idle = {48, 80, 4, 400};
+    constexpr uint32_t retry_ms = 2000;
+    BleConnectionPolicy policy;
+    policy.setActiveParams(active);
+    policy.setIdleParams(idle);
+    policy.setRetryTime(retry_ms);
+    BleConnParams request = {};
+
+    TEST_ASSERT_FALSE(policy.poll(0, request));
+    policy.onConnect(24, 0);
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::ACTIVE, policy.getTarget());
+    TEST_ASSERT_TRUE(policy.poll(0, request));
+    TEST_ASSERT_EQUAL(active.minInterval, request.minInterval);
+    TEST_ASSERT_EQUAL(active.maxInterval, request.maxInterval);
+    TEST_ASSERT_FALSE(policy.poll(retry_ms - 1, request));
+
+    /* the host keeps 30 ms, each retry counts one rejection */
+    for (uint8_t attempt = 1; attempt < BleConnectionPolicy::CONN_MAX_ATTEMPTS; attempt++)
+    {
+        TEST_ASSERT_TRUE(policy.poll(attempt * retry_ms, request));
+        TEST_ASSERT_EQUAL(attempt, policy.getRejected());
+    }
+    TEST_ASSERT_FALSE(policy.poll(BleConnectionPolicy::CONN_MAX_ATTEMPTS * retry_ms, request));
+    TEST_ASSERT_FALSE(policy.poll(10 * retry_ms, request));
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::CONN_MAX_ATTEMPTS, policy.getRequests());
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::CONN_MAX_ATTEMPTS, policy.getRejected());
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::IDLE, policy.getMode());
+
+    /* idle is a new target, attempts start again and the host applies it */
+    uint32_t now_ms = 20 * retry_ms;
+    policy.idle();
+    TEST_ASSERT_TRUE(policy.poll(now_ms, request));
+    TEST_ASSERT_EQUAL(idle.minInterval, request.minInterval);
+    TEST_ASSERT_EQUAL(idle.latency, request.latency);
+    policy.onParams(request.minInterval, request.latency);
+    TEST_ASSERT_FALSE(policy.poll(now_ms += retry_ms, request));
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::IDLE, policy.getMode());
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::CONN_MAX_ATTEMPTS, policy.getRejected());
+
+    /* keys switch back to active, idle again after */
+    policy.activity();
+    TEST_ASSERT_TRUE(policy.poll(now_ms, request));
+    TEST_ASSERT_EQUAL(active.minInterval, request.minInterval);
+    policy.onParams(request.minInterval, request.latency);
+    TEST_ASSERT_FALSE(policy.poll(now_ms += retry_ms, request));
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::ACTIVE, policy.getMode());
+    policy.activity();
+    TEST_ASSERT_FALSE(policy.poll(now_ms, request));
+    policy.idle();
+    TEST_ASSERT_TRUE(policy.poll(now_ms, request));
+    TEST_ASSERT_EQUAL(idle.minInterval, request.minInterval);
+
+    policy.onDisconnect();
+    TEST_ASSERT_FALSE(policy.poll(now_ms += retry_ms, request));
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::DISCONNECTED, policy.getMode());
+    policy.activity();
+    TEST_ASSERT_EQUAL(BleConnectionPolicy::DISCONNECTED, policy.getTarget());
+}
+
+/* Monitor churn must not leak nor fragment the pools, a leak must be seen,
+ * STREAMDECO_SOAK_S runs a longer soak without leak */
+void test_memory_soak(void)
+{
+    const char *seconds = getenv("STREAMDECO_SOAK_S");
+    const int64_t soak_s = seconds ? atoll(seconds) : soak_default_s;
+
+    const soak_t clean = run_soak(soak_s, false);
+    print_soak("clean", clean);
+    TEST_ASSERT_EQUAL(0, clean.events);
+    TEST_ASSERT_LESS_THAN(leak_budget, clean.lvgl_growth);
+    TEST_ASSERT_EQUAL(0, clean.internal_growth);
+    TEST_ASSERT_LESS_THAN(memory::default_threshold, memory::fragmentation(clean.lvgl));
+
+    const soak_t leaky = run_soak(soak_default_s, true);
+    print_soak("leak", leaky);
+    TEST_ASSERT_GREATER_THAN(leak_budget, leaky.lvgl_growth);
+    TEST_ASSERT_EQUAL(0, leaky.internal_growth);
+}
+
+/* Events are raised once per crossing, armed again below the hysteresis */
+void test_memory_threshold(void)
+{
+    sim::ModeledHeap heap(4096);
+    sim::HeapProbe probe;
+    probe.attach(memory::internal_pool, &heap);
+    memory::Telemetry telemetry(50);
+
+    int32_t blocks[32];
+    for (int32_t &block : blocks)
+        block = heap.alloc(120);
+    TEST_ASSERT_EQUAL(0, telemetry.sample(probe, 0));
+
+    /* every other block released, free space is scattered */
+    for (size_t i = 0; i < 32; i += 2)
+        heap.free(blocks[i]);
+    TEST_ASSERT_EQUAL(1, telemetry.sample(probe, 1));
+    TEST_ASSERT_EQUAL(0, telemetry.sample(probe, 2));
+    TEST_ASSERT_EQUAL(1UL << memory::internal_pool, telemetry.fragmented());
+
+    for (size_t i = 1; i < 32; i += 2)
+        heap.free(blocks[i]);
+    telemetry.sample(probe, 3);
+    TEST_ASSERT_EQUAL(0, telemetry.fragmented());
+    TEST_ASSERT_EQUAL(1, telemetry.events());
+    TEST_ASSERT_EQUAL(4, telemetry.count());
+
+    memory::sample_t samples[memory::history_size];
+    TEST_ASSERT_EQUAL(4, telemetry.history(samples, memory::history_size));
+    TEST_ASSERT_EQUAL(0, samples[0].us);
+    TEST_ASSERT_EQUAL(0, samples[0].pools[memory::psram_pool].total);
+    TEST_ASSERT_EQUAL(4096, samples[3].pools[memory::internal_pool].free);
+}
+
+namespace
+{
+    /* Executor clock, stepped by the tests */
+    int64_t executor_us = 0;
+    int64_t executor_now() { return executor_us; }
+
+    /* Dispatched messages in order, the handler takes 100 us */
+    executor::message_t dispatched[32];
+    size_t dispatched_count = 0;
+
+    void record(const executor::message_t &message)
+    {
+        if (dispatched_count < 32)
+            dispatched[dispatched_count++] = message;
+        executor_us += 100;
+    }
+
+    void drain(executor::Executor &loop)
+    {
+        executor::message_t message;
+        while (loop.next(message))
+            loop.dispatch(message);
+    }
+}
+
+/* Messages are dispatched by priority then in post order, duplicates are coalesced */
+void test_executor_order(void)
+{
+    executor_us = 0;
+    dispatched_count = 0;
+    executor::Executor loop(executor_now);
+    loop.on(executor::button_message, record, executor::high_priority);
+    loop.on(executor::frame_message, record, executor::normal_priority, true);
+    loop.on(executor::save_message, record, executor::low_priority);
+
+    TEST_ASSERT_TRUE(loop.post(executor::save_message, 1));
+    TEST_ASSERT_TRUE(loop.post(executor::frame_message));
+    TEST_ASSERT_TRUE(loop.post(executor::frame_message));
+    TEST_ASSERT_TRUE(loop.post(executor::button_message, 7, 41));
+    TEST_ASSERT_TRUE(loop.post(executor::button_message, 3, 42));
+    TEST_ASSERT_EQUAL(4, loop.depth());
+    TEST_ASSERT_EQUAL(0, loop.wait_us());
+
+    drain(loop);
+    TEST_ASSERT_EQUAL(4, dispatched_count);
+    TEST_ASSERT_EQUAL(executor::button_message, dispatched[0].type);
+    TEST_ASSERT_EQUAL(7, dispatched[0].value);
+    TEST_ASSERT_EQUAL(41, dispatched[0].tap); /* not the newest tap */
+    TEST_ASSERT_EQUAL(3, dispatched[1].value);
+    TEST_ASSERT_EQUAL(42, dispatched[1].tap);
+    TEST_ASSERT_EQUAL(0, dispatched[3].tap);
+    TEST_ASSERT_EQUAL(executor::frame_message, dispatched[2].type);
+    TEST_ASSERT_EQUAL(executor::save_message, dispatched[3].type);
+
+    const executor::queue_stats_t &queue = loop.queue_stats();
+    TEST_ASSERT_EQUAL(4, queue.posted);
+    TEST_ASSERT_EQUAL(1, queue.coalesced);
+    TEST_ASSERT_EQUAL(4, queue.max_depth);
+    TEST_ASSERT_EQUAL(0, queue.depth);
+    TEST_ASSERT_EQUAL(2, loop.stats(executor::button_message).count);
+    TEST_ASSERT_EQUAL(100, loop.stats(executor::button_message).max_us);
+    TEST_ASSERT_EQUAL(300, loop.stats(executor::save_message).wait_max_us);
+    TEST_ASSERT_EQUAL(-1, loop.wait_us());
+
+    for (size_t i = 0; i < executor::queue_size; i++)
+        loop.post(executor::button_message, i);
+    TEST_ASSERT_FALSE(loop.post(executor::button_message, 99));
+    TEST_ASSERT_EQUAL(1, loop.queue_stats().dropped);
+    TEST_ASSERT_TRUE(loop.post(executor::save_message));
+}
+
+/* Timers post their message when due, in due order, periodic timers skip missed periods */
+void test_executor_timers(void)
+{
+    executor_us = 0;
+    dispatched_count = 0;
+    executor::Executor loop(executor_now);
+    loop.on(executor::tick_message, record, executor::normal_priority, true);
+    loop.on(executor::idle_message, record, executor::normal_priority);
+    loop.on(executor::memory_message, record, executor::low_priority);
+
+    const executor::timer_id_t tick = loop.schedule(executor::tick_message, 0, 500, 500);
+    const executor::timer_id_t canvas = loop.schedule(executor::idle_message, 1, 10000, 10000);
+    const executor::timer_id_t backlight = loop.schedule(executor::idle_message, 2, 3000);
+    loop.schedule(executor::memory_message, 0, 5000, 5000);
+    TEST_ASSERT_NOT_EQUAL(executor::no_timer, backlight);
+    TEST_ASSERT_EQUAL(500, loop.wait_us());
+
+    /* a tap at 2 ms delays the idle timers */
+    executor_us = 2000;
+    loop.restart(canvas);
+    loop.restart(backlight);
+    drain(loop);
+    TEST_ASSERT_EQUAL(1, dispatched_count);
+    TEST_ASSERT_EQUAL(executor::tick_message, dispatched[0].type);
+    TEST_ASSERT_EQUAL(500, dispatched[0].posted_us);
+
+    executor_us = 5000;
+    dispatched_count = 0;
+    drain(loop);
+    TEST_ASSERT_EQUAL(3, dispatched_count);
+    TEST_ASSERT_EQUAL(executor::tick_message, dispatched[0].type);
+    TEST_ASSERT_EQUAL(executor::idle_message, dispatched[1].type);
+    TEST_ASSERT_EQUAL(2, dispatched[1].value);
+    TEST_ASSERT_EQUAL(executor::memory_message, dispatched[2].type);
+
+    /* one shot timer is stopped, tick period changed */
+    executor_us = 20000;
+    dispatched_count = 0;
+    loop.period(tick, 0);
+    drain(loop);
+    TEST_ASSERT_EQUAL(2, dispatched_count);
+    TEST_ASSERT_EQUAL(1, dispatched[0].value);
+    TEST_ASSERT_EQUAL(executor::memory_message, dispatched[1].type);
+    TEST_ASSERT_EQUAL(22000 - executor_us, loop.wait_us());
+
+    loop.stop(canvas);
+    loop.period(tick, 1000);
+    TEST_ASSERT_EQUAL(1000, loop.wait_us());
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_session_report);
+    RUN_TEST(test_trace_summary);
+    RUN_TEST(test_serial_burst);
+    RUN_TEST(test_frame_round_trip);
+    RUN_TEST(test_frame_text_shorter_field);
+    RUN_TEST(test_ble_channel);
+    RUN_TEST(test_frame_decode_cost);
+    RUN_TEST(test_keymap_upload);
+    RUN_TEST(test_connection_policy);
+    RUN_TEST(test_memory_soak);
+    RUN_TEST(test_memory_threshold);
+    RUN_TEST(test_executor_order);
+    RUN_TEST(test_executor_timers);
+    return UNITY_END();
+}